@@ -0,0 +1,170 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless benchmark of the banded video conversion (MEDIA_VIDEO_CONVERT_BANDS): average conversion time per
+// frame of each bundled clip, converted by swscale in a single band and in parallel bands.
+// Usage: bench_convert [frames per clip]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <libavutil/cpu.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+#define BAND_COUNTS_COUNT (int)(sizeof(BAND_COUNTS) / sizeof(BAND_COUNTS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+// 0: one band per core
+const int BAND_COUNTS[] = { 1, 2, 4, 0 };
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays up to frameCount frames of a clip converted in bandCount bands, frame by frame on the calling thread.
+// Returns the average conversion time per frame (ms), or a negative value on failure.
+double MeasureConvertTime(const char* fileName, int bandCount, int frameCount, int* width, int* height);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const int frameCount = argc > 1 ? atoi(argv[1]) : 120;
+
+	SetTraceLogLevel(LOG_WARNING);
+
+	// The built-in kernels don't go through swscale, whose single-threaded cost the bands split
+	SetMediaFlag(MEDIA_VIDEO_FAST_CONVERT, 0);
+
+	printf("swscale conversion time per frame (ms), %d frames per clip, %d cores\n\n", frameCount, av_cpu_count());
+	printf("%-24s %-10s", "clip", "size");
+
+	for (int b = 0; b < BAND_COUNTS_COUNT; ++b)
+	{
+		if (BAND_COUNTS[b] == 0)
+		{
+			printf("%10s", "per core");
+		}
+		else
+		{
+			printf("%4d bands", BAND_COUNTS[b]);
+		}
+	}
+
+	printf("%10s\n", "speedup");
+
+	double totals[BAND_COUNTS_COUNT] = { 0 };
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		double times[BAND_COUNTS_COUNT];
+		int width = 0;
+		int height = 0;
+
+		for (int b = 0; b < BAND_COUNTS_COUNT; ++b)
+		{
+			times[b] = MeasureConvertTime(VIDEO_CLIPS[c], BAND_COUNTS[b], frameCount, &width, &height);
+
+			if (times[b] < 0.0)
+			{
+				printf("Failed to play %s (run from the build directory).\n", VIDEO_CLIPS[c]);
+				return EXIT_FAILURE;
+			}
+
+			totals[b] += times[b];
+		}
+
+		printf("%-24s %4dx%-5d", VIDEO_CLIPS[c], width, height);
+
+		for (int b = 0; b < BAND_COUNTS_COUNT; ++b)
+		{
+			printf("%10.3f", times[b]);
+		}
+
+		printf("%9.2fx\n", times[0] / times[BAND_COUNTS_COUNT - 1]);
+	}
+
+	printf("%-35s", "average");
+
+	for (int b = 0; b < BAND_COUNTS_COUNT; ++b)
+	{
+		printf("%10.3f", totals[b] / VIDEO_CLIPS_COUNT);
+	}
+
+	printf("%9.2fx\n", totals[0] / totals[BAND_COUNTS_COUNT - 1]);
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+double MeasureConvertTime(const char* fileName, int bandCount, int frameCount, int* width, int* height)
+{
+	SetMediaFlag(MEDIA_VIDEO_CONVERT_BANDS, bandCount);
+
+	MediaStream media = LoadMediaEx(fileName, MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO);
+
+	if (!IsMediaValid(media))
+	{
+		return -1.0;
+	}
+
+	const Image image = GetMediaImage(media);
+	const double frameTime = 1.0 / GetMediaProperties(media).avgFPS;
+
+	*width = image.width;
+	*height = image.height;
+
+	// One frame per update: every decoded frame is converted
+	for (int i = 0; i < frameCount && GetMediaState(media) == MEDIA_STATE_PLAYING; ++i)
+	{
+		UpdateMediaEx(&media, frameTime);
+	}
+
+	const MediaStats stats = GetMediaStats(media);
+
+	UnloadMedia(&media);
+
+	return stats.presentedVideoFrames > 0 ? stats.videoConvertTime * 1000.0 / stats.presentedVideoFrames : -1.0;
+}
@@ -0,0 +1,300 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless benchmark of SetMediaPosition() latency per GOP length. The bundled clips share a few GOP lengths, so
+// the program encodes its own clips (MPEG-4 Part 2, CLIP_WIDTH x CLIP_HEIGHT, CLIP_SECONDS long) with a fixed GOP
+// each, then seeks them to the same pseudo-random positions, landing on the keyframe and on the exact frame
+// (MEDIA_FLAG_ACCURATE_SEEK). The clips are written to the working directory and removed at the end.
+// Usage: bench_seek [seeks per clip]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define GOP_LENGTHS_COUNT (int)(sizeof(GOP_LENGTHS) / sizeof(GOP_LENGTHS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+// Frames per GOP, 1: intra only
+const int GOP_LENGTHS[] = { 1, 12, 25, 50, 125, 250 };
+
+const int CLIP_WIDTH = 1280;
+const int CLIP_HEIGHT = 720;
+const int CLIP_FPS = 25;
+const int CLIP_SECONDS = 20;
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct SeekResult
+{
+	double seekTime;        // Average seek time (ms)
+	double decodedFrames;   // Average frames decoded from the keyframe to the target (accurate seeks only)
+} SeekResult;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Encode a clip with a keyframe every gopLength frames. Returns false on failure.
+bool EncodeClip(const char* fileName, int gopLength);
+
+// Encode a frame (NULL: flush the encoder) and write the packets to the output. Returns false on failure.
+bool WriteFrame(AVFormatContext* output, AVCodecContext* encoder, AVStream* stream, AVFrame* frame, AVPacket* packet);
+
+// Seek a clip seekCount times, landing on the keyframe or on the exact frame. Returns false on failure.
+bool MeasureSeeks(const char* fileName, bool accurate, int seekCount, SeekResult* result);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const int seekCount = argc > 1 ? atoi(argv[1]) : 50;
+
+	SetTraceLogLevel(LOG_WARNING);
+
+	printf("SetMediaPosition() latency per GOP length, %dx%d at %d FPS, %d seeks per clip\n\n",
+		   CLIP_WIDTH, CLIP_HEIGHT, CLIP_FPS, seekCount);
+	printf("%-8s %14s %14s %16s\n", "GOP", "keyframe ms", "accurate ms", "decoded frames");
+
+	for (int g = 0; g < GOP_LENGTHS_COUNT; ++g)
+	{
+		char fileName[64];
+		snprintf(fileName, sizeof(fileName), "bench_seek_gop%d.mkv", GOP_LENGTHS[g]);
+
+		if (!EncodeClip(fileName, GOP_LENGTHS[g]))
+		{
+			printf("Failed to encode %s (MPEG-4 encoder and Matroska muxer required).\n", fileName);
+			remove(fileName);
+			return EXIT_FAILURE;
+		}
+
+		SeekResult keyframe = { 0 };
+		SeekResult accurate = { 0 };
+
+		const bool measured = MeasureSeeks(fileName, false, seekCount, &keyframe) &&
+							  MeasureSeeks(fileName, true, seekCount, &accurate);
+
+		remove(fileName);
+
+		if (!measured)
+		{
+			printf("Failed to play %s.\n", fileName);
+			return EXIT_FAILURE;
+		}
+
+		printf("%-8d %14.3f %14.3f %16.1f\n", GOP_LENGTHS[g], keyframe.seekTime, accurate.seekTime, accurate.decodedFrames);
+		fflush(stdout);
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool EncodeClip(const char* fileName, int gopLength)
+{
+	const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+	AVFormatContext* output = NULL;
+
+	if (!codec || avformat_alloc_output_context2(&output, NULL, NULL, fileName) < 0)
+	{
+		return false;
+	}
+
+	AVCodecContext* encoder = avcodec_alloc_context3(codec);
+	AVStream* stream = avformat_new_stream(output, NULL);
+	AVFrame* frame = av_frame_alloc();
+	AVPacket* packet = av_packet_alloc();
+
+	bool success = (encoder && stream && frame && packet);
+
+	if (success)
+	{
+		// No B-frames: the GOP length alone sets the distance from a frame to its keyframe
+		encoder->width = CLIP_WIDTH;
+		encoder->height = CLIP_HEIGHT;
+		encoder->pix_fmt = AV_PIX_FMT_YUV420P;
+		encoder->time_base = (AVRational){ 1, CLIP_FPS };
+		encoder->framerate = (AVRational){ CLIP_FPS, 1 };
+		encoder->gop_size = gopLength;
+		encoder->max_b_frames = 0;
+		encoder->bit_rate = 4000000;
+
+		if (output->oformat->flags & AVFMT_GLOBALHEADER)
+		{
+			encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+		}
+
+		frame->format = encoder->pix_fmt;
+		frame->width = encoder->width;
+		frame->height = encoder->height;
+
+		success = avcodec_open2(encoder, codec, NULL) >= 0 &&
+				  avcodec_parameters_from_context(stream->codecpar, encoder) >= 0 &&
+				  av_frame_get_buffer(frame, 0) >= 0 &&
+				  avio_open(&output->pb, fileName, AVIO_FLAG_WRITE) >= 0;
+	}
+
+	if (success)
+	{
+		stream->time_base = encoder->time_base;
+		success = avformat_write_header(output, NULL) >= 0;
+	}
+
+	// Moving gradients with a per-frame pattern: every frame differs, as in real footage
+	for (int i = 0; success && i < CLIP_FPS * CLIP_SECONDS; ++i)
+	{
+		success = av_frame_make_writable(frame) >= 0;
+
+		for (int y = 0; success && y < CLIP_HEIGHT; ++y)
+		{
+			uint8_t* row = frame->data[0] + y * frame->linesize[0];
+
+			for (int x = 0; x < CLIP_WIDTH; ++x)
+			{
+				row[x] = (uint8_t)(x + y + i * 3 + (((x * y + i * 7) >> 5) & 31));
+			}
+		}
+
+		for (int y = 0; success && y < CLIP_HEIGHT / 2; ++y)
+		{
+			uint8_t* rowU = frame->data[1] + y * frame->linesize[1];
+			uint8_t* rowV = frame->data[2] + y * frame->linesize[2];
+
+			for (int x = 0; x < CLIP_WIDTH / 2; ++x)
+			{
+				rowU[x] = (uint8_t)(128 + y + i * 2);
+				rowV[x] = (uint8_t)(64 + x + i * 5);
+			}
+		}
+
+		frame->pts = i;
+		success = success && WriteFrame(output, encoder, stream, frame, packet);
+	}
+
+	if (success)
+	{
+		success = WriteFrame(output, encoder, stream, NULL, packet) && av_write_trailer(output) >= 0;
+	}
+
+	if (output->pb)
+	{
+		avio_closep(&output->pb);
+	}
+
+	av_packet_free(&packet);
+	av_frame_free(&frame);
+	avcodec_free_context(&encoder);
+	avformat_free_context(output);
+
+	return success;
+}
+
+bool WriteFrame(AVFormatContext* output, AVCodecContext* encoder, AVStream* stream, AVFrame* frame, AVPacket* packet)
+{
+	if (avcodec_send_frame(encoder, frame) < 0)
+	{
+		return false;
+	}
+
+	int ret = 0;
+
+	while ((ret = avcodec_receive_packet(encoder, packet)) >= 0)
+	{
+		av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+		packet->stream_index = stream->index;
+
+		if (av_interleaved_write_frame(output, packet) < 0)
+		{
+			return false;
+		}
+	}
+
+	return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+bool MeasureSeeks(const char* fileName, bool accurate, int seekCount, SeekResult* result)
+{
+	MediaStream media = LoadMediaEx(fileName, MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO | (accurate ? MEDIA_FLAG_ACCURATE_SEEK : 0));
+
+	if (!IsMediaValid(media))
+	{
+		return false;
+	}
+
+	const double duration = GetMediaProperties(media).durationSec;
+	const MediaStats before = GetMediaStats(media);
+
+	long long decodedFrames = 0;
+	unsigned int seed = 12345u;
+
+	// The same positions for every clip and mode: a fixed linear congruential sequence
+	for (int i = 0; i < seekCount; ++i)
+	{
+		seed = seed * 1103515245u + 12345u;
+
+		const double position = (seed >> 8) % 10000 / 10000.0 * (duration - 1.0);
+
+		if (!SetMediaPosition(media, position))
+		{
+			UnloadMedia(&media);
+			return false;
+		}
+
+		decodedFrames += GetMediaStats(media).lastSeekDecodedFrames;
+	}
+
+	const MediaStats after = GetMediaStats(media);
+
+	UnloadMedia(&media);
+
+	const int seeks = after.seeks - before.seeks;
+
+	if (seeks == 0)
+	{
+		return false;
+	}
+
+	result->seekTime = (after.seekTime - before.seekTime) * 1000.0 / seeks;
+	result->decodedFrames = accurate ? (double)decodedFrames / seeks : 0.0;
+
+	return true;
+}
@@ -0,0 +1,189 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless benchmark of StepMediaFrame() latency in both directions: each bundled clip is paused a few seconds in,
+// stepped forward frame by frame, then back over the same frames. Forward steps are measured with synchronous
+// decoding and with the decode worker, which is outrun on purpose (the steps don't wait for it); backward steps
+// with and without the GOP cache (MEDIA_VIDEO_GOP_CACHE).
+// Usage: bench_step [steps per clip]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+#define STEP_CONFIGS_COUNT (int)(sizeof(STEP_CONFIGS) / sizeof(STEP_CONFIGS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct StepConfig
+{
+	const char* name;       // Column label
+	int flags;              // LoadMediaEx() flags
+	int gopCache;           // MEDIA_VIDEO_GOP_CACHE budget (MB)
+} StepConfig;
+
+typedef struct StepResult
+{
+	double forwardTime;     // Average forward step time (ms)
+	double backwardTime;    // Average backward step time (ms)
+} StepResult;
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+const StepConfig STEP_CONFIGS[] = {
+	{ "sync", MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO, 0 },
+	{ "worker", MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO | MEDIA_FLAG_THREADED_DECODE, 0 },
+	{ "cache", MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO, 64 }
+};
+
+// Position the steps start from (seconds)
+const double START_POSITION = 2.0;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Steps a clip stepCount frames forward, then back. Returns false on failure.
+bool MeasureSteps(const char* fileName, const StepConfig* config, int stepCount, StepResult* result);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const int stepCount = argc > 1 ? atoi(argv[1]) : 30;
+
+	SetTraceLogLevel(LOG_WARNING);
+
+	printf("StepMediaFrame() latency (ms), %d steps each way per clip\n\n", stepCount);
+	printf("%-24s", "clip");
+
+	for (int s = 0; s < STEP_CONFIGS_COUNT; ++s)
+	{
+		printf("%9s fwd%9s bwd", STEP_CONFIGS[s].name, STEP_CONFIGS[s].name);
+	}
+
+	printf("\n");
+
+	StepResult totals[STEP_CONFIGS_COUNT] = { 0 };
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		printf("%-24s", VIDEO_CLIPS[c]);
+
+		for (int s = 0; s < STEP_CONFIGS_COUNT; ++s)
+		{
+			StepResult result = { 0 };
+
+			if (!MeasureSteps(VIDEO_CLIPS[c], &STEP_CONFIGS[s], stepCount, &result))
+			{
+				printf("\nFailed to step through %s (run from the build directory).\n", VIDEO_CLIPS[c]);
+				return EXIT_FAILURE;
+			}
+
+			printf("%13.3f%13.3f", result.forwardTime, result.backwardTime);
+			fflush(stdout);
+
+			totals[s].forwardTime += result.forwardTime;
+			totals[s].backwardTime += result.backwardTime;
+		}
+
+		printf("\n");
+	}
+
+	printf("%-24s", "average");
+
+	for (int s = 0; s < STEP_CONFIGS_COUNT; ++s)
+	{
+		printf("%13.3f%13.3f", totals[s].forwardTime / VIDEO_CLIPS_COUNT, totals[s].backwardTime / VIDEO_CLIPS_COUNT);
+	}
+
+	printf("\n");
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool MeasureSteps(const char* fileName, const StepConfig* config, int stepCount, StepResult* result)
+{
+	SetMediaFlag(MEDIA_VIDEO_GOP_CACHE, config->gopCache);
+
+	MediaStream media = LoadMediaEx(fileName, config->flags);
+
+	if (!IsMediaValid(media))
+	{
+		return false;
+	}
+
+	SetMediaState(media, MEDIA_STATE_PAUSED);
+
+	bool success = SetMediaPosition(media, START_POSITION);
+
+	// Back to back, as when a key is held down
+	for (int i = 0; success && i < stepCount; ++i)
+	{
+		success = StepMediaFrame(media, 1);
+	}
+
+	for (int i = 0; success && i < stepCount; ++i)
+	{
+		success = StepMediaFrame(media, -1);
+	}
+
+	const MediaStats stats = GetMediaStats(media);
+
+	UnloadMedia(&media);
+
+	if (!success || stats.forwardSteps == 0 || stats.backwardSteps == 0)
+	{
+		return false;
+	}
+
+	result->forwardTime = stats.forwardStepTime * 1000.0 / stats.forwardSteps;
+	result->backwardTime = stats.backwardStepTime * 1000.0 / stats.backwardSteps;
+
+	return true;
+}
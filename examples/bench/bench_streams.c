@@ -0,0 +1,196 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless benchmark of the shared worker pool: aggregate decoded video frames per second for a growing number
+// of streams, with one dedicated thread per worker (0) and with pools of several sizes.
+// The media clocks run BENCH_SPEED times faster than real time, so decoding is the bottleneck.
+// Usage: bench_streams [seconds per run]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <libavutil/cpu.h>
+#include <libavutil/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+#define STREAM_COUNTS_COUNT (int)(sizeof(STREAM_COUNTS) / sizeof(STREAM_COUNTS[0]))
+
+#define MAX_STREAMS 16
+#define MAX_WORKER_COUNTS 6
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+const int STREAM_COUNTS[] = { 1, 2, 4, 8, 16 };
+
+const double BENCH_SPEED = 8.0;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays streamCount clips for runTime seconds with a pool of workerThreads threads (0: dedicated threads).
+// Returns the decoded frames per second, or a negative value on failure.
+double RunStreams(int streamCount, int workerThreads, double runTime);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const double runTime = argc > 1 ? atof(argv[1]) : 2.0;
+	const int cores = av_cpu_count();
+
+	SetTraceLogLevel(LOG_WARNING);
+
+	// Dedicated threads first, then pools up to the core count
+	int workerCounts[MAX_WORKER_COUNTS];
+	int workerCountsCount = 0;
+
+	workerCounts[workerCountsCount++] = 0;
+
+	for (int threads = 1; threads < cores && workerCountsCount < MAX_WORKER_COUNTS - 1; threads *= 2)
+	{
+		workerCounts[workerCountsCount++] = threads;
+	}
+
+	workerCounts[workerCountsCount++] = cores;
+
+	printf("Decoded video frames per second (%d cores, clocks at %.0fx, %.1f s per run)\n\n", cores, BENCH_SPEED, runTime);
+	printf("%-8s", "streams");
+
+	for (int w = 0; w < workerCountsCount; ++w)
+	{
+		if (workerCounts[w] == 0)
+		{
+			printf("%12s", "dedicated");
+		}
+		else
+		{
+			printf("%9d thr", workerCounts[w]);
+		}
+	}
+
+	printf("\n");
+
+	for (int s = 0; s < STREAM_COUNTS_COUNT; ++s)
+	{
+		printf("%-8d", STREAM_COUNTS[s]);
+
+		for (int w = 0; w < workerCountsCount; ++w)
+		{
+			const double fps = RunStreams(STREAM_COUNTS[s], workerCounts[w], runTime);
+
+			if (fps < 0.0)
+			{
+				printf("\nFailed to load the clips (run from the build directory).\n");
+				return EXIT_FAILURE;
+			}
+
+			printf("%12.1f", fps);
+			fflush(stdout);
+		}
+
+		printf("\n");
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+double RunStreams(int streamCount, int workerThreads, double runTime)
+{
+	MediaStream medias[MAX_STREAMS];
+
+	// The pool is created by the first load, all the media of the previous run are unloaded
+	SetMediaFlag(MEDIA_WORKER_THREADS, workerThreads);
+
+	// Late packets are decoded anyway, the clocks are ahead on purpose
+	SetMediaFlag(MEDIA_VIDEO_MAX_DELAY, 3600 * 1000);
+
+	bool loaded = true;
+
+	for (int i = 0; i < streamCount; ++i)
+	{
+		medias[i] = LoadMediaEx(VIDEO_CLIPS[i % VIDEO_CLIPS_COUNT], MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO | MEDIA_FLAG_LOOP | MEDIA_FLAG_THREADED_DECODE);
+		loaded = loaded && IsMediaValid(medias[i]);
+	}
+
+	int decodedFrames = 0;
+	const int64_t startTime = av_gettime_relative();
+	int64_t now = startTime;
+
+	if (loaded)
+	{
+		int64_t lastTime = startTime;
+
+		// A render loop updating every stream, at most once a millisecond
+		while (now - startTime < (int64_t)(runTime * 1e6))
+		{
+			const double deltaTime = (now - lastTime) / 1e6 * BENCH_SPEED;
+
+			for (int i = 0; i < streamCount; ++i)
+			{
+				UpdateMediaEx(&medias[i], deltaTime);
+			}
+
+			av_usleep(1000);
+
+			lastTime = now;
+			now = av_gettime_relative();
+		}
+
+		for (int i = 0; i < streamCount; ++i)
+		{
+			decodedFrames += GetMediaStats(medias[i]).decodedVideoFrames;
+		}
+	}
+
+	const double elapsed = (now - startTime) / 1e6;
+
+	for (int i = 0; i < streamCount; ++i)
+	{
+		UnloadMedia(&medias[i]);
+	}
+
+	return loaded ? decodedFrames / elapsed : -1.0;
+}
@@ -0,0 +1,160 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Benchmark of the video texture upload (MEDIA_VIDEO_FORMAT): average upload and conversion time per frame of
+// each bundled clip, with RGB24 and RGBA32 textures. Texture uploads need a GL context: the program opens a
+// hidden window (on a headless machine, run it under a virtual display, e.g. xvfb-run).
+// Usage: bench_upload [frames per clip]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct FormatResult
+{
+	double uploadTime;      // Upload time per frame (ms)
+	double convertTime;     // Conversion time per frame (ms)
+} FormatResult;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays up to frameCount frames of a clip into a texture of the given PixelFormat. Returns false on failure.
+bool MeasureUpload(const char* fileName, int format, int frameCount, FormatResult* result);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const int frameCount = argc > 1 ? atoi(argv[1]) : 120;
+
+	SetTraceLogLevel(LOG_WARNING);
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	InitWindow(64, 64, "bench_upload");
+
+	if (!IsWindowReady())
+	{
+		printf("Cannot create a GL context.\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("Video texture upload per frame (ms), %d frames per clip\n\n", frameCount);
+	printf("%-24s %12s %12s %12s %12s %9s\n", "clip", "RGB24 upl.", "RGBA32 upl.", "RGB24 conv.", "RGBA32 conv.", "RGBA gain");
+
+	FormatResult totals[2] = { 0 };
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		FormatResult rgb = { 0 };
+		FormatResult rgba = { 0 };
+
+		if (!MeasureUpload(VIDEO_CLIPS[c], PIXELFORMAT_UNCOMPRESSED_R8G8B8, frameCount, &rgb) ||
+			!MeasureUpload(VIDEO_CLIPS[c], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, frameCount, &rgba))
+		{
+			printf("Failed to play %s (run from the build directory).\n", VIDEO_CLIPS[c]);
+			CloseWindow();
+			return EXIT_FAILURE;
+		}
+
+		printf("%-24s %12.3f %12.3f %12.3f %12.3f %8.2fx\n", VIDEO_CLIPS[c], rgb.uploadTime, rgba.uploadTime,
+			   rgb.convertTime, rgba.convertTime, rgb.uploadTime / rgba.uploadTime);
+
+		totals[0].uploadTime += rgb.uploadTime;
+		totals[0].convertTime += rgb.convertTime;
+		totals[1].uploadTime += rgba.uploadTime;
+		totals[1].convertTime += rgba.convertTime;
+	}
+
+	printf("%-24s %12.3f %12.3f %12.3f %12.3f %8.2fx\n", "average", totals[0].uploadTime / VIDEO_CLIPS_COUNT,
+		   totals[1].uploadTime / VIDEO_CLIPS_COUNT, totals[0].convertTime / VIDEO_CLIPS_COUNT,
+		   totals[1].convertTime / VIDEO_CLIPS_COUNT, totals[0].uploadTime / totals[1].uploadTime);
+
+	CloseWindow();
+
+	return EXIT_SUCCESS;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool MeasureUpload(const char* fileName, int format, int frameCount, FormatResult* result)
+{
+	SetMediaFlag(MEDIA_VIDEO_FORMAT, format);
+
+	MediaStream media = LoadMediaEx(fileName, MEDIA_LOAD_NO_AUDIO);
+
+	if (!IsMediaValid(media))
+	{
+		return false;
+	}
+
+	const double frameTime = 1.0 / GetMediaProperties(media).avgFPS;
+
+	// One frame per update: every decoded frame is uploaded
+	for (int i = 0; i < frameCount && GetMediaState(media) == MEDIA_STATE_PLAYING; ++i)
+	{
+		UpdateMediaEx(&media, frameTime);
+	}
+
+	const MediaStats stats = GetMediaStats(media);
+
+	UnloadMedia(&media);
+
+	if (stats.presentedVideoFrames == 0)
+	{
+		return false;
+	}
+
+	result->uploadTime = stats.videoUploadTime * 1000.0 / stats.presentedVideoFrames;
+	result->convertTime = stats.videoConvertTime * 1000.0 / stats.presentedVideoFrames;
+
+	return true;
+}
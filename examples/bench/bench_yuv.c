@@ -0,0 +1,194 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless benchmark and accuracy check of the built-in YUV to RGB kernels (MEDIA_VIDEO_FAST_CONVERT):
+// each bundled clip is played twice in lockstep, converted by the kernels and by swscale. Prints the conversion
+// time per frame of both, and the PSNR and largest difference of the kernel frames against the swscale ones.
+// Fails if a clip is below MIN_PSNR: the kernels use 6-bit coefficients and nearest chroma sampling, so small
+// differences are expected, mostly at chroma edges; a wrong color matrix or range costs far more.
+// Usage: bench_yuv [frames per clip]
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+const double MIN_PSNR = 32.0;
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct ClipResult
+{
+	double kernelTime;      // Conversion time per frame with the kernels (ms)
+	double swscaleTime;     // Conversion time per frame with swscale (ms)
+	double psnr;            // PSNR of the kernel frames against the swscale ones (dB)
+	int maxDiff;            // Largest difference of a color component
+	int frames;             // Frames compared
+} ClipResult;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays up to frameCount frames of a clip with both converters. Returns false on failure.
+bool CompareConverters(const char* fileName, int frameCount, ClipResult* result);
+
+// Load a clip for the comparison, converted by the kernels or by swscale.
+MediaStream LoadClip(const char* fileName, bool fastConvert);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+	const int frameCount = argc > 1 ? atoi(argv[1]) : 120;
+
+	SetTraceLogLevel(LOG_WARNING);
+
+	printf("YUV to RGB conversion: built-in kernels vs. swscale, %d frames per clip\n\n", frameCount);
+	printf("%-24s %12s %12s %9s %9s %8s\n", "clip", "kernels ms", "swscale ms", "speedup", "PSNR dB", "max diff");
+
+	bool passed = true;
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		ClipResult result = { 0 };
+
+		if (!CompareConverters(VIDEO_CLIPS[c], frameCount, &result))
+		{
+			printf("Failed to play %s (run from the build directory).\n", VIDEO_CLIPS[c]);
+			return EXIT_FAILURE;
+		}
+
+		const bool accurate = (result.psnr >= MIN_PSNR);
+
+		printf("%-24s %12.3f %12.3f %8.2fx %9.2f %8d%s\n", VIDEO_CLIPS[c], result.kernelTime, result.swscaleTime,
+			   result.swscaleTime / result.kernelTime, result.psnr, result.maxDiff, accurate ? "" : "  FAILED");
+
+		passed = passed && accurate;
+	}
+
+	printf("\nAccuracy check %s (PSNR >= %.0f dB)\n", passed ? "passed" : "FAILED", MIN_PSNR);
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool CompareConverters(const char* fileName, int frameCount, ClipResult* result)
+{
+	MediaStream kernels = LoadClip(fileName, true);
+	MediaStream swscale = LoadClip(fileName, false);
+
+	if (!IsMediaValid(kernels) || !IsMediaValid(swscale))
+	{
+		UnloadMedia(&kernels);
+		UnloadMedia(&swscale);
+		return false;
+	}
+
+	const double frameTime = 1.0 / GetMediaProperties(kernels).avgFPS;
+
+	double squaredError = 0.0;
+	long long components = 0;
+
+	// One frame per update, the same one for both: decoding doesn't depend on the converter
+	for (int i = 0; i < frameCount && GetMediaState(kernels) == MEDIA_STATE_PLAYING; ++i)
+	{
+		UpdateMediaEx(&kernels, frameTime);
+		UpdateMediaEx(&swscale, frameTime);
+
+		const Image a = GetMediaImage(kernels);
+		const Image b = GetMediaImage(swscale);
+		const int size = a.width * a.height * 3;
+
+		for (int p = 0; p < size; ++p)
+		{
+			const int diff = abs(((const unsigned char*)a.data)[p] - ((const unsigned char*)b.data)[p]);
+
+			squaredError += (double)diff * diff;
+
+			if (diff > result->maxDiff)
+			{
+				result->maxDiff = diff;
+			}
+		}
+
+		components += size;
+		result->frames++;
+	}
+
+	const MediaStats kernelStats = GetMediaStats(kernels);
+	const MediaStats swscaleStats = GetMediaStats(swscale);
+
+	UnloadMedia(&kernels);
+	UnloadMedia(&swscale);
+
+	if (result->frames == 0 || kernelStats.presentedVideoFrames == 0 || swscaleStats.presentedVideoFrames == 0)
+	{
+		return false;
+	}
+
+	const double mse = squaredError / components;
+
+	result->psnr = (mse > 0.0) ? 10.0 * log10(255.0 * 255.0 / mse) : INFINITY;
+	result->kernelTime = kernelStats.videoConvertTime * 1000.0 / kernelStats.presentedVideoFrames;
+	result->swscaleTime = swscaleStats.videoConvertTime * 1000.0 / swscaleStats.presentedVideoFrames;
+
+	return true;
+}
+
+MediaStream LoadClip(const char* fileName, bool fastConvert)
+{
+	// Single band, RGB24: only the converter differs
+	SetMediaFlag(MEDIA_VIDEO_FAST_CONVERT, fastConvert ? 1 : 0);
+	SetMediaFlag(MEDIA_VIDEO_CONVERT_BANDS, 1);
+	SetMediaFlag(MEDIA_VIDEO_FORMAT, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+
+	return LoadMediaEx(fileName, MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO);
+}
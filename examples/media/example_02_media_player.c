@@ -208,14 +208,7 @@ int main(void)
             OnWindowResized();
         }
 
-        float frameTime = GetFrameTime();
-
-        if (Player.gui.buttons[BTN_SPEED].toggle == BTN_CHECKED)
-        {
-            frameTime *= 4.0f;
-        }
-
-        UpdateMediaEx(&Player.media, frameTime);
+        UpdateMedia(&Player.media);
 
         if (GetMediaState(Player.media) == MEDIA_STATE_STOPPED)
         {
@@ -405,7 +398,7 @@ void BuildButtons(void)
     buttons[BTN_FAST_REWIND] = BuildButton(BTN_FAST_REWIND, ICO_FAST_REWIND, "-15s");
     buttons[BTN_PLAY] = BuildButton(BTN_PLAY, ICO_PAUSE, "Play/Pause");
     buttons[BTN_FAST_FORWARD] = BuildButton(BTN_FAST_FORWARD, ICO_FAST_FORWARD, "+15s");
-    buttons[BTN_SPEED] = BuildButton(BTN_SPEED, ICO_SPEED, "Speed x4");
+    buttons[BTN_SPEED] = BuildButton(BTN_SPEED, ICO_SPEED, "Speed x2");
     buttons[BTN_VOLUME] = BuildButton(BTN_VOLUME, ICO_VOLUME, "Sound/Mute");
     buttons[BTN_LOOP] = BuildButton(BTN_LOOP, ICO_LOOP, "Loop Toggle");
     buttons[BTN_GREYSCALE] = BuildButton(BTN_GREYSCALE, ICO_CONTRAST, "Greyscale Toggle");
@@ -507,6 +500,7 @@ void HandleButton(Button* btn)
             break;
         case BTN_SPEED:
             btn->toggle = btn->toggle == BTN_UNCHECKED ? BTN_CHECKED : BTN_UNCHECKED;
+            SetMediaPlaybackRate(Player.media, btn->toggle == BTN_CHECKED ? 2.0 : 1.0);
             break;
         default:
             break;
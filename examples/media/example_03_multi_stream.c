@@ -267,6 +267,22 @@ bool LoadEnvironment(void)
 
 	SetTextureFilter(envTexture, TEXTURE_FILTER_BILINEAR);
 
+	// Start loading the media streams in the background while the models load
+	// (packets are read in the background too, so disk stalls don't hit the render loop)
+	static char clipPaths[VIDEO_CLIPS_COUNT][256];
+	const char* clipPathPtrs[VIDEO_CLIPS_COUNT];
+
+	for (int i = 0; i < VIDEO_CLIPS_COUNT; ++i)
+	{
+		TextCopy(clipPaths[i], TextFormat("resources/clips/%s", VIDEO_CLIPS[i]));
+		clipPathPtrs[i] = clipPaths[i];
+	}
+
+	// The screens cover a small part of the window: decode into smaller textures (the aspect ratio is kept)
+	SetMediaFlag(MEDIA_VIDEO_OUTPUT_HEIGHT, 256);
+
+	LoadMediaAsyncBatch(clipPathPtrs, VIDEO_CLIPS_COUNT, MEDIA_FLAG_LOOP | MEDIA_FLAG_THREADED_DEMUX, Scene.medias);
+
 	// Load models
 	Scene.envModel[ENV_MODEL_BACKGROUND] = LoadModel("resources/models/tv_shop_model_bg.obj");
 	Scene.envModel[ENV_MODEL_FOREGROUND] = LoadModel("resources/models/tv_shop_model_fg.obj");
@@ -284,11 +300,10 @@ bool LoadEnvironment(void)
 		Scene.envModel[i].materials[0].maps[MATERIAL_MAP_ALBEDO].texture = envTexture;
 	}
 
-	// Load media streams
+	// Complete the media streams loading (textures and audio streams are created here)
 	for (int i = 0; i < VIDEO_CLIPS_COUNT; ++i)
 	{
-		Scene.medias[i] = LoadMediaEx(TextFormat("resources/clips/%s", VIDEO_CLIPS[i]), MEDIA_FLAG_LOOP);
-		if (!IsMediaValid(Scene.medias[i]))
+		if (!FinishMediaLoad(&Scene.medias[i]))
 		{
 			TraceLog(LOG_ERROR, "Failed to load media stream %s.", VIDEO_CLIPS[i]);
 			return false;
@@ -352,13 +367,10 @@ void UnloadEnvironment(void)
 		}
 	}
 
-	// Unload media streams
+	// Unload media streams (also cancels loads still in progress)
 	for (int i = 0; i < VIDEO_CLIPS_COUNT; ++i)
 	{
-		if (IsMediaValid(Scene.medias[i]))
-		{
-			UnloadMedia(&Scene.medias[i]);
-		}
+		UnloadMedia(&Scene.medias[i]);
 	}
 }
 
@@ -0,0 +1,188 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless test of the audio time-stretcher (SetMediaPlaybackRate): each bundled clip is played for CLIP_SPAN
+// seconds of media time at every rate in RATES, with the audio delivered to a callback. Checks that:
+// - the audio stays within MAX_DRIFT of the media position (MediaStats.audioDrift),
+// - no audio packet is dropped (MediaStats.droppedAudioPackets),
+// - the audio played scales with 1 / rate, within OUTPUT_TOLERANCE of the 1x output,
+// - non-finite rates are rejected.
+// Usage: test_time_stretch
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+#define RATES_COUNT (int)(sizeof(RATES) / sizeof(RATES[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+// 1x first: the reference output of each clip
+const double RATES[] = { 1.0, 0.5, 1.5, 2.0 };
+
+const double CLIP_SPAN = 6.0;           // Media time played per run (seconds)
+const double WARM_UP = 0.5;             // Media time before the drift is checked (seconds)
+const double UPDATE_TIME = 1.0 / 60.0;  // deltaTime of each update, as a 60 FPS render loop
+const double MAX_DRIFT = 0.1;           // Largest audio drift allowed (seconds)
+const double OUTPUT_TOLERANCE = 0.03;   // Largest relative difference of the rate-scaled audio output
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct RunResult
+{
+	long long outputFrames; // Audio frames received by the callback
+	double maxDrift;        // Largest |audioDrift| after the warm-up (seconds)
+	int droppedPackets;     // MediaStats.droppedAudioPackets at the end
+} RunResult;
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays CLIP_SPAN seconds of a clip at the given rate. Returns false if the clip can't be played.
+bool RunClip(const char* fileName, double rate, RunResult* result);
+
+// Audio callback counting the frames received.
+void CountAudioFrames(void* userData, const void* data, int frameCount);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(void)
+{
+	SetTraceLogLevel(LOG_WARNING);
+
+	printf("Audio time-stretching: drift <= %.0f ms, no dropped packets, output within %.0f%% of 1x / rate\n\n",
+		   MAX_DRIFT * 1000.0, OUTPUT_TOLERANCE * 100.0);
+	printf("%-24s %6s %12s %10s %10s\n", "clip", "rate", "output", "drift ms", "dropped");
+
+	bool passed = true;
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		long long referenceFrames = 0;
+
+		for (int r = 0; r < RATES_COUNT; ++r)
+		{
+			RunResult result = { 0 };
+
+			if (!RunClip(VIDEO_CLIPS[c], RATES[r], &result))
+			{
+				printf("Failed to play %s (run from the build directory).\n", VIDEO_CLIPS[c]);
+				return EXIT_FAILURE;
+			}
+
+			if (RATES[r] == 1.0)
+			{
+				referenceFrames = result.outputFrames;
+			}
+
+			// Output relative to the 1x output, scaled by the rate: 1 when the audio keeps up with the media time
+			const double output = referenceFrames > 0 ? result.outputFrames * RATES[r] / referenceFrames : 0.0;
+
+			const bool ok = result.maxDrift <= MAX_DRIFT && result.droppedPackets == 0 &&
+							fabs(output - 1.0) <= OUTPUT_TOLERANCE;
+
+			printf("%-24s %5.1fx %12.4f %10.1f %10d%s\n", VIDEO_CLIPS[c], RATES[r], output, result.maxDrift * 1000.0,
+				   result.droppedPackets, ok ? "" : "  FAILED");
+
+			passed = passed && ok;
+		}
+	}
+
+	// Non-finite rates must leave the current one untouched
+	MediaStream media = LoadMediaEx(VIDEO_CLIPS[0], MEDIA_LOAD_HEADLESS);
+
+	const bool rejected = IsMediaValid(media) && !SetMediaPlaybackRate(media, NAN) &&
+						  !SetMediaPlaybackRate(media, INFINITY) && GetMediaPlaybackRate(media) == 1.0;
+
+	UnloadMedia(&media);
+
+	printf("\nNon-finite rates %s\n", rejected ? "rejected" : "ACCEPTED");
+
+	passed = passed && rejected;
+
+	printf("Time-stretching test %s\n", passed ? "passed" : "FAILED");
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool RunClip(const char* fileName, double rate, RunResult* result)
+{
+	MediaStream media = LoadMediaEx(fileName, MEDIA_LOAD_HEADLESS);
+
+	if (!IsMediaValid(media) || !GetMediaProperties(media).hasAudio ||
+		!SetMediaAudioCallback(media, CountAudioFrames, &result->outputFrames) || !SetMediaPlaybackRate(media, rate))
+	{
+		UnloadMedia(&media);
+		return false;
+	}
+
+	while (GetMediaState(media) == MEDIA_STATE_PLAYING && GetMediaPosition(media) < CLIP_SPAN)
+	{
+		UpdateMediaEx(&media, UPDATE_TIME);
+
+		const double drift = fabs(GetMediaStats(media).audioDrift);
+
+		if (GetMediaPosition(media) >= WARM_UP && drift > result->maxDrift)
+		{
+			result->maxDrift = drift;
+		}
+	}
+
+	result->droppedPackets = GetMediaStats(media).droppedAudioPackets;
+
+	UnloadMedia(&media);
+
+	return true;
+}
+
+void CountAudioFrames(void* userData, const void* data, int frameCount)
+{
+	*(long long*)userData += frameCount;
+}
@@ -0,0 +1,318 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Headless test of the video plane layout (AcquireMediaFrame, GetMediaImage): each bundled clip is played with RGB
+// and with YUV output (MEDIA_FLAG_VIDEO_YUV) in lockstep, at its own size and at OUTPUT_SIZES, odd sizes included.
+// Checks that:
+// - the planes are packed as documented: rows of width (chroma: half width rounded up) bytes, planes back to back,
+//   the luma plane at the start of GetMediaImage(),
+// - the YUV planes read with those strides convert back to the RGB output of the same frame (MIN_PSNR): a wrong
+//   stride or plane offset shears or scrambles the picture far below it.
+// Usage: test_video_planes
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define VIDEO_CLIPS_COUNT (int)(sizeof(VIDEO_CLIPS) / sizeof(VIDEO_CLIPS[0]))
+#define OUTPUT_SIZES_COUNT (int)(sizeof(OUTPUT_SIZES) / sizeof(OUTPUT_SIZES[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const char* VIDEO_CLIPS[] = {
+	"resources/clips/001.mp4", "resources/clips/002.mp4", "resources/clips/003.mp4", "resources/clips/004.mp4",
+	"resources/clips/005.mp4", "resources/clips/006.mp4", "resources/clips/007.mp4", "resources/clips/008.mp4",
+	"resources/clips/009.mp4", "resources/clips/010.mp4", "resources/clips/011.mp4"
+};
+
+// Output sizes (0 x 0: the source size, planes copied as decoded)
+const int OUTPUT_SIZES[][2] = { { 0, 0 }, { 640, 360 }, { 333, 187 }, { 101, 57 } };
+
+const int UPDATE_COUNT = 10;    // Frames played before checking
+const double MIN_PSNR = 25.0;   // Lowest PSNR of the YUV planes converted to RGB against the RGB output (dB)
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Plays a clip with both outputs at the given size and checks the planes. Prints the result, returns false on failure.
+bool CheckClip(const char* fileName, int width, int height);
+
+// Checks the layout of the planes of a YUV frame against the documented one. Prints the first mismatch, if any.
+bool CheckYUVLayout(const MediaFrame* frame, const Image* image);
+
+// PSNR (dB) of the YUV frame converted to RGB against an RGB frame of the same size, with the color matrix and
+// range matching best (the output doesn't tell which one the clip uses).
+double CompareYUVToRGB(const MediaFrame* yuv, const MediaFrame* rgb);
+
+// Load a clip for the test, headless and without audio.
+MediaStream LoadClip(const char* fileName, int width, int height, bool yuv);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(void)
+{
+	SetTraceLogLevel(LOG_WARNING);
+
+	printf("Video plane layout: packed planes, YUV converted back to RGB >= %.0f dB\n\n", MIN_PSNR);
+	printf("%-24s %-11s %-9s %8s %8s %8s %9s\n", "clip", "size", "format", "Y row", "C row", "planes", "PSNR dB");
+
+	bool passed = true;
+
+	for (int c = 0; c < VIDEO_CLIPS_COUNT; ++c)
+	{
+		for (int s = 0; s < OUTPUT_SIZES_COUNT; ++s)
+		{
+			passed = CheckClip(VIDEO_CLIPS[c], OUTPUT_SIZES[s][0], OUTPUT_SIZES[s][1]) && passed;
+		}
+	}
+
+	printf("\nVideo plane test %s\n", passed ? "passed" : "FAILED");
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool CheckClip(const char* fileName, int width, int height)
+{
+	MediaStream rgb = LoadClip(fileName, width, height, false);
+	MediaStream yuv = LoadClip(fileName, width, height, true);
+
+	if (!IsMediaValid(rgb) || !IsMediaValid(yuv))
+	{
+		printf("Failed to load %s (run from the build directory).\n", fileName);
+		UnloadMedia(&rgb);
+		UnloadMedia(&yuv);
+		return false;
+	}
+
+	const double frameTime = 1.0 / GetMediaProperties(rgb).avgFPS;
+
+	// The same frame for both: decoding doesn't depend on the output
+	for (int i = 0; i < UPDATE_COUNT; ++i)
+	{
+		UpdateMediaEx(&rgb, frameTime);
+		UpdateMediaEx(&yuv, frameTime);
+	}
+
+	MediaFrame rgbFrame = { 0 };
+	MediaFrame yuvFrame = { 0 };
+
+	bool passed = AcquireMediaFrame(rgb, &rgbFrame) && AcquireMediaFrame(yuv, &yuvFrame);
+
+	const Image yuvImage = GetMediaImage(yuv);
+	const char* format = "?";
+	double psnr = 0.0;
+
+	if (passed)
+	{
+		switch (yuvFrame.format)
+		{
+		case MEDIA_FRAME_YUV420P:  format = "YUV420P"; break;
+		case MEDIA_FRAME_YUVJ420P: format = "YUVJ420P"; break;
+		case MEDIA_FRAME_NV12:     format = "NV12"; break;
+		default: break;
+		}
+
+		// Requested sizes are honored exactly, and both outputs have the same one
+		const bool sized = (width == 0 || (rgbFrame.width == width && rgbFrame.height == height)) &&
+						   rgbFrame.width == yuvFrame.width && rgbFrame.height == yuvFrame.height;
+
+		if (!sized)
+		{
+			printf("%s: output size %dx%d (RGB) / %dx%d (YUV), requested %dx%d\n", fileName,
+				   rgbFrame.width, rgbFrame.height, yuvFrame.width, yuvFrame.height, width, height);
+		}
+
+		const bool packedRGB = rgbFrame.format == MEDIA_FRAME_RGB24 && rgbFrame.planeCount == 1 &&
+							   rgbFrame.lineSize[0] == rgbFrame.width * 3;
+
+		if (!packedRGB)
+		{
+			printf("%s: RGB frame with %d plane(s), rows of %d bytes for a width of %d\n", fileName,
+				   rgbFrame.planeCount, rgbFrame.lineSize[0], rgbFrame.width);
+		}
+
+		passed = sized && packedRGB && CheckYUVLayout(&yuvFrame, &yuvImage);
+
+		if (passed)
+		{
+			psnr = CompareYUVToRGB(&yuvFrame, &rgbFrame);
+			passed = (psnr >= MIN_PSNR);
+		}
+	}
+
+	char size[16];
+	snprintf(size, sizeof(size), "%dx%d", yuvFrame.width, yuvFrame.height);
+
+	printf("%-24s %-11s %-9s %8d %8d %8d %9.2f%s\n", fileName, size, format, yuvFrame.lineSize[0], yuvFrame.lineSize[1],
+		   yuvFrame.planeCount, psnr, passed ? "" : "  FAILED");
+
+	ReleaseMediaFrame(rgb, &rgbFrame);
+	ReleaseMediaFrame(yuv, &yuvFrame);
+
+	UnloadMedia(&rgb);
+	UnloadMedia(&yuv);
+
+	return passed;
+}
+
+bool CheckYUVLayout(const MediaFrame* frame, const Image* image)
+{
+	const bool semiPlanar = (frame->format == MEDIA_FRAME_NV12);
+	const int planeCount = semiPlanar ? 2 : 3;
+	const int chromaWidth = (frame->width + 1) / 2;
+	const int chromaHeight = (frame->height + 1) / 2;
+
+	if (frame->format != MEDIA_FRAME_YUV420P && frame->format != MEDIA_FRAME_YUVJ420P && !semiPlanar)
+	{
+		printf("Unexpected YUV frame format %d\n", frame->format);
+		return false;
+	}
+
+	if (frame->planeCount != planeCount)
+	{
+		printf("%d planes instead of %d\n", frame->planeCount, planeCount);
+		return false;
+	}
+
+	if (image->data != frame->data[0] || image->width != frame->width || image->height != frame->height)
+	{
+		printf("GetMediaImage() doesn't start with the luma plane\n");
+		return false;
+	}
+
+	for (int i = 0; i < planeCount; ++i)
+	{
+		const int rowSize = (i == 0) ? frame->width : (semiPlanar ? 2 * chromaWidth : chromaWidth);
+
+		if (frame->lineSize[i] != rowSize)
+		{
+			printf("Plane #%d: rows of %d bytes instead of %d\n", i, frame->lineSize[i], rowSize);
+			return false;
+		}
+
+		if (i > 0)
+		{
+			const int previousRows = (i == 1) ? frame->height : chromaHeight;
+
+			if (frame->data[i] != frame->data[i - 1] + (size_t)frame->lineSize[i - 1] * previousRows)
+			{
+				printf("Plane #%d doesn't follow plane #%d\n", i, i - 1);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+double CompareYUVToRGB(const MediaFrame* yuv, const MediaFrame* rgb)
+{
+	// Kr and Kb of BT.601 and BT.709
+	const double KR[2] = { 0.299, 0.2126 };
+	const double KB[2] = { 0.114, 0.0722 };
+
+	const bool semiPlanar = (yuv->format == MEDIA_FRAME_NV12);
+
+	double bestPsnr = 0.0;
+
+	for (int matrix = 0; matrix < 2; ++matrix)
+	{
+		for (int fullRange = 0; fullRange < 2; ++fullRange)
+		{
+			const double kr = KR[matrix];
+			const double kb = KB[matrix];
+			const double kg = 1.0 - kr - kb;
+
+			double squaredError = 0.0;
+
+			for (int y = 0; y < yuv->height; ++y)
+			{
+				const unsigned char* rowY = yuv->data[0] + (size_t)y * yuv->lineSize[0];
+				const unsigned char* rowU = yuv->data[1] + (size_t)(y / 2) * yuv->lineSize[1];
+				const unsigned char* rowV = semiPlanar ? rowU + 1 : yuv->data[2] + (size_t)(y / 2) * yuv->lineSize[2];
+				const unsigned char* rowRGB = rgb->data[0] + (size_t)y * rgb->lineSize[0];
+
+				for (int x = 0; x < yuv->width; ++x)
+				{
+					const int c = semiPlanar ? (x / 2) * 2 : x / 2;
+
+					double l = rowY[x];
+					double u = rowU[c] - 128.0;
+					double v = rowV[c] - 128.0;
+
+					if (!fullRange)
+					{
+						l = (l - 16.0) * 255.0 / 219.0;
+						u *= 255.0 / 224.0;
+						v *= 255.0 / 224.0;
+					}
+
+					const double r = l + 2.0 * (1.0 - kr) * v;
+					const double b = l + 2.0 * (1.0 - kb) * u;
+					const double g = (l - kr * r - kb * b) / kg;
+					const double converted[3] = { r, g, b };
+
+					for (int k = 0; k < 3; ++k)
+					{
+						const double diff = fmin(fmax(converted[k], 0.0), 255.0) - rowRGB[x * 3 + k];
+						squaredError += diff * diff;
+					}
+				}
+			}
+
+			const double mse = squaredError / ((double)yuv->width * yuv->height * 3);
+			const double psnr = (mse > 0.0) ? 10.0 * log10(255.0 * 255.0 / mse) : INFINITY;
+
+			bestPsnr = fmax(bestPsnr, psnr);
+		}
+	}
+
+	return bestPsnr;
+}
+
+MediaStream LoadClip(const char* fileName, int width, int height, bool yuv)
+{
+	SetMediaFlag(MEDIA_VIDEO_FORMAT, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+	SetMediaFlag(MEDIA_VIDEO_OUTPUT_WIDTH, width);
+	SetMediaFlag(MEDIA_VIDEO_OUTPUT_HEIGHT, height);
+
+	return LoadMediaEx(fileName, MEDIA_LOAD_HEADLESS | MEDIA_LOAD_NO_AUDIO | (yuv ? MEDIA_FLAG_VIDEO_YUV : 0));
+}
@@ -0,0 +1,370 @@
+/***************************************************************************************************
+*
+*   LICENSE: zlib
+*
+*   Copyright (c) 2024 Claudio Z. (@cloudofoz)
+*
+*   This software is provided "as-is," without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+***************************************************************************************************/
+
+// Test of the YUV video shader (MEDIA_FLAG_VIDEO_YUV) with each of its GLSL headers: the shader is compiled and
+// linked with a vertex shader of the same GLSL version, then draws 1x1 Y, U and V planes into a render texture,
+// whose pixel is read back and compared to the expected color, for every plane layout, range and color matrix.
+// A GL context only accepts some GLSL versions: a header is skipped when a trivial shader of its version doesn't
+// compile either, except the one of the running context, which must pass.
+// Needs a GL context: the program opens a hidden window. On a headless machine, run it with Mesa llvmpipe under a
+// virtual display: LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./test_yuv_shader
+// Usage: test_yuv_shader
+
+//--------------------------------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------------------------------
+
+#include <raymedia.h>
+#include <rlgl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//--------------------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------------------
+
+#define SHADER_VARIANTS_COUNT (int)(sizeof(SHADER_VARIANTS) / sizeof(SHADER_VARIANTS[0]))
+#define TEST_COLORS_COUNT (int)(sizeof(TEST_COLORS) / sizeof(TEST_COLORS[0]))
+
+//--------------------------------------------------------------------------------------------------
+// Structures
+//--------------------------------------------------------------------------------------------------
+
+typedef struct ShaderVariant
+{
+	int glVersion;          // rlGetVersion() value selecting the header
+	const char* name;       // GLSL version label
+	const char* vsCode;     // Vertex shader of the same GLSL version, with the raylib attribute names
+} ShaderVariant;
+
+typedef struct PlaneTextures
+{
+	Texture y;              // Luma plane (grayscale)
+	Texture u;              // U plane (grayscale)
+	Texture v;              // V plane (grayscale)
+	Texture uv;             // Interleaved UV plane of NV12 (gray + alpha)
+} PlaneTextures;
+
+//--------------------------------------------------------------------------------------------------
+// Constants and Enumerations
+//--------------------------------------------------------------------------------------------------
+
+const ShaderVariant SHADER_VARIANTS[] = {
+	{ RL_OPENGL_21, "GLSL 120",
+		"#version 120\n"
+		"attribute vec3 vertexPosition;\n"
+		"attribute vec2 vertexTexCoord;\n"
+		"attribute vec4 vertexColor;\n"
+		"varying vec2 fragTexCoord;\n"
+		"varying vec4 fragColor;\n"
+		"uniform mat4 mvp;\n"
+		"void main()\n"
+		"{\n"
+		"    fragTexCoord = vertexTexCoord;\n"
+		"    fragColor = vertexColor;\n"
+		"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+		"}\n" },
+	{ RL_OPENGL_33, "GLSL 330",
+		"#version 330\n"
+		"in vec3 vertexPosition;\n"
+		"in vec2 vertexTexCoord;\n"
+		"in vec4 vertexColor;\n"
+		"out vec2 fragTexCoord;\n"
+		"out vec4 fragColor;\n"
+		"uniform mat4 mvp;\n"
+		"void main()\n"
+		"{\n"
+		"    fragTexCoord = vertexTexCoord;\n"
+		"    fragColor = vertexColor;\n"
+		"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+		"}\n" },
+	{ RL_OPENGL_ES_20, "GLSL ES 100",
+		"#version 100\n"
+		"attribute vec3 vertexPosition;\n"
+		"attribute vec2 vertexTexCoord;\n"
+		"attribute vec4 vertexColor;\n"
+		"varying vec2 fragTexCoord;\n"
+		"varying vec4 fragColor;\n"
+		"uniform mat4 mvp;\n"
+		"void main()\n"
+		"{\n"
+		"    fragTexCoord = vertexTexCoord;\n"
+		"    fragColor = vertexColor;\n"
+		"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+		"}\n" },
+	{ RL_OPENGL_ES_30, "GLSL ES 300",
+		"#version 300 es\n"
+		"in vec3 vertexPosition;\n"
+		"in vec2 vertexTexCoord;\n"
+		"in vec4 vertexColor;\n"
+		"out vec2 fragTexCoord;\n"
+		"out vec4 fragColor;\n"
+		"uniform mat4 mvp;\n"
+		"void main()\n"
+		"{\n"
+		"    fragTexCoord = vertexTexCoord;\n"
+		"    fragColor = vertexColor;\n"
+		"    gl_Position = mvp*vec4(vertexPosition, 1.0);\n"
+		"}\n" }
+};
+
+// Y, U, V samples: black, white, gray and saturated colors
+const unsigned char TEST_COLORS[][3] = {
+	{ 16, 128, 128 }, { 235, 128, 128 }, { 126, 128, 128 }, { 81, 90, 240 }, { 145, 54, 34 }, { 41, 240, 110 }, { 170, 166, 16 }
+};
+
+// Fragment shader body compiled after each header to probe its GLSL version
+const char* PROBE_SHADER_CODE = "void main()\n{\n    FRAG_COLOR = vec4(1.0);\n}\n";
+
+const int MAX_DIFF = 2;     // Largest difference of a color component (rounding and mediump precision)
+
+//--------------------------------------------------------------------------------------------------
+// Internal functions of rmedia.c (not part of the public API)
+//--------------------------------------------------------------------------------------------------
+
+const char* GetYUVShaderHeader(int glVersion);
+Shader LoadYUVShader(const char* header, const char* vsCode);
+
+//--------------------------------------------------------------------------------------------------
+// Function Declarations
+//--------------------------------------------------------------------------------------------------
+
+// Check if the context compiles a trivial shader with the header of a variant.
+bool IsVariantSupported(const ShaderVariant* variant);
+
+// Draws every test color with every layout, range and color matrix. Returns the number of failed cases.
+int CheckShader(Shader shader, RenderTexture2D target, int* caseCount);
+
+// Draws a test color into the render target, returns the color read back.
+Color DrawPlanes(Shader shader, RenderTexture2D target, const unsigned char* yuv, int semiPlanar, int fullRange, int colorMatrix);
+
+// Expected color of a test color, computed like the shader.
+Color ExpectedColor(const unsigned char* yuv, int fullRange, int colorMatrix);
+
+//--------------------------------------------------------------------------------------------------
+// Main Entry Point
+//--------------------------------------------------------------------------------------------------
+
+int main(void)
+{
+	SetTraceLogLevel(LOG_WARNING);
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	InitWindow(64, 64, "test_yuv_shader");
+
+	if (!IsWindowReady())
+	{
+		printf("Cannot create a GL context.\n");
+		return EXIT_FAILURE;
+	}
+
+	const char* contextHeader = GetYUVShaderHeader(rlGetVersion());
+
+	RenderTexture2D target = LoadRenderTexture(4, 4);
+
+	printf("YUV video shader per GLSL header, %d colors x 8 layouts, within %d\n\n", TEST_COLORS_COUNT, MAX_DIFF);
+
+	if (!IsRenderTextureValid(target))
+	{
+		printf("Cannot create the render texture.\n");
+		CloseWindow();
+		return EXIT_FAILURE;
+	}
+
+	bool passed = true;
+
+	for (int v = 0; v < SHADER_VARIANTS_COUNT; ++v)
+	{
+		const ShaderVariant* variant = &SHADER_VARIANTS[v];
+		const char* header = GetYUVShaderHeader(variant->glVersion);
+		const bool current = (header == contextHeader);
+
+		if (!current && !IsVariantSupported(variant))
+		{
+			printf("%-12s skipped (GLSL version not accepted by this context)\n", variant->name);
+			continue;
+		}
+
+		const Shader shader = LoadYUVShader(header, variant->vsCode);
+
+		if (!IsShaderValid(shader))
+		{
+			printf("%-12s compilation FAILED\n", variant->name);
+			passed = false;
+			continue;
+		}
+
+		int caseCount = 0;
+		const int failures = CheckShader(shader, target, &caseCount);
+
+		printf("%-12s %d/%d cases%s%s\n", variant->name, caseCount - failures, caseCount,
+			   current ? " (context version)" : "", failures ? "  FAILED" : "");
+
+		passed = passed && failures == 0;
+
+		UnloadShader(shader);
+	}
+
+	UnloadRenderTexture(target);
+	CloseWindow();
+
+	printf("\nYUV shader test %s\n", passed ? "passed" : "FAILED");
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Function Definitions
+//--------------------------------------------------------------------------------------------------
+
+bool IsVariantSupported(const ShaderVariant* variant)
+{
+	char code[512];
+
+	snprintf(code, sizeof(code), "%s%s", GetYUVShaderHeader(variant->glVersion), PROBE_SHADER_CODE);
+
+	const Shader shader = LoadShaderFromMemory(variant->vsCode, code);
+
+	// raylib falls back to its default shader when compilation fails
+	const bool supported = IsShaderValid(shader) && shader.id != rlGetShaderIdDefault();
+
+	if (supported)
+	{
+		UnloadShader(shader);
+	}
+
+	return supported;
+}
+
+int CheckShader(Shader shader, RenderTexture2D target, int* caseCount)
+{
+	int failures = 0;
+
+	for (int c = 0; c < TEST_COLORS_COUNT; ++c)
+	{
+		for (int layout = 0; layout < 8; ++layout)
+		{
+			const int semiPlanar = layout & 1;
+			const int fullRange = (layout >> 1) & 1;
+			const int colorMatrix = (layout >> 2) & 1;
+
+			const Color color = DrawPlanes(shader, target, TEST_COLORS[c], semiPlanar, fullRange, colorMatrix);
+			const Color expected = ExpectedColor(TEST_COLORS[c], fullRange, colorMatrix);
+
+			const bool match = abs(color.r - expected.r) <= MAX_DIFF && abs(color.g - expected.g) <= MAX_DIFF &&
+							   abs(color.b - expected.b) <= MAX_DIFF;
+
+			if (!match)
+			{
+				printf("    YUV %3d %3d %3d %s %s BT.%s: %3d %3d %3d instead of %3d %3d %3d\n",
+					   TEST_COLORS[c][0], TEST_COLORS[c][1], TEST_COLORS[c][2], semiPlanar ? "NV12" : "I420",
+					   fullRange ? "full" : "limited", colorMatrix ? "709" : "601",
+					   color.r, color.g, color.b, expected.r, expected.g, expected.b);
+				failures++;
+			}
+
+			(*caseCount)++;
+		}
+	}
+
+	return failures;
+}
+
+Color DrawPlanes(Shader shader, RenderTexture2D target, const unsigned char* yuv, int semiPlanar, int fullRange, int colorMatrix)
+{
+	unsigned char y = yuv[0];
+	unsigned char u = yuv[1];
+	unsigned char v = yuv[2];
+	unsigned char uv[2] = { yuv[1], yuv[2] };
+
+	// 1x1 planes: every fragment samples the same texel
+	const PlaneTextures planes = {
+		.y = LoadTextureFromImage((Image){ &y, 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE }),
+		.u = LoadTextureFromImage((Image){ &u, 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE }),
+		.v = LoadTextureFromImage((Image){ &v, 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE }),
+		.uv = LoadTextureFromImage((Image){ uv, 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA })
+	};
+
+	SetShaderValue(shader, GetShaderLocation(shader, "semiPlanar"), &semiPlanar, SHADER_UNIFORM_INT);
+	SetShaderValue(shader, GetShaderLocation(shader, "fullRange"), &fullRange, SHADER_UNIFORM_INT);
+	SetShaderValue(shader, GetShaderLocation(shader, "colorMatrix"), &colorMatrix, SHADER_UNIFORM_INT);
+
+	BeginTextureMode(target);
+	ClearBackground(BLACK);
+	BeginShaderMode(shader);
+
+	// Bound like DrawMediaVideo(): luma by the draw call, chroma to the next units
+	SetShaderValueTexture(shader, GetShaderLocation(shader, "texture1"), semiPlanar ? planes.uv : planes.u);
+
+	if (!semiPlanar)
+	{
+		SetShaderValueTexture(shader, GetShaderLocation(shader, "texture2"), planes.v);
+	}
+
+	DrawTexturePro(planes.y, (Rectangle){ 0, 0, 1, 1 }, (Rectangle){ 0, 0, (float)target.texture.width, (float)target.texture.height },
+				   (Vector2){ 0, 0 }, 0.0f, WHITE);
+
+	EndShaderMode();
+	EndTextureMode();
+
+	Image image = LoadImageFromTexture(target.texture);
+	const Color color = GetImageColor(image, image.width / 2, image.height / 2);
+
+	UnloadImage(image);
+	UnloadTexture(planes.y);
+	UnloadTexture(planes.u);
+	UnloadTexture(planes.v);
+	UnloadTexture(planes.uv);
+
+	return color;
+}
+
+Color ExpectedColor(const unsigned char* yuv, int fullRange, int colorMatrix)
+{
+	double y = yuv[0] / 255.0;
+	double u = yuv[1] / 255.0 - 128.0 / 255.0;
+	double v = yuv[2] / 255.0 - 128.0 / 255.0;
+
+	if (!fullRange)
+	{
+		y = (y - 16.0 / 255.0) * (255.0 / 219.0);
+		u *= 255.0 / 224.0;
+		v *= 255.0 / 224.0;
+	}
+
+	// Same coefficients as the shader
+	const double rgb[3] = {
+		colorMatrix ? y + 1.5748 * v : y + 1.4020 * v,
+		colorMatrix ? y - 0.1873 * u - 0.4681 * v : y - 0.3441 * u - 0.7141 * v,
+		colorMatrix ? y + 1.8556 * u : y + 1.7720 * u
+	};
+
+	unsigned char c[3];
+
+	for (int i = 0; i < 3; ++i)
+	{
+		c[i] = (unsigned char)lround(fmin(fmax(rgb[i], 0.0), 1.0) * 255.0);
+	}
+
+	return (Color){ c[0], c[1], c[2], 255 };
+}
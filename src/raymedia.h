@@ -40,7 +40,7 @@ typedef struct MediaContext MediaContext;    // Context holding implementation d
 /**
  * Stores video and/or audio data from a movie file.
  * Usage:
- *      1. Initialize with LoadMedia() / LoadMediaEx()
+ *      1. Initialize with LoadMedia() / LoadMediaEx(), or LoadMediaAsync() then FinishMediaLoad()
  *      2. Call UpdateMedia() each frame
  *      3. Access videoTexture and audioStream for playback
  *      4. Free with UnloadMedia()
@@ -48,6 +48,7 @@ typedef struct MediaContext MediaContext;    // Context holding implementation d
 typedef struct MediaStream
 {
     Texture       videoTexture;      // Current video frame texture (if available)
+    Texture       videoPlanes[3];    // Y, U and V plane textures with MEDIA_FLAG_VIDEO_YUV (NV12: Y and UV, as gray + alpha)
     AudioStream   audioStream;       // Audio stream for playback (if available)
     MediaContext* ctx;               // Internal use only
 } MediaStream;
@@ -64,6 +65,102 @@ typedef struct MediaProperties
     bool   hasAudio;                 // True if audio is present
 } MediaProperties;
 
+/**
+ * Holds MediaStream playback counters.
+ * Use GetMediaStats() to retrieve them.
+ */
+typedef struct MediaStats
+{
+    int decodedVideoFrames;          // Video frames decoded since loading
+    int presentedVideoFrames;        // Video frames uploaded to videoTexture
+    int droppedVideoFrames;          // Video frames decoded but skipped, as a later frame was already due
+    int avoidedVideoConversions;     // Dropped video frames whose RGB conversion and upload were skipped (catch-up)
+    int skippedVideoPackets;         // Late non-reference video packets not decoded at all (MEDIA_FLAG_FAST_CATCH_UP)
+    int keyframeJumps;               // Jumps to a keyframe to recover from a large delay (MEDIA_VIDEO_KEYFRAME_JUMP)
+    double videoConvertTime;         // Total time (seconds) spent converting decoded frames to the video format
+    double videoUploadTime;          // Total time (seconds) spent uploading frames to videoTexture
+    int frameBufferAllocations;      // Decoded video frame buffers allocated; stops growing once the buffer pool is warm
+    int indexedKeyframes;            // Entries of the keyframe index, 0 until it is ready (MEDIA_FLAG_KEYFRAME_INDEX)
+    int indexedSeeks;                // Seeks that went straight to a keyframe of the index
+    int seeks;                       // Successful seeks (SetMediaPosition, looping, keyframe jumps)
+    double seekTime;                 // Total time (seconds) spent seeking
+    double lastSeekTime;             // Time (seconds) spent in the last seek
+    int lastSeekDecodedFrames;       // Frames decoded from the keyframe to the target by the last seek (MEDIA_FLAG_ACCURATE_SEEK)
+    int coalescedSeeks;              // SetMediaPositionAsync() requests replaced by a later one before running
+    int gopCacheHits;                // Seeks served by the decoded GOP cache without decoding (MEDIA_VIDEO_GOP_CACHE)
+    int gopCacheMisses;              // Seeks of a paused or stopped media that had to decode
+    double gopCacheHitRate;          // gopCacheHits / (gopCacheHits + gopCacheMisses), 0 before the first lookup
+    int gopCacheFrames;              // Decoded frames held by the cache
+    long long gopCacheMemory;        // Bytes of frame data held by the cache, within the budget
+    int reverseSegments;             // Segments decoded for reverse playback (negative UpdateMediaEx() deltaTime)
+    int reverseDecodedFrames;        // Frames decoded for reverse playback; above the frames played when a GOP exceeds MEDIA_VIDEO_REVERSE_FRAMES
+    int reverseStalls;               // Updates where reverse playback waited for the next segment
+    int forwardSteps;                // Successful StepMediaFrame() calls with a positive frame count
+    int backwardSteps;               // Successful StepMediaFrame() calls with a negative frame count
+    double forwardStepTime;          // Total time (seconds) spent in forward steps (average latency: forwardStepTime / forwardSteps)
+    double backwardStepTime;         // Total time (seconds) spent in backward steps
+    double lastStepTime;             // Time (seconds) spent in the last step
+    double playbackRate;             // Rate set by SetMediaPlaybackRate()
+    double audioDrift;               // Audio position minus media position (seconds), excluding the AudioStream buffer; positive: audio ahead
+    int droppedAudioPackets;         // Late audio packets discarded to catch up with the media position
+    int audioOverflows;              // Decoded audio cut short by a full output buffer (MEDIA_AUDIO_DECODED_BUFFER)
+    int audioUnderruns;              // AudioStream callbacks that ran out of decoded audio and played silence (MEDIA_FLAG_AUDIO_PULL)
+} MediaStats;
+
+/**
+ * Current and peak memory of a MediaMemoryStats category, in bytes.
+ */
+typedef struct MediaMemoryUsage
+{
+    long long current;               // Bytes currently allocated
+    long long peak;                  // Highest value reached by current
+} MediaMemoryUsage;
+
+/**
+ * Holds the memory used by a MediaStream, as tracked by the library allocators.
+ * Use GetMediaMemoryStats() to retrieve it.
+ * @note FFmpeg internals (codec, demuxer and scaler state) have no allocation hooks and are not included.
+ */
+typedef struct MediaMemoryStats
+{
+    MediaMemoryUsage total;          // All the memory below
+    MediaMemoryUsage video;          // Video packet queue and payloads, decoded frame buffers, video image and frame queue
+    MediaMemoryUsage audio;          // Audio packet queue and payloads, decoded audio buffer
+    MediaMemoryUsage shared;         // Media context, file name and custom IO buffer
+    MediaMemoryUsage global;         // All loaded MediaStreams and the shared worker pool
+    int allocations;                 // Tracked allocations since loading (packet payloads included)
+    int updateAllocations;           // Tracked allocations made by UpdateMediaEx() itself, nested calls counted once
+    int workerAllocations;           // Tracked allocations made by background threads (workers, pool jobs, keyframe scan)
+} MediaMemoryStats;
+
+/**
+ * Pixel layouts of a MediaFrame.
+ */
+typedef enum
+{
+    MEDIA_FRAME_RGB24 = 0,           // Single plane, 3 bytes per pixel
+    MEDIA_FRAME_RGBA32,              // Single plane, 4 bytes per pixel (MEDIA_VIDEO_FORMAT)
+    MEDIA_FRAME_YUV420P,             // Y, U and V planes, chroma subsampled 2x2, limited range (MEDIA_FLAG_VIDEO_YUV)
+    MEDIA_FRAME_YUVJ420P,            // Same as MEDIA_FRAME_YUV420P, full range
+    MEDIA_FRAME_NV12                 // Y plane and interleaved UV plane, chroma subsampled 2x2 (MEDIA_FLAG_VIDEO_YUV)
+} MediaFrameFormat;
+
+/**
+ * Video frame borrowed with AcquireMediaFrame(), pointing to the MediaStream buffers (no copy).
+ * Valid until ReleaseMediaFrame().
+ */
+typedef struct MediaFrame
+{
+    const unsigned char* data[4];    // Planes of the frame (planeCount used)
+    int lineSize[4];                 // Size in bytes of a row of each plane
+    int planeCount;                  // Number of planes
+    int width;                       // Width of the frame (in pixels)
+    int height;                      // Height of the frame (in pixels)
+    int format;                      // Pixel layout (refer to MediaFrameFormat)
+    double time;                     // Presentation time of the frame (in seconds)
+    int sequence;                    // Changes with each new frame, to detect frames already processed
+} MediaFrame;
+
 /**
  * Holds the data needed to implement a custom stream reader.
  * Used to define custom read and seek behaviors for media input streams.
@@ -75,6 +172,15 @@ typedef struct MediaStreamReader
     void* userData; // Pointer to user-defined context, passed to the callback functions
 } MediaStreamReader;
 
+/**
+ * Callback receiving decoded audio, set with SetMediaAudioCallback().
+ * Called from UpdateMedia() / UpdateMediaEx(), on the calling thread.
+ * @param userData Pointer given to SetMediaAudioCallback()
+ * @param data Interleaved PCM frames in the MEDIA_AUDIO_FORMAT and MEDIA_AUDIO_CHANNELS of the media
+ * @param frameCount Number of frames in data (one sample per channel each)
+ */
+typedef void (*MediaAudioCallback)(void* userData, const void* data, int frameCount);
+
 
 //--------------------------------------------------------------------------------------------------
 // Enumerators Definition
@@ -85,11 +191,23 @@ typedef struct MediaStreamReader
  */
 typedef enum
 {
-    MEDIA_LOAD_AV           = 0,      // Load audio and video (default)
-    MEDIA_LOAD_NO_AUDIO     = 1 << 1, // Do not load audio
-    MEDIA_LOAD_NO_VIDEO     = 1 << 2, // Do not load video
-    MEDIA_FLAG_LOOP         = 1 << 3, // Loop playback
-    MEDIA_FLAG_NO_AUTOPLAY  = 1 << 4  // Load without starting playback
+    MEDIA_LOAD_AV                   = 0,       // Load audio and video (default)
+    MEDIA_LOAD_NO_AUDIO             = 1 << 1,  // Do not load audio
+    MEDIA_LOAD_NO_VIDEO             = 1 << 2,  // Do not load video
+    MEDIA_FLAG_LOOP                 = 1 << 3,  // Loop playback
+    MEDIA_FLAG_NO_AUTOPLAY          = 1 << 4,  // Load without starting playback
+    MEDIA_FLAG_THREADED_DEMUX       = 1 << 5,  // Read packets on a background thread, ahead of the playback position
+    MEDIA_FLAG_THREADED_DECODE      = 1 << 6,  // Decode and convert video frames on a background thread (implies MEDIA_FLAG_THREADED_DEMUX)
+    MEDIA_FLAG_DECODE_SINGLE_THREAD = 1 << 7,  // Decode video on a single thread, ignoring MEDIA_DECODE_THREADS
+    MEDIA_FLAG_DECODE_FRAME_THREADS = 1 << 8,  // Decode video with frame threading, overriding MEDIA_DECODE_THREAD_TYPE
+    MEDIA_FLAG_DECODE_SLICE_THREADS = 1 << 9,  // Decode video with slice threading, overriding MEDIA_DECODE_THREAD_TYPE
+    MEDIA_FLAG_FAST_CATCH_UP        = 1 << 10, // Lower the video decoding quality while playback lags behind (frames decoded on the calling thread only)
+    MEDIA_LOAD_HEADLESS             = 1 << 11, // No texture nor AudioStream: video goes to GetMediaImage(), audio to SetMediaAudioCallback()
+    MEDIA_FLAG_VIDEO_YUV            = 1 << 12, // Upload the video as YUV plane textures (videoPlanes) converted to RGB by a shader, see DrawMediaVideo()
+    MEDIA_FLAG_KEYFRAME_INDEX       = 1 << 13, // Seek through a video keyframe index, built in the background if the container index is incomplete
+    MEDIA_FLAG_KEYFRAME_INDEX_CACHE = 1 << 14, // Also keep a built index in a '<file>.kfidx' cache file, memory-mapped on the next load (implies MEDIA_FLAG_KEYFRAME_INDEX)
+    MEDIA_FLAG_ACCURATE_SEEK        = 1 << 15, // SetMediaPosition() lands on the exact frame, decoding from the keyframe without converting the frames in between
+    MEDIA_FLAG_AUDIO_PULL           = 1 << 16  // The AudioStream callback pulls the decoded audio on the audio thread, independently of the update rate (up to 8 media at once)
 } MediaLoadFlag;
 
 /**
@@ -115,12 +233,24 @@ typedef enum
     MEDIA_VIDEO_QUEUE,                // Video packet queue capacity
     MEDIA_AUDIO_QUEUE,                // Audio packet queue capacity
     MEDIA_AUDIO_DECODED_BUFFER,       // Maximum decoded audio buffer size
-    MEDIA_AUDIO_STREAM_BUFFER,        // Audio stream buffer size
+    MEDIA_AUDIO_STREAM_BUFFER,        // Audio stream buffer size (smaller sizes lower the latency with MEDIA_FLAG_AUDIO_PULL)
     MEDIA_AUDIO_FORMAT,               // Output audio format (refer to MediaAudioFormat)
     MEDIA_AUDIO_CHANNELS,             // Number of audio channels
     MEDIA_VIDEO_MAX_DELAY,            // Maximum delay (ms) before discarding a video packet
     MEDIA_AUDIO_MAX_DELAY,            // Maximum delay (ms) before discarding an audio packet
-    MEDIA_AUDIO_UPDATE                // Max bytes uploaded to AudioStream per frame
+    MEDIA_AUDIO_UPDATE,               // Max bytes uploaded to AudioStream per frame
+    MEDIA_VIDEO_FRAME_QUEUE,          // Decoded video frame queue capacity (MEDIA_FLAG_THREADED_DECODE only)
+    MEDIA_WORKER_THREADS,             // Threads of the shared worker pool running background work (0: one thread per worker)
+    MEDIA_DECODE_THREADS,             // Threads used by the video decoder (0: auto-detect, default: 1)
+    MEDIA_DECODE_THREAD_TYPE,         // Video decoder threading method (refer to MediaDecodeThreadType)
+    MEDIA_VIDEO_CONVERT_BANDS,        // Horizontal bands converted in parallel per video frame (0: one per core, default: 1)
+    MEDIA_VIDEO_KEYFRAME_JUMP,        // Video delay (ms) beyond which playback jumps to the last keyframe before the current position (0: disabled)
+    MEDIA_VIDEO_FAST_CONVERT,         // Use the built-in SIMD converters for BT.601/BT.709 YUV420P/NV12 video instead of swscale (0: disabled, default: 1)
+    MEDIA_VIDEO_FORMAT,               // PixelFormat of videoTexture: PIXELFORMAT_UNCOMPRESSED_R8G8B8 (default) or R8G8B8A8 (4-byte aligned rows)
+    MEDIA_VIDEO_OUTPUT_WIDTH,         // Width of videoTexture, the video is scaled while converted (0: source width or aspect ratio, default)
+    MEDIA_VIDEO_OUTPUT_HEIGHT,        // Height of videoTexture, the video is scaled while converted (0: source height or aspect ratio, default)
+    MEDIA_VIDEO_GOP_CACHE,            // Memory budget (MB) of the decoded GOP cache serving the seeks of paused or stopped media (0: disabled, default)
+    MEDIA_VIDEO_REVERSE_FRAMES        // Decoded frames held per reverse playback segment, two segments are held (default: 64)
 } MediaConfigFlag;
 
 /**
@@ -138,6 +268,24 @@ typedef enum
     AUDIO_FMT_DBL = 4                 // Double
 } MediaAudioFormat;
 
+/**
+ * Threading methods of the video decoder, combined as bit flags.
+ * Configured using SetMediaFlag(MEDIA_DECODE_THREAD_TYPE, MEDIA_DECODE_THREAD_*),
+ * or per MediaStream with MEDIA_FLAG_DECODE_FRAME_THREADS / MEDIA_FLAG_DECODE_SLICE_THREADS.
+ * @note Only effective when MEDIA_DECODE_THREADS is not 1. The codec picks the method it supports.
+ * - Frame threading decodes several frames at once and scales best, but each thread adds one frame
+ *   of decoder delay: frames come out (threads - 1) packets after the packet that produced them, so
+ *   synchronous playback shows video later than its packet timestamps (keep MEDIA_VIDEO_MAX_DELAY
+ *   above that latency or late packets are dropped), and seeking has to decode more frames.
+ * - Slice threading splits each frame across threads with no added delay, but only helps streams
+ *   encoded with several slices per frame.
+ */
+typedef enum
+{
+    MEDIA_DECODE_THREAD_FRAME = 1,    // Decode several frames in parallel (matches FF_THREAD_FRAME)
+    MEDIA_DECODE_THREAD_SLICE = 2     // Decode the slices of a frame in parallel (matches FF_THREAD_SLICE)
+} MediaDecodeThreadType;
+
 /**
  * Status values for MediaStreamReader callback functions.
  * These values indicate the outcome of custom IO operations.
@@ -182,6 +330,42 @@ extern "C" {
      */
     RLAPI MediaStream LoadMediaFromStream(MediaStreamReader streamReader, int flags);
 
+    /**
+     * Start loading a MediaStream from a file in the background.
+     * Opening the file and the codecs runs on the shared worker pool; call FinishMediaLoad()
+     * from the main thread to create the texture and the AudioStream once IsMediaLoaded() is true.
+     * @note Do not change media flags (SetMediaFlag) while loads are in progress.
+     * @param fileName Path to the movie file
+     * @param flags Combination of MediaLoadFlag values
+     * @return Pending MediaStream (not valid until FinishMediaLoad()); empty structure on failure
+     */
+    RLAPI MediaStream LoadMediaAsync(const char* fileName, int flags);
+
+    /**
+     * Start loading several MediaStreams in the background, in parallel.
+     * @param fileNames Array of count paths to movie files
+     * @param count Number of files to load
+     * @param flags Combination of MediaLoadFlag values, applied to every file
+     * @param medias Array of count MediaStreams receiving the pending loads (see LoadMediaAsync())
+     * @return Number of loads started
+     */
+    RLAPI int LoadMediaAsyncBatch(const char** fileNames, int count, int flags, MediaStream* medias);
+
+    /**
+     * Check if the background part of an asynchronous load is done (non-blocking).
+     * @param media MediaStream returned by LoadMediaAsync(), or any loaded MediaStream
+     * @return true if FinishMediaLoad() can be called without blocking
+     */
+    RLAPI bool IsMediaLoaded(MediaStream media);
+
+    /**
+     * Complete an asynchronous load on the main thread, waiting for the background part if needed.
+     * On failure the media is unloaded and emptied. Calling it on a completed load has no effect.
+     * @param media Pointer to a MediaStream returned by LoadMediaAsync()
+     * @return true if the media is valid
+     */
+    RLAPI bool FinishMediaLoad(MediaStream* media);
+
     /**
      * Check if a MediaStream is valid (loaded and initialized).
      * @param media MediaStream structure
@@ -196,8 +380,23 @@ extern "C" {
      */
     RLAPI MediaProperties GetMediaProperties(MediaStream media);
 
+    /**
+     * Retrieve playback counters of the loaded media.
+     * @param media A valid MediaStream
+     * @return Filled MediaStats structure on success; empty structure on failure
+     */
+    RLAPI MediaStats GetMediaStats(MediaStream media);
+
+    /**
+     * Retrieve the memory used by the loaded media.
+     * @param media A valid MediaStream
+     * @return Filled MediaMemoryStats structure on success; only the global usage on failure
+     */
+    RLAPI MediaMemoryStats GetMediaMemoryStats(MediaStream media);
+
     /**
      * Update a MediaStream.
+     * @note Uses GetFrameTime(), which requires a window: MEDIA_LOAD_HEADLESS streams should use UpdateMediaEx()
      * @param media Pointer to a valid MediaStream
      * @return true on success; false otherwise
      */
@@ -205,8 +404,11 @@ extern "C" {
 
     /**
      * Update a MediaStream with a specified deltaTime.
+     * A negative deltaTime plays the video backwards, without audio: GOP segments are decoded on the shared
+     * worker pool and presented in reverse (see MEDIA_VIDEO_REVERSE_FRAMES). The first frame stays displayed once
+     * the start is reached. A positive deltaTime seeks back to the displayed frame and resumes normal playback.
      * @param media Pointer to a valid MediaStream
-     * @param deltaTime Time in seconds since the last update
+     * @param deltaTime Time in seconds since the last update (negative: reverse), multiplied by the playback rate
      * @return true on success; false otherwise
      */
     RLAPI bool UpdateMediaEx(MediaStream* media, double deltaTime);
@@ -241,6 +443,37 @@ extern "C" {
      */
     RLAPI bool SetMediaPosition(MediaStream media, double timeSec);
 
+    /**
+     * Set the playback position of a MediaStream without blocking, e.g. while scrubbing.
+     * The seek runs on the shared worker pool and completes in a later UpdateMedia(); meanwhile the previous
+     * frame stays displayed and GetMediaPosition() returns the requested position.
+     * Requests made while a seek is running are coalesced: only the latest one is executed.
+     * Falls back to SetMediaPosition() if the worker pool is unavailable.
+     * @param media A valid MediaStream
+     * @param timeSec Desired position in seconds
+     * @return true if the seek was started or queued; false otherwise
+     */
+    RLAPI bool SetMediaPositionAsync(MediaStream media, double timeSec);
+
+    /**
+     * Check if a seek started by SetMediaPositionAsync() is still running or waiting to be presented.
+     * @param media A MediaStream
+     * @return true while the new position is not displayed yet
+     */
+    RLAPI bool IsMediaSeekPending(MediaStream media);
+
+    /**
+     * Step through the video frame by frame, e.g. while the media is paused.
+     * The position lands on the presentation time of the new frame, no deltaTime is involved.
+     * Forward steps continue from the decoder state; backward steps seek just before the displayed frame,
+     * served by the GOP cache (MEDIA_VIDEO_GOP_CACHE) or decoded from the previous keyframe.
+     * Decoded audio is dropped; playback resumes from the new frame.
+     * @param media A valid MediaStream with a video stream
+     * @param frames Number of frames to step: positive forward, negative backward
+     * @return true on success; false at the start or the end of the video, or on failure
+     */
+    RLAPI bool StepMediaFrame(MediaStream media, int frames);
+
     /**
      * Enable or disable loop playback for a MediaStream.
      * @param media A valid MediaStream
@@ -249,6 +482,100 @@ extern "C" {
      */
     RLAPI bool SetMediaLooping(MediaStream media, bool loopPlay);
 
+    /**
+     * Set the playback rate of a MediaStream, e.g. 0.5 for half speed.
+     * The media time advances by deltaTime * rate in UpdateMediaEx(). The audio is time-stretched to keep its
+     * pitch and stay in sync: the first rate other than 1 allocates the stretcher, which adds a few tens of
+     * milliseconds of latency while the rate isn't 1. At 1x the audio bypasses it.
+     * @param media A valid MediaStream
+     * @param rate Playback rate, clamped to [0.5, 2.0]
+     * @return true on success; false otherwise (invalid media or non-finite rate)
+     */
+    RLAPI bool SetMediaPlaybackRate(MediaStream media, double rate);
+
+    /**
+     * Get the playback rate of a MediaStream.
+     * @param media A valid MediaStream
+     * @return Playback rate (1.0 by default); negative on failure
+     */
+    RLAPI double GetMediaPlaybackRate(MediaStream media);
+
+    /**
+     * Get the CPU image holding the latest decoded video frame.
+     * Mainly meant for MEDIA_LOAD_HEADLESS streams, which have no videoTexture.
+     * With MEDIA_FLAG_VIDEO_YUV, a grayscale image of the luma plane, followed in memory by the packed chroma planes.
+     * @param media A valid MediaStream
+     * @return Image owned by the media (do not unload), updated by UpdateMedia(); empty image on failure
+     */
+    RLAPI Image GetMediaImage(MediaStream media);
+
+    /**
+     * Change the size of the video output (videoTexture and GetMediaImage()) of a loaded MediaStream.
+     * Frames are scaled while converted, so smaller sizes also reduce conversion and upload costs.
+     * videoTexture is recreated: references to the previous texture (e.g. in materials) must be updated.
+     * @param media A valid MediaStream with video
+     * @param width Output width; 0 follows the aspect ratio of the video (0 for both restores the source size)
+     * @param height Output height; 0 follows the aspect ratio of the video
+     * @return true on success; false otherwise
+     */
+    RLAPI bool SetMediaOutputSize(MediaStream* media, int width, int height);
+
+    /**
+     * Borrow the current video frame without copying it, e.g. for CPU processing.
+     * While a frame is borrowed, UpdateMedia() keeps it and defers newer frames: release it as soon as possible.
+     * Can be called from any thread, as long as the media is not unloaded meanwhile.
+     * @param media A valid MediaStream with video
+     * @param frame Receives the frame planes, their row sizes and the frame time
+     * @return true on success (release with ReleaseMediaFrame()); false otherwise
+     */
+    RLAPI bool AcquireMediaFrame(MediaStream media, MediaFrame* frame);
+
+    /**
+     * Give back a frame borrowed with AcquireMediaFrame(). The frame is cleared.
+     * @param media The MediaStream the frame was acquired from
+     * @param frame The borrowed frame
+     */
+    RLAPI void ReleaseMediaFrame(MediaStream media, MediaFrame* frame);
+
+    /**
+     * Enable or disable the upload of video frames to the textures (enabled by default).
+     * Without upload, frames are only available to AcquireMediaFrame() and GetMediaImage().
+     * @param media A valid MediaStream
+     * @param upload false to stop updating the video textures
+     * @return true on success; false otherwise
+     */
+    RLAPI bool SetMediaTextureUpload(MediaStream media, bool upload);
+
+    /**
+     * Draw the current video frame, whatever the video output mode.
+     * MEDIA_FLAG_VIDEO_YUV streams are converted to RGB while drawn, using GetMediaVideoShader().
+     * @param media A valid MediaStream with video
+     * @param source Part of the frame to draw, in output pixels
+     * @param dest Destination rectangle on screen
+     * @param tint Color multiplied with the video
+     */
+    RLAPI void DrawMediaVideo(MediaStream media, Rectangle source, Rectangle dest, Color tint);
+
+    /**
+     * Get the shader converting the planes of a MEDIA_FLAG_VIDEO_YUV stream to RGB, e.g. to use them in a material.
+     * The planes are sampled from texture0, texture1 and texture2 (albedo, metalness and normal maps of a material).
+     * The shader is shared by all media: call again before drawing another media, to set its color uniforms.
+     * @param media A valid MediaStream loaded with MEDIA_FLAG_VIDEO_YUV
+     * @return Shader owned by the library (do not unload); empty shader on failure
+     */
+    RLAPI Shader GetMediaVideoShader(MediaStream media);
+
+    /**
+     * Deliver decoded audio to a callback instead of the AudioStream.
+     * With MEDIA_LOAD_HEADLESS and no callback, decoded audio is discarded.
+     * Not available for media loaded with MEDIA_FLAG_AUDIO_PULL, whose audio is read by the AudioStream callback.
+     * @param media A valid MediaStream
+     * @param callback Function receiving the decoded audio; NULL restores the AudioStream output
+     * @param userData Pointer passed to the callback
+     * @return true on success; false otherwise
+     */
+    RLAPI bool SetMediaAudioCallback(MediaStream media, MediaAudioCallback callback, void* userData);
+
     /**
      * Set a global configuration property.
      * @param flag One of MediaConfigFlag values
@@ -26,15 +26,56 @@
 //---------------------------------------------------------------------------------------------------
 
 #include <assert.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <raymedia.h>
+#include <rlgl.h>
 
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
+#include <libavutil/cpu.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/time.h>
 #include <libswresample/swresample.h>
 #include <libswscale/swscale.h>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+	#define MEDIA_SIMD_X86
+	#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+	#define MEDIA_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+// Threads: POSIX threads (MinGW ships winpthreads), or the subset used here mapped to Win32 on MSVC
+#if defined(_MSC_VER)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#define NOGDI   // Rectangle
+	#define NOUSER  // CloseWindow, ShowCursor, LoadImage, DrawText...
+	#include <windows.h>
+	#include <process.h>
+	#undef near     // Parameter names in raylib
+	#undef far
+#else
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+// Memory-mapped keyframe index cache (see LoadKeyframeIndexCache)
+#if !defined(_WIN32)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 //---------------------------------------------------------------------------------------------------
 // Defines and Macros
 //---------------------------------------------------------------------------------------------------
@@ -49,12 +90,73 @@
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 #endif
 
+#define MEDIA_POOL_MAX_THREADS    256						// Maximum number of threads in the shared worker pool
+#define MEDIA_CONVERT_MIN_BAND    64						// Minimum height (in rows) of a conversion band when the band count is automatic
+#define MEDIA_FRAME_ALIGN         64						// Row alignment (in bytes) of the decoded video frame buffers
+#define MEDIA_MEMORY_HEADER_SIZE  16						// Room for a MemoryHeader in front of a tracked block, keeping the malloc alignment
+#define MEDIA_INDEX_END_MARGIN    5.0						// A container index ending more than this (seconds) before the stream end is incomplete
+#define MEDIA_INDEX_FILE_EXT      ".kfidx"					// Extension appended to the media file name for the keyframe index cache
+#define MEDIA_INDEX_FILE_MAGIC    "RMKFIDX1"				// First bytes of a keyframe index cache; the digit is the format version
+#define MEDIA_GOP_CACHE_MAX_GOPS  32						// Maximum number of GOPs held by the decoded GOP cache
+#define MEDIA_REVERSE_START_MARGIN 0.001					// Reverse playback starts with the frames up to this far (seconds) after the position
+#define MEDIA_PLAYBACK_RATE_MIN   0.5						// Lowest rate accepted by SetMediaPlaybackRate
+#define MEDIA_PLAYBACK_RATE_MAX   2.0						// Highest rate accepted by SetMediaPlaybackRate
+#define MEDIA_STRETCH_WINDOW_MS   30						// Length (in milliseconds) of the segments overlapped by the audio time-stretcher
+#define MEDIA_STRETCH_SEARCH_MS   10						// Maximum shift (in milliseconds) of a segment from its nominal position
+#define MEDIA_STRETCH_SEARCH_STEP 4							// Frames between the positions of the coarse search, refined around the best one
+#define MEDIA_STRETCH_CHUNK       1024						// Frames converted by swr_convert per call before stretching
+#define MEDIA_AUDIO_PULL_SLOTS    8							// Maximum number of MediaStreams pulling their audio at once (MEDIA_FLAG_AUDIO_PULL)
+
+// Thread-local storage class
+#if defined(_MSC_VER)
+	#define MEDIA_THREAD_LOCAL __declspec(thread)
+#else
+	#define MEDIA_THREAD_LOCAL __thread
+#endif
+
+#if defined(_MSC_VER)
+	typedef HANDLE pthread_t;
+	typedef SRWLOCK pthread_mutex_t;
+	typedef CONDITION_VARIABLE pthread_cond_t;
+	typedef INIT_ONCE pthread_once_t;
+
+	#define PTHREAD_MUTEX_INITIALIZER SRWLOCK_INIT
+	#define PTHREAD_COND_INITIALIZER  CONDITION_VARIABLE_INIT
+	#define PTHREAD_ONCE_INIT         INIT_ONCE_STATIC_INIT
+
+	#define pthread_create         MediaThreadCreate
+	#define pthread_join           MediaThreadJoin
+	#define pthread_mutex_init     MediaMutexInit
+	#define pthread_mutex_destroy  MediaMutexDestroy
+	#define pthread_mutex_lock     MediaMutexLock
+	#define pthread_mutex_unlock   MediaMutexUnlock
+	#define pthread_cond_init      MediaCondInit
+	#define pthread_cond_destroy   MediaCondDestroy
+	#define pthread_cond_wait      MediaCondWait
+	#define pthread_cond_signal    MediaCondSignal
+	#define pthread_cond_broadcast MediaCondBroadcast
+	#define pthread_once           MediaCallOnce
+	#define sched_yield            MediaThreadYield
+#endif
+
+// Enables an instruction set for a single function, so SIMD kernels build without global compiler flags
+#if defined(__GNUC__) || defined(__clang__)
+	#define MEDIA_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define MEDIA_TARGET(isa)
+#endif
+
+// Fixed point (6-bit) YUV to RGB conversion, see YUV_COEFFICIENTS
+#define YUV_SHIFT    6
+#define YUV_ROUND    (1 << (YUV_SHIFT - 1))
+
 #if defined(RAYLIB_VERSION_MAJOR) && defined(RAYLIB_VERSION_MINOR)
 // Compatibility check for Raylib versions older than 5.5
 #if (RAYLIB_VERSION_MAJOR < 5) || (RAYLIB_VERSION_MAJOR == 5 && RAYLIB_VERSION_MINOR < 5)
 	#define IsImageValid IsImageReady
 	#define IsTextureValid IsTextureReady
 	#define IsAudioStreamValid IsAudioStreamReady
+	#define IsShaderValid IsShaderReady
 #endif
 #else
 	#error "RAYLIB_VERSION_MAJOR and RAYLIB_VERSION_MINOR must be defined"
@@ -87,12 +189,55 @@ enum
 	MEDIA_ERR_CODEC_ALLOC_FAILED,							// Codec context allocation failure
 	MEDIA_ERR_CTX_PARAMS_FAILED,							// Failed to copy codec parameters
 	MEDIA_ERR_CODEC_OPEN_FAILED,							// Codec initialization failure
+	MEDIA_ERR_DECODE_VIDEO,									// Error decoding video
 
 
 	// Success and EOF return codes -----------------------------------------------------------------
 
 	MEDIA_RET_SUCCEED = 0,									// Operation successful
-	MEDIA_EOF = 1											// End of file (stream) reached
+	MEDIA_EOF = 1,											// End of file (stream) reached
+	MEDIA_RET_WAIT = 2										// Data not available yet (produced by a background worker)
+};
+
+// Results of a background worker step
+enum
+{
+	WORKER_IDLE = 0,										// Nothing could be done (e.g. the destination queue is full)
+	WORKER_PROGRESS = 1										// Some work was done, the step can run again right away
+};
+
+// Progress of an asynchronous load (see LoadMediaAsync)
+enum
+{
+	LOAD_STATUS_DONE = 0,									// Background part done (or synchronous load)
+	LOAD_STATUS_PENDING,									// The load job is queued or running
+	LOAD_STATUS_FAILED										// The load job failed, FinishMediaLoad() unloads the media
+};
+
+// Availability of the keyframe index (see KeyframeIndex)
+enum
+{
+	INDEX_STATUS_NONE = 0,									// No index: seeks rely on the demuxer
+	INDEX_STATUS_PENDING,									// The scan thread is running
+	INDEX_STATUS_READY,										// The index can be used
+	INDEX_STATUS_FAILED										// The scan failed or was aborted
+};
+
+// Progress of an asynchronous seek (see SetMediaPositionAsync)
+enum
+{
+	SEEK_STATUS_IDLE = 0,									// No seek in progress
+	SEEK_STATUS_PENDING,									// The seek job is queued or running
+	SEEK_STATUS_DONE										// The seek job is done, PollMediaSeek() presents its frame
+};
+
+// Scheduling states of a worker running on the shared pool
+enum
+{
+	WORKER_STATE_IDLE = 0,									// Not scheduled, waiting for WakeWorker()
+	WORKER_STATE_QUEUED,									// Waiting in a pool queue
+	WORKER_STATE_RUNNING,									// A pool thread is running its step
+	WORKER_STATE_RERUN										// Woken while running: schedule it again once the step returns
 };
 
 
@@ -100,11 +245,31 @@ enum
 // Types and Structures Definition
 //---------------------------------------------------------------------------------------------------
 
+// Memory accounting (see GetMediaMemoryStats)
+// - A usage also counts in its parent (stream -> media -> global), so totals are available without summing.
+typedef struct MemoryUsage
+{
+	atomic_llong current;           // Bytes currently allocated
+	atomic_llong peak;              // Highest value reached by current
+	atomic_int allocations;         // Allocations counted since initialization
+	atomic_int workerAllocations;   // Part of allocations made on background threads (see WORKER_THREAD)
+	struct MemoryUsage* parent;     // Usage including this one, NULL for the global usage
+} MemoryUsage;
+
+// Stored in front of each block of the tracked allocators (MediaMalloc, MediaAlignedMalloc)
+typedef struct MemoryHeader
+{
+	MemoryUsage* usage;             // Usage the block is accounted in (may be NULL)
+	size_t size;                    // Size requested by the caller
+} MemoryHeader;
+
 // Circular buffer logic
+// - Single-producer/single-consumer: only the writer advances writePos and only the reader advances readPos,
+//   so one thread may fill the buffer while another one drains it without any locking.
 typedef struct BufferState
 {
-	int readPos;					// Read position index
-	int writePos;					// Write position index
+	atomic_int readPos;				// Read position index (advanced by the consumer only)
+	atomic_int writePos;			// Write position index (advanced by the producer only)
 	int capacity;					// Capacity of the circular buffer
 } BufferState;
 
@@ -118,6 +283,7 @@ typedef struct PacketQueue
 {
 	AVPacket** packets;             // Pointer to the circular buffer queue for AVPackets
 	BufferState state;              // Current state of the circular buffer
+	MemoryUsage* memory;            // Usage accounting the payloads of the queued packets (may be NULL)
 } PacketQueue;
 
 // Buffer structure
@@ -131,6 +297,22 @@ typedef struct Buffer
 	BufferState state;              // Current state of the circular buffer
 } Buffer;
 
+// Decoded video frame, converted and ready to be uploaded to [MediaStream].videoTexture
+typedef struct VideoFrame
+{
+	uint8_t* data;                  // Converted pixels, same layout as [MediaContext].videoOutputImage
+	double time;                    // Presentation time in seconds, relative to the start of the stream
+} VideoFrame;
+
+// Queue of decoded video frames, filled by the decode worker and drained by UpdateMediaEx().
+// - Only used with MEDIA_FLAG_THREADED_DECODE.
+// - To customize capacity, use SetMediaFlag(MEDIA_VIDEO_FRAME_QUEUE, [frameQueueCapacity]).
+typedef struct FrameQueue
+{
+	VideoFrame* frames;             // Pointer to the circular buffer of frames
+	BufferState state;              // Current state of the circular buffer
+} FrameQueue;
+
 // Library configuration structure 
 // - To set a property, use SetMediaFlag([MediaLoadFlag], [value]).
 // - To get a property, use GetMediaFlag([MediaLoadFlag]).
@@ -149,8 +331,136 @@ typedef struct MediaConfig
 
 	int audioMaxUpdateSize;					// Maximum number of bytes to be uploaded to the AudioStream in a frame
 	int audioStreamBufferSize;				// Size of the AudioStream buffer
+	int videoFrameQueueSize;				// Maximum number of video frames decoded ahead (threaded decoding only)
+	int workerThreads;						// Threads of the shared worker pool; 0 runs each background worker on its own thread
+	int decodeThreads;						// Threads of the video decoder (AVCodecContext.thread_count); 0 lets FFmpeg choose
+	int decodeThreadType;					// Threading methods allowed to the video decoder (MediaDecodeThreadType flags)
+	int videoConvertBands;					// Bands converted in parallel per video frame; 0 picks one per core
+	double keyframeJumpDelay;				// Video delay (seconds) beyond which playback jumps to a keyframe; 0 disables it
+	bool videoFastConvert;					// Convert YUV420P/NV12 video with the built-in SIMD kernels instead of swscale
+	int videoFormat;						// PixelFormat of the video texture: PIXELFORMAT_UNCOMPRESSED_R8G8B8 or R8G8B8A8
+	int videoOutputWidth;					// Width of the video texture; 0 follows the source (or the aspect ratio)
+	int videoOutputHeight;					// Height of the video texture; 0 follows the source (or the aspect ratio)
+	int gopCacheSize;						// Memory budget (MB) of the decoded GOP cache; 0 disables it
+	int reverseFrames;						// Decoded frames per reverse playback segment (two segments are held)
 } MediaConfig;
 
+// Video keyframe location
+typedef struct KeyframeEntry
+{
+	int64_t pts;                    // Presentation timestamp, in the video stream time base
+	int64_t pos;                    // Byte offset of the keyframe packet in the file, -1 if unknown
+} KeyframeEntry;
+
+// Keyframe index of the video stream (MEDIA_FLAG_KEYFRAME_INDEX), sorted by pts.
+// - Copied from the container index if it covers the whole stream. Otherwise, built by a pool job scanning the
+//   file with its own AVFormatContext while the media plays (file names only, not custom streams).
+// - With MEDIA_FLAG_KEYFRAME_INDEX_CACHE, a scanned index is saved next to the media file and memory-mapped
+//   on the next load, provided that the file size and modification time still match.
+typedef struct KeyframeIndex
+{
+	const KeyframeEntry* entries;   // Keyframes, sorted by pts
+	int count;                      // Number of entries
+	void* data;                     // Memory holding the entries: MediaMalloc block or mapped cache file
+	size_t dataSize;                // Size of data
+	bool mapped;                    // data is a memory-mapped cache file
+	bool byteSeek;                  // Seek by byte position (scanned index), otherwise by timestamp (container index)
+} KeyframeIndex;
+
+// Header of a keyframe index cache file, followed by [count] KeyframeEntry (native byte order)
+typedef struct KeyframeIndexHeader
+{
+	char magic[8];                  // MEDIA_INDEX_FILE_MAGIC
+	int64_t fileSize;               // Size of the media file
+	int64_t fileTime;               // Modification time of the media file
+	int32_t streamIdx;              // Index of the video stream
+	int32_t timeBaseNum;            // Time base of the entry timestamps
+	int32_t timeBaseDen;
+	int32_t count;                  // Number of entries
+} KeyframeIndexHeader;
+
+// Decoded video frame held by the GOP cache
+typedef struct CachedFrame
+{
+	AVFrame* frame;                 // Reference to the decoded frame, keeping its buffer out of the frame pool
+	double time;                    // Presentation time in seconds
+} CachedFrame;
+
+// Decoded frames of a GOP, without holes from its keyframe
+typedef struct CachedGop
+{
+	CachedFrame* frames;            // Frames in presentation order, frames[0] is the keyframe
+	int count;                      // Number of frames
+	int capacity;                   // Size of the frames array
+	double endTime;                 // The frames cover [frames[0].time, endTime): next keyframe time once complete, last frame time before
+	long long memory;               // Bytes of frame data referenced
+	int64_t lastUse;                // GopCache clock of the last insertion or hit (LRU eviction)
+} CachedGop;
+
+// Bounded cache of the recently decoded GOPs (MEDIA_VIDEO_GOP_CACHE), serving the seeks made while the media is
+// paused or stopped without decoding anything. The decoder is brought to the new position once playback resumes.
+// Only used by the thread decoding the video: seeks stop the background workers before looking it up.
+typedef struct GopCache
+{
+	CachedGop gops[MEDIA_GOP_CACHE_MAX_GOPS];
+	int count;                      // GOPs in use
+	int current;                    // GOP receiving the decoded frames, -1 until the next keyframe (e.g. after a seek)
+	long long budget;               // Maximum bytes of frame data, 0 if the cache is disabled
+	int64_t clock;                  // Incremented on every insertion or hit
+	atomic_llong memory;            // Bytes of frame data referenced
+	atomic_int frames;              // Frames held
+	atomic_int hits;                // Seeks served by the cache
+	atomic_int misses;              // Seeks that had to decode
+} GopCache;
+
+// Decoded video frames of a reverse playback segment, in presentation order
+typedef struct ReverseSegment
+{
+	CachedFrame* frames;            // Frames before endTime; the AVFrames are allocated once, then reused
+	int count;                      // Frames decoded
+	int capacity;                   // Maximum number of frames (MEDIA_VIDEO_REVERSE_FRAMES)
+	double endTime;                 // The segment holds the last frames decoded before this time (seconds)
+} ReverseSegment;
+
+typedef float (*DotProductKernel)(const float* a, const float* b, int count);
+
+// MediaStream whose AudioStream callback pulls the decoded audio on the audio thread (MEDIA_FLAG_AUDIO_PULL).
+// raylib callbacks have no user pointer: each slot has its own callback (see GetAudioPullCallback).
+// The main thread writes audioOutputBuffer while the callback reads it; anything else the main thread does to the
+// buffer (clearing it) happens between LockAudioPull and UnlockAudioPull.
+typedef struct AudioPullSlot
+{
+	_Atomic(struct MediaContext*) ctx;  // Media fed by the slot, NULL if the slot is free
+	atomic_bool busy;                   // Set while the callback uses ctx
+	atomic_bool locked;                 // Set by the main thread to keep the callback away from ctx (silence is output)
+	int bytesPerFrame;                  // Size of an audio frame of the AudioStream
+	uint8_t silence;                    // Byte value of a silent sample (0x80 for unsigned 8-bit samples)
+} AudioPullSlot;
+
+// Audio time-stretcher (WSOLA) keeping the pitch at playback rates other than 1: segments of windowFrames are read
+// every hopFrames * rate input frames and overlap-added every hopFrames output frames with a Hann window. Each
+// segment is shifted by up to searchFrames to best match the continuation of the previous one, which keeps the
+// waveform continuous. Works on interleaved float samples; main thread only, like the rest of the audio output.
+typedef struct TimeStretch
+{
+	float* input;                   // Converted samples not consumed yet (interleaved), input[0] is the oldest frame kept
+	int inputFrames;                // Frames in input
+	int inputCapacity;              // Size of input, in frames
+	float* window;                  // Hann window of windowFrames
+	float* overlap;                 // Windowed second half of the previous segment (hopFrames frames)
+	float* output;                  // Frames produced by the last RunTimeStretch (hopFrames frames)
+	uint8_t* scratch;               // swr_convert output in the audio output format, before its conversion to float
+	int scratchFrames;              // Size of scratch, in frames (MEDIA_STRETCH_CHUNK)
+	int channels;                   // Interleaved channels
+	int windowFrames;               // Segment length (MEDIA_STRETCH_WINDOW_MS), twice hopFrames
+	int hopFrames;                  // Output frames per segment
+	int searchFrames;               // Maximum shift of a segment from its nominal position (MEDIA_STRETCH_SEARCH_MS)
+	double readPos;                 // Nominal position (in input frames) of the next segment
+	int naturalPos;                 // Frame following the overlap of the previous segment, matched by the next one; -1 if none
+	double rate;                    // Input frames consumed per output frame
+	DotProductKernel dotProduct;    // Correlation kernel of the search (see GetDotProductKernel)
+} TimeStretch;
+
 // Audio/Video stream context data
 typedef struct StreamDataContext
 {
@@ -158,8 +468,124 @@ typedef struct StreamDataContext
 	PacketQueue pendingPackets;     // Queue of pending packets, enqueued if they cannot be used immediately
 	int streamIdx;                  // Index of this stream within the AVFormatContext structure
 	int64_t startPts;               // Starting presentation timestamp (PTS) of the stream; AV_NOPTS_VALUE initially
+	AVBufferPool* framePool;        // Pool of decoded frame buffers (video only, see AVGetFrameBuffer)
+	size_t framePoolBufferSize;     // Size of the buffers of framePool
+	pthread_mutex_t framePoolLock;  // Guards framePool, requested by the decoder threads
+	atomic_int frameBufferAllocations; // Buffers allocated by framePool
+	MemoryUsage memory;             // Memory held for this stream (parent: MediaContext.memory)
 } StreamDataContext;
 
+// Background worker running a step function over and over.
+// - Dedicated mode: the step runs in a loop on its own thread, which sleeps on wakeUp when it returns WORKER_IDLE
+//   until WakeWorker() is called.
+// - Pooled mode (SetMediaFlag(MEDIA_WORKER_THREADS, [count > 0])): each step is a job of the shared worker pool.
+//   A step returning WORKER_PROGRESS is scheduled again; otherwise the worker sleeps until WakeWorker() is called.
+// - Start and stop workers from the thread owning the MediaStream only.
+typedef struct MediaWorker
+{
+	pthread_t thread;               // Thread running the worker loop (dedicated mode)
+	pthread_mutex_t wakeLock;       // Guards wakePending (dedicated mode)
+	pthread_cond_t wakeUp;          // Signaled by WakeWorker to resume an idle dedicated worker
+	bool wakePending;               // Set by WakeWorker, cleared by the worker before its next step (dedicated mode)
+	bool wakeReady;                 // True while wakeLock and wakeUp are initialized (dedicated mode, see UnloadWorker)
+	atomic_bool quit;               // Set by the owner thread to ask the worker to exit
+	atomic_int poolState;           // Scheduling state (pooled mode), one of WORKER_STATE_*
+	int (*step)(MediaContext* ctx); // Unit of work, returns WORKER_IDLE or WORKER_PROGRESS
+	MediaContext* ctx;              // Context passed to the step function
+	bool pooled;                    // True if the steps run on the shared worker pool
+	bool running;                   // True while the worker is started (owner thread only)
+} MediaWorker;
+
+// Job executed by the shared worker pool
+typedef struct PoolJob
+{
+	void (*run)(void* arg);         // Job function
+	void* arg;                      // Argument passed to the job function
+} PoolJob;
+
+// Double-ended job queue of a pool thread.
+// - The owner thread pushes new jobs at the back and takes them from the front, so its jobs run in turns.
+// - Idle pool threads steal jobs from the back of the other threads' deques.
+typedef struct JobDeque
+{
+	PoolJob* jobs;                  // Circular buffer of jobs, grown when full
+	int head;                       // Index of the front job
+	int count;                      // Number of queued jobs
+	int capacity;                   // Capacity of the circular buffer
+	pthread_mutex_t lock;           // Guards the deque
+} JobDeque;
+
+// Fixed point YUV to RGB coefficients of a color matrix and range (multiplied by 1 << YUV_SHIFT)
+typedef struct YUVCoefficients
+{
+	int16_t y;                      // Luma scale (255 / 219 limited range, 1 full range)
+	int16_t yOffset;                // Black level of the luma (16 limited range, 0 full range)
+	int16_t vr;                     // V contribution to red
+	int16_t ug;                     // U contribution to green (subtracted)
+	int16_t vg;                     // V contribution to green (subtracted)
+	int16_t ub;                     // U contribution to blue
+} YUVCoefficients;
+
+// Converts one row of a 4:2:0 YUV frame to RGB24 (pixelSize 3) or RGBA32 (pixelSize 4, opaque), see GetYUVRowKernel()
+typedef void (*YUVRowKernel)(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+
+// Row kernels selected for the running CPU
+typedef struct YUVRowKernels
+{
+	YUVRowKernel i420;              // Kernel for AV_PIX_FMT_YUV420P
+	YUVRowKernel nv12;              // Kernel for AV_PIX_FMT_NV12
+	const char* name;               // Instruction set of the kernels, for logging
+} YUVRowKernels;
+
+// Horizontal band of a video frame converted by its own SwsContext, possibly on a pool thread
+typedef struct ConvertBand
+{
+	struct SwsContext* swsContext;  // Conversion context sized for the band, NULL if rowKernel is used
+	YUVRowKernel rowKernel;         // Built-in converter replacing swsContext, NULL if unused
+	const YUVCoefficients* rowCoefficients; // Coefficients of rowKernel
+	int width;                      // Width of the frame (in pixels)
+	int y;                          // First row of the band (multiple of the vertical chroma subsampling)
+	int height;                     // Number of rows of the band
+	int chromaShift;                // log2 of the vertical chroma subsampling of the source format
+	int dstLineSize;                // Size in bytes of a destination row
+	const AVFrame* frame;           // Source frame of the conversion in progress
+	uint8_t* dst;                   // Destination image of the conversion in progress
+	atomic_int* pending;            // Bands of the conversion in progress not done yet
+} ConvertBand;
+
+// Shader converting the video planes of MEDIA_FLAG_VIDEO_YUV streams to RGB, shared by all of them.
+// Loaded on the main thread by the first stream using it, unloaded with the last one.
+typedef struct YUVShader
+{
+	Shader shader;                  // Plane conversion shader (default vertex shader)
+	int users;                      // Number of streams using the shader
+	int texture1Loc;                // Location of the second plane sampler (U, or UV for NV12)
+	int texture2Loc;                // Location of the third plane sampler (V)
+	int semiPlanarLoc;              // Location of the semiPlanar uniform (1 for NV12)
+	int fullRangeLoc;               // Location of the fullRange uniform (1 for JPEG range video)
+	int colorMatrixLoc;             // Location of the colorMatrix uniform (0: BT.601, 1: BT.709)
+} YUVShader;
+
+// Library-wide pool of threads running background work of every MediaStream with work stealing.
+// - Created on demand and destroyed when its last user releases it.
+// - To customize the number of threads, use SetMediaFlag(MEDIA_WORKER_THREADS, [threadCount]).
+typedef struct WorkerPool
+{
+	pthread_t* threads;             // Pool threads
+	JobDeque* deques;               // One job deque per pool thread
+	JobDeque global;                // Jobs submitted from threads outside the pool
+	JobDeque urgent;                // Short jobs someone is waiting for (e.g. conversion bands), run before any other
+	int threadCount;                // Number of pool threads (0 if the pool is not running)
+	int users;                      // Number of users holding the pool alive (guarded by lock)
+	atomic_int queuedJobs;          // Number of jobs waiting in any deque
+	atomic_bool quit;               // Set to shut the pool threads down
+	pthread_mutex_t lock;           // Guards creation and destruction of the pool
+	pthread_mutex_t sleepLock;      // Lock paired with wakeUp
+	pthread_cond_t wakeUp;          // Signaled when a job is submitted
+	pthread_mutex_t jobsLock;       // Lock paired with jobsDone
+	pthread_cond_t jobsDone;        // Signaled when the last pool job of a context ends (see ReleaseContextJob) or a job status changes (see SetJobStatus)
+} WorkerPool;
+
 // Structure to hold implementation-specific data for a media instance.
 // This structure is presented as an opaque pointer in a MediaStream.
 typedef struct MediaContext
@@ -169,17 +595,168 @@ typedef struct MediaContext
 
 	// Video stream-related fields
 	struct SwsContext* swsContext;              // Video resampling and scaling context
+	enum AVPixelFormat videoOutputFormat;       // Pixel format of videoOutputImage (MEDIA_VIDEO_FORMAT)
+	int videoPixelSize;                         // Size in bytes of a videoOutputImage pixel (1 for YUV output)
+	int videoFrameSize;                         // Size in bytes of the videoOutputImage data (all planes)
+	YUVRowKernel yuvRowKernel;                  // Built-in converter used instead of swsContext (MEDIA_VIDEO_FAST_CONVERT), NULL if unused
+	const YUVCoefficients* yuvCoefficients;     // Color matrix and range of yuvRowKernel (see GetYUVCoefficients)
+	ConvertBand* convertBands;                  // Bands converted in parallel (MEDIA_VIDEO_CONVERT_BANDS), NULL if unused
+	int convertBandCount;                       // Number of bands; conversion runs as a single sws_scale call if <= 1
 	Image videoOutputImage;                     // Image buffer holding the decoded video frame, uploaded to [MediaStream].videoTexture
+	uint8_t* videoBackBuffer;                   // Frame converted by AVFlushVideoFrame, then swapped with videoOutputImage.data
 
 	// Audio stream-related fields
 	struct SwrContext* swrContext;              // Audio resampling context
 	Buffer audioOutputBuffer;                   // Buffer with decoded audio, used to fill the AudioStream when needed
 	int audioOutputFmt;                         // Output audio format for this stream; must be an interleaved format
 	int audioMaxUpdateSize;						// Maximum number of bytes to be uploaded to the AudioStream in a frame
+	int audioChannels;							// Number of channels of the decoded audio
+	int audioBytesPerFrame;						// Size in bytes of a decoded audio frame (one sample per channel)
+	int audioSampleRate;						// Sample rate of the decoded audio
+	MediaAudioCallback audioCallback;			// Receives the decoded audio instead of the AudioStream, if set
+	void* audioCallbackData;					// User pointer passed to audioCallback
+
+	bool headless;								// MEDIA_LOAD_HEADLESS: no texture nor AudioStream, no audio device required
+
+	// Frame access (AcquireMediaFrame)
+	atomic_int frameBorrowers;                  // Number of borrowed frames not released yet
+	atomic_int frameWriting;                    // Set while videoOutputImage is being replaced (see BeginVideoFrameWrite)
+	double videoFrameTime;                      // Presentation time (seconds) of the frame in videoOutputImage
+	int videoFrameSequence;                     // Incremented each time videoOutputImage receives a new frame
+	bool textureUpload;                         // False to keep video frames on the CPU only (SetMediaTextureUpload)
+
+	// YUV output (MEDIA_FLAG_VIDEO_YUV): videoOutputImage holds the packed planes uploaded to [MediaStream].videoPlanes
+	bool yuvOutput;                             // True if video is output as YUV planes instead of RGB
+	bool yuvDirectCopy;                         // True if the planes are copied from the decoded frames, without swscale
+	bool yuvShaderUser;                         // True while the stream holds a reference on the shared YUV shader
+	int yuvFullRange;                           // 1 if the planes use the full (JPEG) range, 0 for the limited (MPEG) range
+	int yuvColorMatrix;                         // 0: BT.601, 1: BT.709
 
 	// libav* library-related fields
 	AVPacket* avPacket;                         // AVPacket used before dispatching to the correct stream context
 	AVFrame* avFrame;                           // AVFrame used for each packet during processing
+	AVFrame* pendingVideoFrame;                 // Latest video frame decoded in the current update, not converted yet
+	bool hasPendingVideoFrame;                  // True if pendingVideoFrame holds a frame
+	AVFrame* nextVideoFrame;                    // Frame decoded past the position by an accurate seek (synchronous decoding)
+	bool hasNextVideoFrame;                     // True if nextVideoFrame holds a frame
+
+	// Background demuxing (MEDIA_FLAG_THREADED_DEMUX)
+	bool threadedDemux;                         // True if packets are demuxed by a background worker
+	MediaWorker demuxWorker;                    // Worker filling the packet queues ahead of the playback clock
+	AVPacket* demuxPacket;                      // Packet read by the demux worker, waiting for room in its queue
+	bool demuxPending;                          // True if demuxPacket holds a packet not yet enqueued (worker only)
+	atomic_int demuxStatus;                     // MEDIA_RET_SUCCEED while demuxing; MEDIA_EOF or an error code once done
+
+	// Background decoding (MEDIA_FLAG_THREADED_DECODE)
+	bool threadedDecode;                        // True if video frames are decoded and converted by a background worker
+	MediaWorker decodeWorker;                   // Worker decoding video frames ahead of the playback clock
+	FrameQueue decodedFrames;                   // Converted video frames waiting to be presented
+	AVFrame* decodeFrame;                       // AVFrame used by the decode worker
+	bool decodeDraining;                        // True once the decoder was asked to output its last frames (worker only)
+	atomic_int decodeStatus;                    // MEDIA_RET_SUCCEED while decoding; MEDIA_EOF or an error code once done
+
+	// Asynchronous loading (LoadMediaAsync)
+	atomic_int loadStatus;                      // LOAD_STATUS_DONE unless the load job is pending or failed
+	atomic_bool abortLoad;                      // Set to interrupt the libav calls of a pending load job
+	char* loadFileName;                         // Copy of the file name read by the load job
+	int loadFlags;                              // Flags given to LoadMediaAsync
+	MediaConfig config;                         // Copy of MEDIA taken by the loading call, read while loading in its place
+	bool audioDeviceReady;                      // IsAudioDeviceReady() at the loading call (the load job can't query raylib)
+	bool loadHoldsPool;                         // True until FinishMediaLoad: the load job holds a pool reference
+
+	// Shared worker pool (MEDIA_WORKER_THREADS > 0)
+	bool usesPool;                              // True if the context holds a reference to the shared worker pool
+	bool pooledWorkers;                         // True if the background workers run on the shared worker pool
+	atomic_int activeJobs;                      // Number of queued or running pool jobs of this context
+
+	// Playback counters (see MediaStats)
+	atomic_int decodedVideoFrames;              // Video frames decoded
+	atomic_int presentedVideoFrames;            // Video frames uploaded to the texture
+	atomic_int droppedVideoFrames;              // Video frames decoded but never presented
+	atomic_int avoidedVideoConversions;         // Dropped frames whose conversion and upload were deferred, then skipped
+	atomic_int skippedVideoPackets;             // Late disposable video packets never sent to the decoder
+	atomic_int keyframeJumps;                   // Jumps to a keyframe triggered by MEDIA_VIDEO_KEYFRAME_JUMP
+	atomic_llong videoConvertTime;              // Time (microseconds) spent converting video frames to videoOutputFormat
+	atomic_llong videoUploadTime;               // Time (microseconds) spent uploading video frames to the texture
+
+	// Memory accounting (see GetMediaMemoryStats)
+	MemoryUsage memory;                         // All memory tracked for the media (parent: MEDIA_MEMORY)
+	MemoryUsage sharedMemory;                   // Memory not tied to a stream: context, file name, IO buffer
+	int ioBufferSize;                           // Size of the custom IO buffer accounted in sharedMemory
+	atomic_int updateAllocations;               // Tracked allocations made by the outermost UpdateMediaEx call, on its thread
+
+	// Keyframe index (MEDIA_FLAG_KEYFRAME_INDEX)
+	KeyframeIndex keyframeIndex;                // Written by the scan thread, usable once indexStatus is INDEX_STATUS_READY
+	KeyframeIndexHeader indexHeader;            // Identifies the media in the index cache file
+	atomic_int indexStatus;                     // INDEX_STATUS_* value
+	atomic_bool abortIndex;                     // Set to interrupt a pending scan
+	pthread_t indexThread;                      // Thread running the scan, off the worker pool as it reads the whole file
+	bool indexThreadRunning;                    // True until the scan thread is joined (UnloadKeyframeIndex)
+	char* indexFileName;                        // Media file scanned by the thread
+	char* indexCacheFileName;                   // Index cache file (MEDIA_FLAG_KEYFRAME_INDEX_CACHE), NULL if unused
+	atomic_int indexedSeeks;                    // Seeks that went straight to an indexed keyframe
+
+	// Fast catch-up (MEDIA_FLAG_FAST_CATCH_UP)
+	bool fastCatchUp;                           // True if the decoder may trade quality for speed while lagging
+	bool catchingUp;                            // True while the video decoder runs with the reduced quality settings
+
+	// Keyframe jump (MEDIA_VIDEO_KEYFRAME_JUMP)
+	double keyframeJumpGuard;                   // No new jump until video packets reach this time (the previous jump position)
+
+	// Seeking
+	bool accurateSeek;                          // SetMediaPosition decodes up to the exact target (MEDIA_FLAG_ACCURATE_SEEK)
+	int seekCount;                              // Successful seeks
+	int64_t seekTime;                           // Time (microseconds) spent in successful seeks
+	int64_t lastSeekTime;                       // Time (microseconds) spent in the last successful seek
+	int lastSeekDecodedFrames;                  // Frames decoded past the keyframe by the last accurate seek
+	bool seekResumeWorkers;                     // AVSeekBegin stopped the background workers, AVSeekEnd restarts them
+	int64_t seekStartTime;                      // av_gettime_relative() of the first request of the seek in progress, 0 if none
+
+	// Asynchronous seek (SetMediaPositionAsync)
+	atomic_int seekStatus;                      // SEEK_STATUS_IDLE unless a seek job is pending or waiting to be presented
+	bool seekHoldsPool;                         // The seek jobs registered as a user of the worker pool
+	int64_t seekTarget;                         // Latest requested target (AV_TIME_BASE units)
+	bool seekQueued;                            // seekTarget came in while a job was pending: it runs once that one is done
+	int64_t seekJobTarget;                      // Target of the pending job
+	int seekResult;                             // AVSeekCore result of the job, valid once seekStatus is SEEK_STATUS_DONE
+	atomic_bool abortSeek;                      // Set to stop the pending job at the next packet: a later request supersedes it
+	int coalescedSeeks;                         // Requests replaced by a later one before their job started
+
+	// Decoded GOP cache (MEDIA_VIDEO_GOP_CACHE)
+	GopCache gopCache;                          // Recently decoded frames
+	bool deferredSeek;                          // A seek was served by the cache: the decoder must seek before playing
+	int64_t deferredSeekTarget;                 // Position (AV_TIME_BASE units) the decoder must be brought to
+
+	// Frame stepping (StepMediaFrame)
+	int forwardSteps;                           // Successful forward steps
+	int backwardSteps;                          // Successful backward steps
+	int64_t forwardStepTime;                    // Time (microseconds) spent in forward steps
+	int64_t backwardStepTime;                   // Time (microseconds) spent in backward steps
+	int64_t lastStepTime;                       // Time (microseconds) spent in the last step
+
+	// Reverse playback (negative UpdateMediaEx deltaTime)
+	bool reversePlay;                           // The video plays backwards from segments decoded by a pool job
+	bool reverseHoldsPool;                      // The reverse jobs registered as a user of the worker pool
+	ReverseSegment reverseSegments[2];          // Segment being presented, and the earlier one the job decodes
+	int reverseFront;                           // Index of the segment being presented
+	double reverseShownTime;                    // Time of the frame presented from the front segment, -1 if none
+	atomic_int reverseJobPending;               // The job filling the back segment is queued or running (see SetJobStatus)
+	atomic_bool abortReverse;                   // Set to stop the pending job between two packets (StopReversePlayback)
+	atomic_int reverseDecodedFrames;            // Frames decoded by the reverse jobs, including those decoded again
+	atomic_int reverseSegmentCount;             // Segments decoded
+	int reverseStalls;                          // Updates that found the front segment done and the next one not ready
+
+	// Playback rate (SetMediaPlaybackRate)
+	double playbackRate;                        // Scale of the deltaTime given to UpdateMediaEx
+	TimeStretch timeStretch;                    // Loaded by the first rate other than 1, then used for all the audio
+	double audioEndTime;                        // Media time (seconds) reached by the decoded audio
+	int droppedAudioPackets;                    // Late audio packets decoded but discarded
+	int audioOverflows;                         // Decoded audio frames cut short by a full audioOutputBuffer
+
+	// Pulled audio (MEDIA_FLAG_AUDIO_PULL)
+	bool pullAudio;                             // The AudioStream callback reads audioOutputBuffer on the audio thread
+	int audioPullSlot;                          // Index of the AudioPullSlot held while pullAudio is set
+	atomic_int audioUnderruns;                  // Callbacks that found less decoded audio than requested
 
 	// MediaStream-related fields
 	MediaState state;                           // Current state of the media. Use SetMediaState()/GetMediaState() to modify.
@@ -202,9 +779,109 @@ static MediaConfig MEDIA = {
 	.audioStreamBufferSize  = 1  * 1024, //
 	.audioOutputChannels = 2,
 	.audioOutputFmt = AV_SAMPLE_FMT_S16,
+	.videoFrameQueueSize = 4,
+	.decodeThreads = 1,
+	.decodeThreadType = MEDIA_DECODE_THREAD_FRAME | MEDIA_DECODE_THREAD_SLICE,
+	.videoConvertBands = 1,
+	.videoFastConvert = true,
+	.videoFormat = PIXELFORMAT_UNCOMPRESSED_R8G8B8,
+	.reverseFrames = 64,
 	.maxAllowedDelay = {0.04, 1.0}    //!IMPORTANT: Assuming here STREAM_AUDIO = 0, STREAM_VIDEO = 1
 };
 
+// Shared worker pool, created on demand (see WorkerPool)
+static WorkerPool POOL = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.sleepLock = PTHREAD_MUTEX_INITIALIZER,
+	.wakeUp = PTHREAD_COND_INITIALIZER,
+	.jobsLock = PTHREAD_MUTEX_INITIALIZER,
+	.jobsDone = PTHREAD_COND_INITIALIZER
+};
+
+// Memory tracked across all the MediaStreams and the shared worker pool
+static MemoryUsage MEDIA_MEMORY = { 0 };
+
+// Index of the pool thread running the calling code, -1 outside the pool
+static MEDIA_THREAD_LOCAL int POOL_THREAD_INDEX = -1;
+
+// True on the threads of the library: pool, dedicated workers and keyframe scan (see MemoryUsage.workerAllocations)
+static MEDIA_THREAD_LOCAL bool WORKER_THREAD = false;
+
+// Tracked allocations made by the calling thread, sampled by UpdateMediaEx
+static MEDIA_THREAD_LOCAL int THREAD_ALLOCATIONS = 0;
+
+// Nesting level of UpdateMediaEx on the calling thread (a completed seek updates the media again, see AVSeekEnd)
+static MEDIA_THREAD_LOCAL int UPDATE_DEPTH = 0;
+
+// YUV to RGB row kernels, selected on first use (see GetYUVRowKernel)
+static YUVRowKernels YUV_KERNELS = { 0 };
+
+// Coefficients of the row kernels: [BT.601, BT.709][limited, full range]
+static const YUVCoefficients YUV_COEFFICIENTS[2][2] = {
+	{ { 75, 16, 102, 25, 52, 129 }, { 64, 0, 90, 22, 46, 113 } },
+	{ { 75, 16, 115, 14, 34, 135 }, { 64, 0, 101, 12, 30, 119 } }
+};
+
+// Correlation kernel of the audio time-stretcher, selected on first use (see GetDotProductKernel)
+static DotProductKernel DOT_PRODUCT_KERNEL = NULL;
+
+// Slots of the MediaStreams pulling their audio (see AudioPullSlot)
+static AudioPullSlot AUDIO_PULL_SLOTS[MEDIA_AUDIO_PULL_SLOTS] = { 0 };
+
+// Shared plane conversion shader, see YUVShader (main thread only)
+static YUVShader YUV_SHADER = { 0 };
+
+// Fragment shader converting the YUV planes to RGB. The GLSL version and its syntax are prepended at load time
+// (see AcquireYUVShader). Single channel planes are read from .r, NV12 chroma from .r (U) and .a (V).
+static const char* YUV_SHADER_CODE =
+	"IN vec2 fragTexCoord;\n"
+	"IN vec4 fragColor;\n"
+	"uniform sampler2D texture0;\n"
+	"uniform sampler2D texture1;\n"
+	"uniform sampler2D texture2;\n"
+	"uniform vec4 colDiffuse;\n"
+	"uniform int semiPlanar;\n"
+	"uniform int fullRange;\n"
+	"uniform int colorMatrix;\n"
+	"void main()\n"
+	"{\n"
+	"    float y = TEXTURE(texture0, fragTexCoord).r;\n"
+	"    vec4 chroma = TEXTURE(texture1, fragTexCoord);\n"
+	"    vec2 uv = (semiPlanar == 1) ? chroma.ra : vec2(chroma.r, TEXTURE(texture2, fragTexCoord).r);\n"
+	"    uv -= 128.0/255.0;\n"
+	"    if (fullRange == 0)\n"
+	"    {\n"
+	"        y = (y - 16.0/255.0)*(255.0/219.0);\n"
+	"        uv *= 255.0/224.0;\n"
+	"    }\n"
+	"    vec3 rgb = (colorMatrix == 1) ?\n"
+	"        vec3(y + 1.5748*uv.y, y - 0.1873*uv.x - 0.4681*uv.y, y + 1.8556*uv.x) :\n"
+	"        vec3(y + 1.4020*uv.y, y - 0.3441*uv.x - 0.7141*uv.y, y + 1.7720*uv.x);\n"
+	"    FRAG_COLOR = vec4(clamp(rgb, 0.0, 1.0), 1.0)*colDiffuse*fragColor;\n"
+	"}\n";
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Memory tracking
+//---------------------------------------------------------------------------------------------------
+
+// Tracked allocators: every block remembers its size and usage in a MemoryHeader, so frees need no size.
+
+void* MediaMalloc(MemoryUsage* usage, size_t size);                 // Allocate memory with RL_MALLOC, accounted in usage
+void* MediaCalloc(MemoryUsage* usage, size_t count, size_t size);   // Allocate zeroed memory with RL_MALLOC, accounted in usage
+void  MediaFree(void* ptr);                                         // Free a block of MediaMalloc/MediaCalloc (NULL is ignored)
+void* MediaAlignedMalloc(MemoryUsage* usage, size_t size);          // Allocate SIMD aligned memory with av_malloc, accounted in usage
+void  MediaAlignedFree(void* ptr);                                  // Free a block of MediaAlignedMalloc (NULL is ignored)
+
+void InitMemoryUsage(MemoryUsage* usage, MemoryUsage* parent);      // Reset a usage, counting it in parent too
+void InitMediaMemory(MediaContext* ctx);                            // Initialize the usages of a zeroed MediaContext and account the context itself
+
+// Account memory allocated (bytes > 0, counts as one allocation) or freed (bytes < 0) in usage and its parents.
+// Used directly for memory owned by FFmpeg, such as packet payloads and the custom IO buffer. NULL usage is ignored.
+void TrackMemory(MemoryUsage* usage, long long bytes);
+
+MediaMemoryUsage GetMemoryUsage(const MemoryUsage* usage);          // Current and peak bytes of a usage
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Declaration - Circular buffer logic
@@ -234,7 +911,7 @@ void AdvanceReadPosN(BufferState* state, int n);   // Advance the read position
 // Functions Declaration - Buffer management
 //---------------------------------------------------------------------------------------------------
 
-Buffer LoadBuffer(int capacity);                   // Load a circular buffer with the specified capacity.
+Buffer LoadBuffer(int capacity, MemoryUsage* memory);  // Load a circular buffer with the specified capacity, accounted in memory.
 void UnloadBuffer(Buffer* buffer);                 // Free memory associated with the buffer.
 bool IsBufferReady(const Buffer* buffer);          // Check if the buffer is properly loaded.
 void ClearBuffer(Buffer* buffer);                  // Reset the circular buffer without freeing memory, allowing for reuse.
@@ -252,7 +929,7 @@ int  ReadBuffer(Buffer* buffer, uint8_t* dstData, int dstSize);			// Read data f
 // Functions Declaration - PacketQueue management
 //---------------------------------------------------------------------------------------------------
 
-PacketQueue LoadQueue(int capacity);					// Load a packet queue with the specified capacity.
+PacketQueue LoadQueue(int capacity, MemoryUsage* memory);	// Load a packet queue with the specified capacity. Queued payloads are accounted in memory.
 void UnloadQueue(PacketQueue* queue);					// Free memory associated with the queue.
 bool IsQueueReady(const PacketQueue* queue);			// Check if the queue is properly loaded.
 void ClearQueue(PacketQueue* queue);					// Reset the queue without freeing memory, allowing for reuse.
@@ -268,6 +945,20 @@ bool DequeuePacket(PacketQueue* queue, AVPacket* dst);	// Dequeue a packet. Auto
 AVPacket* PeekPacket(const PacketQueue* queue);			// Returns a pointer to the first available packet, or NULL if the queue is empty.
 														// Does not modify the queue or advance the read position.
 
+void SkipPacket(PacketQueue* queue);					// Unreference the first packet (see PeekPacket) and advance the read position.
+														// Same as DequeuePacket, but avoids moving the reference.
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - FrameQueue management
+//---------------------------------------------------------------------------------------------------
+
+FrameQueue LoadFrameQueue(int capacity, int frameSize, MemoryUsage* memory);	// Load a frame queue with the specified capacity; each frame holds
+																			// frameSize bytes. Accounted in memory.
+void UnloadFrameQueue(FrameQueue* queue);				// Free memory associated with the queue.
+bool IsFrameQueueReady(const FrameQueue* queue);		// Check if the queue is properly loaded.
+void ClearFrameQueue(FrameQueue* queue);				// Reset the queue without freeing memory, allowing for reuse.
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - AV management - FFmpeg (libav*)
@@ -290,26 +981,488 @@ int AVDecodePacket(const MediaStream* media, int streamType, const AVPacket* pac
 // Processes a specific audio frame to provide usable data for [MediaStream].audioStream.
 int AVProcessAudioFrame(const MediaStream* media);
 
-// Processes a specific video frame to provide usable data for [MediaStream].videoTexture.
-int AVProcessVideoFrame(const MediaStream* media);
+// Keeps the video frame just decoded as the pending one, replacing (and skipping) the previous pending frame.
+// Conversion and upload are deferred to AVFlushVideoFrame, so catching up costs a single conversion.
+int AVProcessVideoFrame(MediaContext* ctx);
+
+// Converts the pending video frame and uploads it to [MediaStream].videoTexture, if there is one.
+void AVFlushVideoFrame(const MediaStream* media);
+
+// Uploads [MediaContext].videoOutputImage to [MediaStream].videoTexture (or videoPlanes), unless the media is headless.
+void AVUploadVideoImage(const MediaStream* media);
+
+// Drops the pending video frame, if any (e.g. after seeking).
+void AVDropVideoFrame(MediaContext* ctx);
+
+// Drops the frame decoded ahead by an accurate seek, if any (see AVDecodeToTarget).
+void AVDropNextVideoFrame(MediaContext* ctx);
+
+// Converts a decoded video frame into the next slot of the decoded frame queue, which must not be full.
+void AVQueueVideoFrame(MediaContext* ctx, const AVFrame* frame);
+
+// Switches the video decoder between full quality and the fast catch-up settings (MEDIA_FLAG_FAST_CATCH_UP).
+// While catching up, non-reference frames are skipped and the deblocking filter is disabled.
+void AVSetVideoCatchUp(MediaContext* ctx, bool enable);
 
-// Helper for seeking to the first video keyframe in the media. Called by AVSeek after codec are flushed.
-// It's used to avoid visual codec artifacts while seeking in the media.
-bool AVSeekVideoKeyframe(const MediaStream* media);
+// Computes the video output size from the requested one (MEDIA_VIDEO_OUTPUT_WIDTH/HEIGHT, SetMediaOutputSize).
+// A zero dimension follows the source aspect ratio; both zero keep the source size.
+void AVGetVideoOutputSize(const AVCodecContext* codecCtx, int requestedWidth, int requestedHeight, int* width, int* height);
+
+// Creates the video conversion state for an output size: SwsContext, built-in converter, conversion bands,
+// videoOutputImage and the decoded frame queue (threaded decoding). Returns false on failure.
+bool AVLoadVideoOutput(MediaContext* ctx, int width, int height);
+
+// Frees everything created by AVLoadVideoOutput.
+void AVUnloadVideoOutput(MediaContext* ctx);
+
+// Fills the plane pointers and row sizes of a video buffer laid out like [MediaContext].videoOutputImage.
+// RGB output has a single plane; YUV output has packed planes, without row padding.
+void AVGetVideoPlanes(const MediaContext* ctx, uint8_t* data, uint8_t* planes[4], int lineSizes[4]);
+
+// Presentation time (in seconds, relative to the stream start) of a decoded video frame.
+double AVGetVideoFrameTime(const MediaContext* ctx, const AVFrame* frame);
+
+// Presentation time (in seconds, relative to the stream start) of a decoded audio frame.
+// Frames without timestamp follow the previous one (audioEndTime).
+double AVGetAudioFrameTime(const MediaContext* ctx, const AVFrame* frame);
+
+// Converts a decoded video frame into dst, which must have the same layout as [MediaContext].videoOutputImage.
+// With several conversion bands, the bands run in parallel on the shared worker pool.
+void AVConvertVideoFrame(const MediaContext* ctx, const AVFrame* frame, uint8_t* dst);
+
+// Creates the per band SwsContexts used to convert video frames in parallel.
+// Returns false if the source format can't be split, leaving the conversion to ctx->swsContext.
+bool AVLoadConvertBands(MediaContext* ctx, int bandCount);
+
+// Frees the per band SwsContexts.
+void AVUnloadConvertBands(MediaContext* ctx);
+
+// Pool job converting a single band (see ConvertBand).
+void RunConvertBand(void* band);
+
+// Allocates a video frame buffer aligned for SIMD stores (MediaAlignedMalloc), to be released with MediaAlignedFree().
+// Decoded frames and videoOutputImage swap their buffers, so both must come from here.
+uint8_t* AVAllocVideoBuffer(MemoryUsage* memory, int size);
+
+// Helper for seeking to the first video keyframe in the media. Called by AVSeekCore after codec are flushed.
+// It's used to avoid visual codec artifacts while seeking in the media. Stores the keyframe time (seconds) in
+// keyframeTime, left untouched if the media has no video.
+// Returns MEDIA_RET_SUCCEED, MEDIA_EOF if the stream ends before a keyframe, or an error code.
+int AVSeekVideoKeyframe(MediaContext* ctx, double* keyframeTime);
 
 // Helper for seeking to a specific position in the media (targetTimestamp in libav time units).
-bool AVSeek(MediaStream* media, int64_t targetTimestamp);
+// With accurate set, the video is decoded from the keyframe up to the target (see AVDecodeToTarget);
+// otherwise the position snaps to the keyframe. Waits for a pending asynchronous seek, which this one replaces.
+// Runs AVSeekBegin, AVSeekCore and AVSeekEnd on the calling thread.
+bool AVSeek(MediaStream* media, int64_t targetTimestamp, bool accurate);
+
+// First part of a seek, on the thread owning the media: stops the background workers and the audio stream.
+// Calling it again before AVSeekEnd (e.g. a seek replacing a pending one) keeps the state of the first call.
+void AVSeekBegin(MediaStream* media);
+
+// Seeks the demuxer, flushes the decoders and the queues, then finds the keyframe (and decodes up to the target
+// if accurate). Makes no raylib call, so it can run on the worker pool between AVSeekBegin and AVSeekEnd.
+// Returns MEDIA_RET_SUCCEED, MEDIA_EOF or an error code.
+int AVSeekCore(MediaContext* ctx, int64_t targetTimestamp, bool accurate);
+
+// Part of AVSeekCore bringing the demuxer and the decoders to the target, without looking up the GOP cache.
+int AVSeekStreams(MediaContext* ctx, int64_t targetTimestamp, bool accurate);
+
+// Brings the decoder to the position of a seek served by the GOP cache (see AVSeekCachedFrame).
+bool AVResolveDeferredSeek(MediaStream* media);
+
+// Last part of a seek, on the thread owning the media: presents the frame found by AVSeekCore, restarts the workers
+// and the audio stream, and records the seek stats. result is the value returned by AVSeekCore.
+bool AVSeekEnd(MediaStream* media, int result);
+
+// Decodes the video from the current keyframe up to targetTime (seconds), keeping only the last frame at or before
+// it as the pending one: the frames in between are neither converted nor uploaded. Called by AVSeekCore.
+// The first frame past the target is kept for what comes next: nextVideoFrame, or the decoded frame queue.
+// Queued audio packets before the target are dropped. Sets the media time to the target.
+// Stops early once ctx->abortSeek is set, the seek being superseded.
+void AVDecodeToTarget(MediaContext* ctx, double targetTime);
+
+// Drops the queued audio packets starting before targetTime (seconds).
+void AVSkipAudioBefore(MediaContext* ctx, double targetTime);
+
+// Presents the next video frame(s) of a StepMediaFrame: from the GOP cache after a cached seek, then from the
+// frame decoded ahead, the decoded frame queue or the decoder. Returns false at the end of the stream, or if the
+// displayed frame is borrowed (AcquireMediaFrame): the next frame is kept for a later step.
+bool AVStepForward(MediaStream* media, int count);
+
+// Presents the next video frame of AVStepForward. When the decode worker hasn't decoded it yet, the workers are
+// stopped and the frame is decoded right away instead of waiting; resumeWorkers is set to restart them afterwards.
+// Returns false at the end of the stream.
+bool AVStepNextFrame(MediaStream* media, bool* resumeWorkers);
+
+// Presents an earlier video frame of a StepMediaFrame: each step is an accurate seek just before the displayed
+// frame, served by the GOP cache or decoded from the keyframe (index). Returns false at the start of the stream.
+bool AVStepBackward(MediaStream* media, int count);
+
+// Decodes the next video frame into the pending frame (synchronous decoding).
+// Returns MEDIA_RET_SUCCEED, MEDIA_EOF or an error code.
+int AVDecodeNextFrame(MediaContext* ctx);
+
+// Checks if jumping to the last video keyframe before timePos would skip part of the backlog, i.e. if that
+// keyframe comes after the given late packet. Uses the keyframe index if ready, otherwise the container index.
+// Assumes it does when the stream has no index.
+bool AVKeyframeJumpSkipsBacklog(const MediaContext* ctx, const AVPacket* latePacket);
 
 // Helper for relative position seeking in the media (factor is the relative position 
 // between 0.0 and 1.0) [not used].
 bool AVSeekRelative(MediaStream* media, double factor);
 
 // Helper function to load codec context data for a specific stream.
-bool AVLoadCodecContext(StreamDataContext* streamCtx, const AVCodec* codec, const AVCodecParameters* params);
+// - threadCount: Decoder threads (0 lets FFmpeg choose, 1 disables threading).
+// - threadType: Allowed threading methods (MediaDecodeThreadType flags).
+bool AVLoadCodecContext(StreamDataContext* streamCtx, const AVCodec* codec, const AVCodecParameters* params, int threadCount, int threadType);
 
 // Helper function to free memory associated with codec context data for a specific stream.
 void AVUnloadCodecContext(StreamDataContext* streamCtx);
 
+// Decoder get_buffer2 callback (video): hands out frame buffers from the framePool of the stream, so no memory is
+// allocated once the pool holds as many buffers as the decoder keeps in flight. Falls back to the default allocator
+// for codecs without direct rendering support and for hardware or palette formats.
+int AVGetFrameBuffer(AVCodecContext* codecCtx, AVFrame* frame, int flags);
+
+// Allocation callback of framePool: counts the allocations (MediaStats.frameBufferAllocations).
+AVBufferRef* AVAllocFrameBuffer(void* opaque, size_t size);
+
+// Free callback of the framePool buffers.
+void AVFreeFrameBuffer(void* opaque, uint8_t* data);
+
+// Background demux step: reads one packet and moves it to the queue of its stream, if there is room for it.
+// Returns WORKER_PROGRESS if a packet was read or enqueued, WORKER_IDLE otherwise.
+int AVDemuxStep(MediaContext* ctx);
+
+// Returns the packet queue of the stream with the given container index, or NULL if that stream isn't played.
+PacketQueue* GetStreamPacketQueue(MediaContext* ctx, int streamIndex);
+
+// Background decode step: feeds the video decoder with the next queued packet, or converts the next decoded
+// frame into the frame queue if there is room for it. Returns WORKER_PROGRESS if some work was done.
+int AVDecodeStep(MediaContext* ctx);
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Keyframe index
+//---------------------------------------------------------------------------------------------------
+
+// Set up the keyframe index of a loaded media: container index, cache file (useCache) or background scan.
+// fileName is NULL for custom streams, which can only use the container index.
+void LoadKeyframeIndex(MediaContext* ctx, const char* fileName, bool useCache);
+
+// Abort a pending scan, join its thread, and free the index.
+void UnloadKeyframeIndex(MediaContext* ctx);
+
+// Copy the keyframes of the container index, if it reaches the end of the video stream. Returns false otherwise.
+bool LoadContainerKeyframes(MediaContext* ctx, KeyframeIndex* index);
+
+// Read all the video packets of ctx->indexFileName with a new AVFormatContext, collecting the keyframes.
+bool ScanKeyframes(MediaContext* ctx, KeyframeIndex* index);
+
+void* RunKeyframeScan(void* ctx);                           // Scan thread entry point: ScanKeyframes, then saving the cache file.
+int AVInterruptIndexScan(void* ctx);                        // libav interrupt callback, aborts the reads of a pending scan.
+
+// Map (or read, on Windows) a cache file, checking that it was built for the media described by expected.
+bool LoadKeyframeIndexCache(KeyframeIndex* index, const char* cacheFileName, const KeyframeIndexHeader* expected, MemoryUsage* memory);
+bool SaveKeyframeIndexCache(const KeyframeIndex* index, const char* cacheFileName, KeyframeIndexHeader header);
+void FreeKeyframeIndexData(KeyframeIndex* index);           // Unmap or free the memory of an index.
+
+const KeyframeIndex* GetKeyframeIndex(const MediaContext* ctx);              // The index, if it's ready; NULL otherwise.
+const KeyframeEntry* FindKeyframe(const KeyframeIndex* index, int64_t pts);  // Last keyframe at or before pts (binary search), NULL if none.
+
+// Converts a media time (AV_TIME_BASE units, from the first video packet) to a video stream timestamp.
+int64_t AVGetVideoStreamPts(const MediaContext* ctx, int64_t timestamp);
+
+// Seeks to the indexed keyframe before targetTimestamp, if the index is ready. Returns false if the caller must
+// seek through the demuxer instead.
+bool AVSeekIndexedKeyframe(MediaContext* ctx, int64_t targetTimestamp);
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Decoded GOP cache
+//---------------------------------------------------------------------------------------------------
+
+// Adds a decoded video frame to the GOP cache, if enabled. A keyframe starts a new GOP (or reopens a cached one,
+// whose frames already held are skipped); other frames are only kept while their GOP has no hole.
+// Evicts the least recently used GOPs beyond the memory budget.
+void CacheVideoFrame(MediaContext* ctx, const AVFrame* frame);
+
+// Stops adding frames until the next keyframe. Called when a frame won't be decoded (seek, skipped packet).
+void BreakGopCache(GopCache* cache);
+
+// Finds the cached frame to show at time (seconds): the last one at or before it, or the keyframe of its GOP if
+// not accurate. Returns NULL if the GOP holding that frame isn't cached up to time.
+const CachedFrame* FindCachedFrame(GopCache* cache, double time, bool accurate);
+
+// Finds the cached frame following the one at time (seconds) in the same GOP, NULL if there is none.
+const CachedFrame* FindNextCachedFrame(GopCache* cache, double time);
+
+void EvictCachedGop(GopCache* cache, int index);             // Release the frames of a GOP and remove it.
+void UnloadGopCache(GopCache* cache);                        // Release all the cached frames.
+
+// Serves a seek from the GOP cache while the media isn't playing: the cached frame becomes the pending one and the
+// decoder seek is deferred until playback resumes (deferredSeek). Returns false on a cache miss.
+bool AVSeekCachedFrame(MediaContext* ctx, int64_t targetTimestamp, bool accurate);
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Reverse playback
+//---------------------------------------------------------------------------------------------------
+
+// Body of UpdateMediaEx for a negative deltaTime (or zero while playing backwards): moves the media time back and
+// presents the last frame of the front segment at or before it. Once the front segment is done, continues with
+// the back one if decoded, and submits the decoding of the segment before it.
+bool UpdateReversePlayback(MediaStream* media, double deltaTime);
+
+// Stops the workers and the audio (as AVSeekBegin), allocates the segments and submits the first one.
+bool StartReversePlayback(MediaStream* media);
+
+// Interrupts and waits for the pending job, then frees the segments. The decoder must be seeked before playing
+// forward again.
+void StopReversePlayback(MediaContext* ctx);
+
+// Clears the back segment and submits the job decoding the frames before endTime (seconds) into it.
+// Runs the job on the calling thread if it can't be submitted.
+void SubmitReverseJob(MediaContext* ctx, double endTime);
+
+void RunReverseJob(void* ctx);                              // Pool job running AVDecodeReverseSegment on the back segment.
+
+// Seeks to the last keyframe before segment->endTime, then decodes up to it, keeping the last segment->capacity
+// frames. With a GOP longer than that, the frames before them are decoded again by the next segment.
+// Returns early, with a partial segment, once ctx->abortReverse is set.
+void AVDecodeReverseSegment(MediaContext* ctx, ReverseSegment* segment);
+
+bool LoadReverseSegment(ReverseSegment* segment, int capacity, MemoryUsage* memory);   // Allocate the frames of a segment.
+void UnloadReverseSegment(ReverseSegment* segment);                                    // Free the frames of a segment.
+void ClearReverseSegment(ReverseSegment* segment);                                     // Release the frame references of a segment.
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Asynchronous seek
+//---------------------------------------------------------------------------------------------------
+
+// Submit a seek job to targetTimestamp (AV_TIME_BASE units). AVSeekBegin must have been called.
+// Runs the seek on the calling thread if the job can't be submitted.
+void SubmitMediaSeek(MediaContext* ctx, int64_t targetTimestamp);
+
+void RunSeekJob(void* ctx);                                 // Pool job running AVSeekCore for SetMediaPositionAsync.
+
+// Called by UpdateMediaEx: resubmits the job for a request coalesced meanwhile, or ends a finished seek.
+// Returns false while a seek is still pending, in which case the media must not be updated.
+bool PollMediaSeek(MediaStream* media);
+
+void WaitMediaSeek(MediaContext* ctx);                      // Block until the pending seek job, if any, is done.
+void CancelMediaSeek(MediaContext* ctx);                    // Interrupt and wait for the seek job, dropping its result and any coalesced request.
+void InterruptMediaSeek(MediaContext* ctx);                 // Interrupt and wait for the seek job; PollMediaSeek runs its target again.
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Audio time-stretching
+//---------------------------------------------------------------------------------------------------
+
+// The first rate other than 1 loads the stretcher of the media (see TimeStretch), and the audio goes through it while
+// the rate isn't 1. Back at 1x, the stretcher is flushed with its last segment faded into the input continuation,
+// then the samples pass straight through again, without its latency.
+
+bool LoadTimeStretch(TimeStretch* ts, int channels, int sampleRate, int bytesPerFrame, MemoryUsage* memory);	// Allocate a stretcher.
+void UnloadTimeStretch(TimeStretch* ts);                    // Free the buffers of a stretcher.
+void ResetTimeStretch(TimeStretch* ts);                     // Drop the buffered audio, e.g. after a seek (no effect if not loaded).
+bool IsTimeStretchReady(const TimeStretch* ts);             // Check if a stretcher is loaded.
+
+// Produces the next hopFrames output frames into ts->output. Returns false if more input is needed.
+bool RunTimeStretch(TimeStretch* ts);
+
+// Finds the start of the segment around nominal (input frames) matching best the continuation of the previous one:
+// coarse search every MEDIA_STRETCH_SEARCH_STEP frames, then refined around the best position.
+int FindStretchSegment(const TimeStretch* ts, int nominal);
+
+// AVProcessAudioFrame once the stretcher is loaded: converts the frame into the stretcher input, in chunks, and
+// writes the stretched audio into audioOutputBuffer.
+int AVStretchAudioFrame(MediaContext* ctx);
+
+// Writes the output of RunTimeStretch into audioOutputBuffer while there is room for it.
+void AVDrainTimeStretch(MediaContext* ctx);
+
+// Writes what the stretcher still holds into audioOutputBuffer, unstretched, then resets it (rate back to 1).
+void AVFlushTimeStretch(MediaContext* ctx);
+
+// Writes up to count float samples (whole frames) into audioOutputBuffer. Returns the number of samples written.
+int AVWriteStretchOutput(MediaContext* ctx, const float* samples, int count);
+
+// Audio position minus the media position (seconds): positive when the audio sent out is ahead of the video.
+// The audio position is the media time of the next sample leaving audioOutputBuffer, not counting the buffer
+// of the AudioStream itself.
+double GetAudioDrift(const MediaContext* ctx);
+
+// Convert count interleaved samples of an audio output format (U8, S16, S32, FLT or DBL) from and to float.
+// Integer samples scale by the same power of two both ways, so they come back unchanged.
+void SamplesToFloat(const uint8_t* src, int format, float* dst, int count);
+void FloatToSamples(const float* src, int format, uint8_t* dst, int count);
+
+// Correlation kernels of the segment search. The SIMD variant is chosen once at runtime, like the YUV kernels.
+DotProductKernel GetDotProductKernel(void);
+void InitDotProductKernel(void);
+
+float DotProductScalar(const float* a, const float* b, int count);
+
+#if defined(MEDIA_SIMD_X86)
+MEDIA_TARGET("sse2") float DotProductSSE2(const float* a, const float* b, int count);
+MEDIA_TARGET("avx2") float DotProductAVX2(const float* a, const float* b, int count);
+#endif
+
+#if defined(MEDIA_SIMD_NEON)
+float DotProductNEON(const float* a, const float* b, int count);
+#endif
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Pulled audio
+//---------------------------------------------------------------------------------------------------
+
+// With MEDIA_FLAG_AUDIO_PULL, the AudioStream callback copies the decoded audio out of audioOutputBuffer on the
+// audio thread, whenever raylib needs it, instead of UpdateMediaEx pushing at most one segment per update.
+// UpdateMediaEx decodes the audio ahead of the media time, keeping the buffer half full.
+
+// Take a free slot and set its callback on the AudioStream of the media. Returns false if all slots are in use.
+bool AcquireAudioPullSlot(MediaStream* media);
+
+// Give the slot back. The AudioStream must be unloaded first, so its callback can no longer run.
+void ReleaseAudioPullSlot(MediaContext* ctx);
+
+void LockAudioPull(MediaContext* ctx);                      // Wait for the running callback, then keep it away from the buffer.
+void UnlockAudioPull(MediaContext* ctx);                    // Let the callback read the buffer again.
+
+// Drop the decoded audio, e.g. after a seek. Takes the pull lock if needed.
+void ClearMediaAudio(MediaContext* ctx);
+
+// Body of the slot callbacks, on the audio thread: copies frames from the buffer of the slot media, then fills
+// what is missing with silence.
+void PullMediaAudio(int slotIndex, void* buffer, unsigned int frames);
+
+AudioCallback GetAudioPullCallback(int slotIndex);          // Callback of a slot.
+
+void PullAudioSlot0(void* buffer, unsigned int frames);
+void PullAudioSlot1(void* buffer, unsigned int frames);
+void PullAudioSlot2(void* buffer, unsigned int frames);
+void PullAudioSlot3(void* buffer, unsigned int frames);
+void PullAudioSlot4(void* buffer, unsigned int frames);
+void PullAudioSlot5(void* buffer, unsigned int frames);
+void PullAudioSlot6(void* buffer, unsigned int frames);
+void PullAudioSlot7(void* buffer, unsigned int frames);
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - YUV to RGB conversion kernels
+//---------------------------------------------------------------------------------------------------
+
+// Built-in converters for the common same-size conversions (YUV420P, YUVJ420P and NV12 to RGB24/RGBA32), used instead
+// of swscale when SetMediaFlag(MEDIA_VIDEO_FAST_CONVERT, 1) (default). They support the BT.601 and BT.709 matrices in
+// limited or full range, as tagged in the stream; other color spaces are left to swscale.
+// Each chroma sample is repeated for its pixel pair (nearest sampling), which swscale with SWS_BILINEAR doesn't
+// guarantee: results may differ by a few levels at chroma edges (see examples/bench/bench_yuv.c). Coefficients are
+// 6-bit fixed point, so the 16-bit SIMD lanes can't overflow before the saturating additions.
+// - Row kernels convert one row: chroma samples are shared by pixel pairs. For NV12, u holds the interleaved
+//   chroma and v is unused.
+// - The SIMD variant is chosen once at runtime from the CPU features reported by libavutil.
+
+YUVRowKernel GetYUVRowKernel(enum AVPixelFormat format);	// Best row kernel for a source format, NULL if not supported.
+void InitYUVRowKernels(void);								// Select the kernels for the running CPU (called once).
+
+// Coefficients for the color space and range of a decoder, NULL if the kernels don't support them.
+// Untagged video is BT.601, as for swscale; YUVJ formats are full range.
+const YUVCoefficients* GetYUVCoefficients(const AVCodecContext* codecCtx);
+
+// Make swscale convert from the color space and range of the decoder, like the kernels (its default is BT.601).
+void AVSetSwsColorspace(struct SwsContext* swsContext, const AVCodecContext* codecCtx);
+
+// Convert rows [rowStart, rowEnd) of a YUV420P or NV12 frame into an RGB24 or RGBA32 image (pixelSize 3 or 4).
+void ConvertYUVRows(YUVRowKernel kernel, const YUVCoefficients* coef, const AVFrame* frame, uint8_t* dst, int dstLineSize, int width, int pixelSize, int rowStart, int rowEnd);
+
+void ConvertI420RowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+void ConvertNV12RowScalar(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+
+#if defined(MEDIA_SIMD_X86)
+MEDIA_TARGET("sse2") void ConvertI420RowSSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+MEDIA_TARGET("sse2") void ConvertNV12RowSSE2(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+MEDIA_TARGET("avx2") void ConvertI420RowAVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+MEDIA_TARGET("avx2") void ConvertNV12RowAVX2(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+#endif
+
+#if defined(MEDIA_SIMD_NEON)
+void ConvertI420RowNEON(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+void ConvertNV12RowNEON(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef);
+#endif
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Background workers
+//---------------------------------------------------------------------------------------------------
+
+bool StartWorker(MediaWorker* worker, MediaContext* ctx, int (*step)(MediaContext*));	// Start a worker thread running step(ctx) until stopped.
+void StopWorker(MediaWorker* worker);						// Ask a worker to exit and wait for its thread to finish.
+void UnloadWorker(MediaWorker* worker);						// Free the wake-up primitives of a stopped dedicated worker.
+void* RunWorker(void* worker);								// Worker thread entry point.
+
+bool StartMediaWorkers(MediaContext* ctx);					// Start the background workers requested at load time. Returns true if any is running.
+bool StopMediaWorkers(MediaContext* ctx);					// Stop all background workers of a context. Returns true if any was running.
+void WakeMediaWorkers(MediaContext* ctx);					// Schedule or resume the idle workers of a context.
+
+void WakeWorker(MediaWorker* worker);						// Schedule an idle pooled worker again, or resume an idle dedicated one.
+void RunWorkerJob(void* worker);							// Pool job running a single step of a pooled worker.
+void ReleaseContextJob(MediaContext* ctx);					// Account for the end of a pool job of a context, waking StopWorker on the last one.
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Shared worker pool
+//---------------------------------------------------------------------------------------------------
+
+bool LoadJobDeque(JobDeque* deque, int capacity);			// Initialize a job deque in place.
+void UnloadJobDeque(JobDeque* deque);						// Free memory associated with the deque.
+bool PushJobBack(JobDeque* deque, PoolJob job);				// Append a job, growing the deque if needed. Returns false on allocation failure.
+bool PopJobFront(JobDeque* deque, PoolJob* job);			// Take the oldest job. Returns false if the deque is empty.
+bool PopJobBack(JobDeque* deque, PoolJob* job);				// Take the newest job. Returns false if the deque is empty.
+
+bool AcquireWorkerPool(void);								// Start the pool if needed and register a user. Returns false on failure.
+void ReleaseWorkerPool(void);								// Unregister a user; the last one shuts the pool down (no jobs may be pending).
+bool SubmitPoolJob(PoolJob job);							// Queue a job on the pool. Returns false on failure.
+bool SubmitUrgentPoolJob(PoolJob job);						// Queue a job that runs before any other. Returns false on failure.
+void SignalPoolJob(void);									// Account for a newly queued job and wake a pool thread.
+bool TakePoolJob(PoolJob* job);								// Take a job for the calling pool thread, stealing it if needed.
+bool TakeUrgentPoolJob(PoolJob* job);						// Take an urgent job, from any thread. Returns false if there is none.
+void* RunPoolThread(void* index);							// Pool thread entry point.
+
+void SetJobStatus(atomic_int* status, int value);			// Store the status of a job and wake the threads waiting for it to change.
+void WaitJobStatus(atomic_int* status, int pendingValue);	// Block until a status set with SetJobStatus differs from pendingValue.
+
+
+#if defined(_MSC_VER)
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Win32 threads (MSVC)
+//---------------------------------------------------------------------------------------------------
+
+// The pthread calls used by the library, on Win32 primitives: slim reader/writer locks for mutexes, condition
+// variables and one-time initialization. Attributes are not supported (NULL only), nor thread return values.
+// Named after the library, as the application or FFmpeg may link a pthreads implementation too.
+
+int MediaThreadCreate(pthread_t* thread, const void* attr, void* (*start)(void*), void* arg);
+int MediaThreadJoin(pthread_t thread, void** value);
+int MediaMutexInit(pthread_mutex_t* mutex, const void* attr);
+int MediaMutexDestroy(pthread_mutex_t* mutex);
+int MediaMutexLock(pthread_mutex_t* mutex);
+int MediaMutexUnlock(pthread_mutex_t* mutex);
+int MediaCondInit(pthread_cond_t* cond, const void* attr);
+int MediaCondDestroy(pthread_cond_t* cond);
+int MediaCondWait(pthread_cond_t* cond, pthread_mutex_t* mutex);
+int MediaCondSignal(pthread_cond_t* cond);
+int MediaCondBroadcast(pthread_cond_t* cond);
+int MediaCallOnce(pthread_once_t* once, void (*init)(void));
+int MediaThreadYield(void);
+
+unsigned __stdcall RunWin32Thread(void* start);				// _beginthreadex entry point, calling a pthread start routine.
+BOOL CALLBACK RunWin32Once(PINIT_ONCE once, PVOID init, PVOID* context);	// InitOnceExecuteOnce callback, calling init.
+#endif
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Declaration - Media Context loading and unloading
@@ -322,8 +1475,21 @@ void AVUnloadCodecContext(StreamDataContext* streamCtx);
 // Returns: Pointer to the allocated MediaContext on success, or NULL on failure.
 MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamReader, int flags);
 
+// Open the format and codec contexts and allocate everything needed for playback into a zeroed MediaContext.
+// Thread safe: makes no raylib GPU or audio call, reads the settings and audio device state captured by the loading
+// call (MediaContext.config, audioDeviceReady) and leaves ctx->state untouched, so it can run in the background.
+// Returns false on failure; the caller must free the context with UnloadMediaContext.
+bool OpenMediaContext(MediaContext* ctx, const char* fileName, MediaStreamReader streamReader, int flags);
+
+// Make an opened MediaContext playable: sets the STOPPED state and starts the background workers.
+void StartMediaContext(MediaContext* ctx);
+
 void UnloadMediaContext(MediaContext* ctx);
 
+void RunLoadJob(void* ctx);                               // Pool job running OpenMediaContext for LoadMediaAsync.
+void WaitMediaLoad(MediaContext* ctx);                    // Block until the load job of a context is done.
+int AVInterruptCallback(void* ctx);                       // libav interrupt callback, aborts blocking calls of a pending load.
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Declaration - Helpers
@@ -343,6 +1509,34 @@ void UpdateState(const MediaStream* media, int newState); // Helper function to
 
 bool HasStream(const MediaContext* ctx, int streamType);  // Checks if the media has an available VIDEO_STREAM or AUDIO_STREAM.
 
+// Creates the textures receiving the video frames: videoTexture, or videoPlanes with MEDIA_FLAG_VIDEO_YUV.
+// Must be called from the main thread. Returns false on failure, leaving no texture.
+bool LoadVideoTextures(MediaStream* media);
+void UnloadVideoTextures(MediaStream* media);              // Frees the textures created by LoadVideoTextures.
+
+// Starts replacing the frame in videoOutputImage (main thread). Returns false if the frame is borrowed and must
+// stay untouched; the caller then keeps its new frame for a later update. Must be followed by EndVideoFrameWrite.
+bool BeginVideoFrameWrite(MediaContext* ctx);
+void EndVideoFrameWrite(MediaContext* ctx);                // Ends a frame replacement, counting the new frame.
+
+bool AcquireYUVShader(void);                               // Load the shared YUV shader if needed and register a user.
+void ReleaseYUVShader(void);                               // Unregister a user; the last one unloads the shader.
+
+// GLSL header of the YUV shader for a rlGetVersion() value, in the flavor of the raylib default vertex shader of
+// that version. Returns NULL if the version has no shader support.
+const char* GetYUVShaderHeader(int glVersion);
+
+// Compile the YUV shader with a GLSL header, linked with vsCode (NULL: raylib default vertex shader).
+// Returns an empty shader on failure.
+Shader LoadYUVShader(const char* header, const char* vsCode);
+
+// Uploads the latest due frame decoded by the decode worker, skipping the older ones.
+// Returns MEDIA_RET_SUCCEED, or the worker status (e.g. MEDIA_EOF) once all its frames were presented.
+int PresentDecodedFrame(const MediaStream* media);
+
+// Body of UpdateMediaEx: advances the media time, then decodes and presents what is due.
+bool UpdateMediaStreams(MediaStream* media, double deltaTime);
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - MediaConfigFlags settings
@@ -402,46 +1596,108 @@ int SetMediaFlag(int flag, int value)
 		MEDIA.audioMaxUpdateSize = MAX(value, 1024);
 		break;	
 
-	default:
-		ret = -1; // Flag not recognized
+	case MEDIA_VIDEO_FRAME_QUEUE:
+		MEDIA.videoFrameQueueSize = MAX(value, 2);
 		break;
-	}
-
-	return ret;
-}
-
-int GetMediaFlag(int flag)
-{
-	int ret = -1; 
 
-	switch (flag)
-	{
-	case MEDIA_IO_BUFFER:
-		ret = MEDIA.ioBufferSize;
+	case MEDIA_WORKER_THREADS:
+		MEDIA.workerThreads = CLAMP(value, 0, MEDIA_POOL_MAX_THREADS);
 		break;
 
-	case MEDIA_VIDEO_QUEUE:
-		ret = MEDIA.videoQueueSize;
+	case MEDIA_DECODE_THREADS:
+		MEDIA.decodeThreads = MAX(value, 0);
 		break;
 
-	case MEDIA_AUDIO_QUEUE:
-		ret = MEDIA.audioQueueSize;
+	case MEDIA_DECODE_THREAD_TYPE:
+		if (value & (MEDIA_DECODE_THREAD_FRAME | MEDIA_DECODE_THREAD_SLICE))
+		{
+			MEDIA.decodeThreadType = value & (MEDIA_DECODE_THREAD_FRAME | MEDIA_DECODE_THREAD_SLICE);
+		}
+		else
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Invalid decoder thread type (%i).", value);
+		}
 		break;
 
-	case MEDIA_AUDIO_DECODED_BUFFER:
-		ret = MEDIA.audioDecodedBufferSize;
+	case MEDIA_VIDEO_CONVERT_BANDS:
+		MEDIA.videoConvertBands = CLAMP(value, 0, MEDIA_POOL_MAX_THREADS);
 		break;
 
-	case MEDIA_AUDIO_STREAM_BUFFER:
-		ret = MEDIA.audioStreamBufferSize;
+	case MEDIA_VIDEO_KEYFRAME_JUMP:
+		MEDIA.keyframeJumpDelay = MAX(0, value) / 1000.0;
 		break;
 
-	case MEDIA_AUDIO_FORMAT:
-		ret = MEDIA.audioOutputFmt;
+	case MEDIA_VIDEO_FAST_CONVERT:
+		MEDIA.videoFastConvert = value != 0;
 		break;
 
-	case MEDIA_AUDIO_CHANNELS:
-		ret = MEDIA.audioOutputChannels;
+	case MEDIA_VIDEO_FORMAT:
+		if (value != PIXELFORMAT_UNCOMPRESSED_R8G8B8 && value != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Unsupported video format %i, only R8G8B8 and R8G8B8A8 are available.", value);
+			ret = -1;
+			break;
+		}
+
+		MEDIA.videoFormat = value;
+		break;
+
+	case MEDIA_VIDEO_OUTPUT_WIDTH:
+		MEDIA.videoOutputWidth = MAX(0, value);
+		break;
+
+	case MEDIA_VIDEO_OUTPUT_HEIGHT:
+		MEDIA.videoOutputHeight = MAX(0, value);
+		break;
+
+	case MEDIA_VIDEO_GOP_CACHE:
+		MEDIA.gopCacheSize = MAX(0, value);
+		break;
+
+	case MEDIA_VIDEO_REVERSE_FRAMES:
+		MEDIA.reverseFrames = MAX(2, value);
+		break;
+
+	default:
+		ret = -1; // Flag not recognized
+		break;
+	}
+
+	return ret;
+}
+
+int GetMediaFlag(int flag)
+{
+	int ret = -1; 
+
+	switch (flag)
+	{
+	case MEDIA_IO_BUFFER:
+		ret = MEDIA.ioBufferSize;
+		break;
+
+	case MEDIA_VIDEO_QUEUE:
+		ret = MEDIA.videoQueueSize;
+		break;
+
+	case MEDIA_AUDIO_QUEUE:
+		ret = MEDIA.audioQueueSize;
+		break;
+
+	case MEDIA_AUDIO_DECODED_BUFFER:
+		ret = MEDIA.audioDecodedBufferSize;
+		break;
+
+	case MEDIA_AUDIO_STREAM_BUFFER:
+		ret = MEDIA.audioStreamBufferSize;
+		break;
+
+	case MEDIA_AUDIO_FORMAT:
+		ret = MEDIA.audioOutputFmt;
+		break;
+
+	case MEDIA_AUDIO_CHANNELS:
+		ret = MEDIA.audioOutputChannels;
 		break;
 
 	case MEDIA_VIDEO_MAX_DELAY:
@@ -456,6 +1712,54 @@ int GetMediaFlag(int flag)
 		ret = MEDIA.audioMaxUpdateSize;
 		break;
 
+	case MEDIA_VIDEO_FRAME_QUEUE:
+		ret = MEDIA.videoFrameQueueSize;
+		break;
+
+	case MEDIA_WORKER_THREADS:
+		ret = MEDIA.workerThreads;
+		break;
+
+	case MEDIA_DECODE_THREADS:
+		ret = MEDIA.decodeThreads;
+		break;
+
+	case MEDIA_DECODE_THREAD_TYPE:
+		ret = MEDIA.decodeThreadType;
+		break;
+
+	case MEDIA_VIDEO_CONVERT_BANDS:
+		ret = MEDIA.videoConvertBands;
+		break;
+
+	case MEDIA_VIDEO_KEYFRAME_JUMP:
+		ret = (int)(MEDIA.keyframeJumpDelay * 1000);
+		break;
+
+	case MEDIA_VIDEO_FAST_CONVERT:
+		ret = MEDIA.videoFastConvert;
+		break;
+
+	case MEDIA_VIDEO_FORMAT:
+		ret = MEDIA.videoFormat;
+		break;
+
+	case MEDIA_VIDEO_OUTPUT_WIDTH:
+		ret = MEDIA.videoOutputWidth;
+		break;
+
+	case MEDIA_VIDEO_OUTPUT_HEIGHT:
+		ret = MEDIA.videoOutputHeight;
+		break;
+
+	case MEDIA_VIDEO_GOP_CACHE:
+		ret = MEDIA.gopCacheSize;
+		break;
+
+	case MEDIA_VIDEO_REVERSE_FRAMES:
+		ret = MEDIA.reverseFrames;
+		break;
+
 	default:
 		break;
 	}
@@ -491,6 +1795,90 @@ MediaProperties GetMediaProperties(MediaStream media)
 	return props;
 }
 
+MediaStats GetMediaStats(MediaStream media)
+{
+	MediaStats stats = (MediaStats){ 0 };
+
+	if (IsMediaValid(media))
+	{
+		stats.decodedVideoFrames   = atomic_load(&media.ctx->decodedVideoFrames);
+		stats.presentedVideoFrames = atomic_load(&media.ctx->presentedVideoFrames);
+		stats.droppedVideoFrames   = atomic_load(&media.ctx->droppedVideoFrames);
+		stats.avoidedVideoConversions = atomic_load(&media.ctx->avoidedVideoConversions);
+		stats.skippedVideoPackets = atomic_load(&media.ctx->skippedVideoPackets);
+		stats.keyframeJumps = atomic_load(&media.ctx->keyframeJumps);
+		stats.videoConvertTime = atomic_load(&media.ctx->videoConvertTime) / 1e6;
+		stats.videoUploadTime = atomic_load(&media.ctx->videoUploadTime) / 1e6;
+		stats.frameBufferAllocations = HasStream(media.ctx, STREAM_VIDEO) ? atomic_load(&media.ctx->streams[STREAM_VIDEO].frameBufferAllocations) : 0;
+
+		const KeyframeIndex* index = GetKeyframeIndex(media.ctx);
+		stats.indexedKeyframes = index ? index->count : 0;
+		stats.indexedSeeks = atomic_load(&media.ctx->indexedSeeks);
+
+		stats.seeks = media.ctx->seekCount;
+		stats.seekTime = media.ctx->seekTime / 1e6;
+		stats.lastSeekTime = media.ctx->lastSeekTime / 1e6;
+		stats.lastSeekDecodedFrames = media.ctx->lastSeekDecodedFrames;
+		stats.coalescedSeeks = media.ctx->coalescedSeeks;
+
+		const GopCache* cache = &media.ctx->gopCache;
+		stats.gopCacheHits = atomic_load(&cache->hits);
+		stats.gopCacheMisses = atomic_load(&cache->misses);
+		stats.gopCacheHitRate = (stats.gopCacheHits + stats.gopCacheMisses) > 0 ?
+			(double)stats.gopCacheHits / (stats.gopCacheHits + stats.gopCacheMisses) : 0.0;
+		stats.gopCacheFrames = atomic_load(&cache->frames);
+		stats.gopCacheMemory = atomic_load(&cache->memory);
+
+		stats.reverseSegments = atomic_load(&media.ctx->reverseSegmentCount);
+		stats.reverseDecodedFrames = atomic_load(&media.ctx->reverseDecodedFrames);
+		stats.reverseStalls = media.ctx->reverseStalls;
+
+		stats.forwardSteps = media.ctx->forwardSteps;
+		stats.backwardSteps = media.ctx->backwardSteps;
+		stats.forwardStepTime = media.ctx->forwardStepTime / 1e6;
+		stats.backwardStepTime = media.ctx->backwardStepTime / 1e6;
+		stats.lastStepTime = media.ctx->lastStepTime / 1e6;
+
+		stats.playbackRate = media.ctx->playbackRate;
+		stats.audioDrift = GetAudioDrift(media.ctx);
+		stats.droppedAudioPackets = media.ctx->droppedAudioPackets;
+		stats.audioOverflows = media.ctx->audioOverflows;
+		stats.audioUnderruns = atomic_load(&media.ctx->audioUnderruns);
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to retrieve stats of an invalid media.");
+	}
+
+	return stats;
+}
+
+MediaMemoryStats GetMediaMemoryStats(MediaStream media)
+{
+	MediaMemoryStats stats = (MediaMemoryStats){ 0 };
+
+	stats.global = GetMemoryUsage(&MEDIA_MEMORY);
+
+	if (IsMediaValid(media))
+	{
+		const MediaContext* ctx = media.ctx;
+
+		stats.total  = GetMemoryUsage(&ctx->memory);
+		stats.video  = GetMemoryUsage(&ctx->streams[STREAM_VIDEO].memory);
+		stats.audio  = GetMemoryUsage(&ctx->streams[STREAM_AUDIO].memory);
+		stats.shared = GetMemoryUsage(&ctx->sharedMemory);
+		stats.allocations = atomic_load(&ctx->memory.allocations);
+		stats.updateAllocations = atomic_load(&ctx->updateAllocations);
+		stats.workerAllocations = atomic_load(&ctx->memory.workerAllocations);
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to retrieve memory stats of an invalid media.");
+	}
+
+	return stats;
+}
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - Media play management
@@ -507,7 +1895,111 @@ bool SetMediaPosition(MediaStream media, double timeSec)
 
 	timeSec = MAX(0, timeSec);
 
-	return AVSeek(&media, (int64_t)(timeSec * AV_TIME_BASE));
+	return AVSeek(&media, (int64_t)(timeSec * AV_TIME_BASE), media.ctx->accurateSeek);
+}
+
+bool SetMediaPositionAsync(MediaStream media, double timeSec)
+{
+	if(!IsMediaValid(media))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the position of an invalid media.");
+		return false;
+	}
+
+	MediaContext* ctx = media.ctx;
+
+	ctx->seekTarget = (int64_t)(MAX(0, timeSec) * AV_TIME_BASE);
+
+	// A seek is running: only the latest target is kept, and runs once that seek is done
+	if (atomic_load(&ctx->seekStatus) != SEEK_STATUS_IDLE)
+	{
+		if (ctx->seekQueued)
+		{
+			ctx->coalescedSeeks++;
+		}
+
+		ctx->seekQueued = true;
+
+		// The running job decodes towards a target nobody wants anymore
+		atomic_store(&ctx->abortSeek, true);
+
+		return true;
+	}
+
+	if (!ctx->seekHoldsPool)
+	{
+		ctx->seekHoldsPool = AcquireWorkerPool();
+	}
+
+	if (!ctx->seekHoldsPool)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Worker pool unavailable, seeking synchronously.");
+		return AVSeek(&media, ctx->seekTarget, ctx->accurateSeek);
+	}
+
+	AVSeekBegin(&media);
+
+	SubmitMediaSeek(ctx, ctx->seekTarget);
+
+	return true;
+}
+
+bool IsMediaSeekPending(MediaStream media)
+{
+	return IsMediaValid(media) && atomic_load(&media.ctx->seekStatus) != SEEK_STATUS_IDLE;
+}
+
+bool StepMediaFrame(MediaStream media, int frames)
+{
+	if (!IsMediaValid(media) || !HasStream(media.ctx, STREAM_VIDEO))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to step through the frames of an invalid media or a media without video.");
+		return false;
+	}
+
+	MediaContext* ctx = media.ctx;
+
+	if (frames == 0)
+	{
+		return true;
+	}
+
+	const int64_t stepStart = av_gettime_relative();
+
+	// Steps start from the frame of a pending asynchronous seek
+	while (!PollMediaSeek(&media))
+	{
+		WaitMediaSeek(ctx);
+	}
+
+	// Reverse playback holds the decoder somewhere before the displayed frame
+	if (ctx->reversePlay)
+	{
+		AVSeek(&media, (int64_t)(ctx->videoFrameTime * AV_TIME_BASE) + 1, true);
+	}
+
+	const bool ret = frames > 0 ? AVStepForward(&media, frames) : AVStepBackward(&media, -frames);
+
+	// The media time lands on the frame boundary
+	ctx->timePos = ctx->videoFrameTime;
+
+	if (ret)
+	{
+		ctx->lastStepTime = av_gettime_relative() - stepStart;
+
+		if (frames > 0)
+		{
+			ctx->forwardSteps++;
+			ctx->forwardStepTime += ctx->lastStepTime;
+		}
+		else
+		{
+			ctx->backwardSteps++;
+			ctx->backwardStepTime += ctx->lastStepTime;
+		}
+	}
+
+	return ret;
 }
 
 double GetMediaPosition(MediaStream media)
@@ -516,7 +2008,9 @@ double GetMediaPosition(MediaStream media)
 
 	if (IsMediaValid(media))
 	{
-		pos = media.ctx->timePos;
+		// The seek job owns timePos until it's done
+		pos = atomic_load(&media.ctx->seekStatus) != SEEK_STATUS_IDLE ?
+			(double)media.ctx->seekTarget / AV_TIME_BASE : media.ctx->timePos;
 	}
 	else
 	{
@@ -526,124 +2020,478 @@ double GetMediaPosition(MediaStream media)
 	return pos;
 }
 
-bool SetMediaLooping(MediaStream media, bool loopPlay)
+Image GetMediaImage(MediaStream media)
 {
-	int ret = false;
+	Image image = (Image){ 0 };
 
 	if (IsMediaValid(media))
 	{
-		media.ctx->loopPlay = loopPlay;
-		ret = true;
+		image = media.ctx->videoOutputImage;
 	}
 	else
 	{
-		TraceLog(LOG_WARNING, "MEDIA: Trying to set the looping mode of an invalid media.");
+		TraceLog(LOG_WARNING, "MEDIA: Trying to retrieve the image of an invalid media.");
 	}
 
-	return ret;
+	return image;
 }
 
+bool SetMediaOutputSize(MediaStream* media, int width, int height)
+{
+	assert(media);
 
-//---------------------------------------------------------------------------------------------------
-// Functions Definition - Media Context loading and unloading
-//---------------------------------------------------------------------------------------------------
+	if (!IsMediaValid(*media) || !HasStream(media->ctx, STREAM_VIDEO))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the output size of an invalid media or a media without video.");
+		return false;
+	}
 
-MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamReader, int flags)
-{
-	MediaContext* ctx = (MediaContext*) RL_MALLOC(sizeof(MediaContext));
+	MediaContext* ctx = media->ctx;
 
-	*ctx = (MediaContext){ 0 };
+	const int previousWidth = ctx->videoOutputImage.width;
+	const int previousHeight = ctx->videoOutputImage.height;
 
-	ctx->state = MEDIA_STATE_INVALID;
+	int outputWidth = 0;
+	int outputHeight = 0;
 
-	ctx->formatContext = avformat_alloc_context();
+	AVGetVideoOutputSize(ctx->streams[STREAM_VIDEO].codecCtx, MAX(0, width), MAX(0, height), &outputWidth, &outputHeight);
 
-	if (!ctx->formatContext)
+	if (outputWidth == previousWidth && outputHeight == previousHeight)
 	{
-		TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVFormatContext");
-		UnloadMediaContext(ctx);
-		return NULL;
+		return true;
 	}
 
-	// If a custom read function is provided, set up the AVIOContext for custom IO
-	if (streamReader.readFn)
+	if (!BeginVideoFrameWrite(ctx))
 	{
-		// Allocate buffer for AVIOContext
-		unsigned char* ioBuffer = av_malloc(MEDIA.ioBufferSize);
-		if (!ioBuffer)
-		{
-			TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVIOContext buffer");
-			UnloadMediaContext(ctx); // Free resources and exit on error
-			return NULL;
-		}
+		TraceLog(LOG_WARNING, "MEDIA: Cannot resize the video output while a frame is borrowed.");
+		return false;
+	}
 
-		// Allocate and initialize the AVIOContext for custom IO
-		AVIOContext* avIOContext = avio_alloc_context(
-			ioBuffer,                        // Buffer for IO operations
-			MEDIA.ioBufferSize,              // Size of the buffer in bytes
-			0,                               // Write flag (0 for read-only operations)
-			streamReader.userData,           // Opaque pointer to custom stream context
-			streamReader.readFn,             // Custom read function
-			NULL,                            // Custom write function (NULL for read-only)
-			streamReader.seekFn              // Custom seek function (NULL if not supported)
-		);
+	// A seek job clears the frame queue too
+	InterruptMediaSeek(ctx);
 
-		if (!avIOContext)
-		{
-			TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVIOContext");
-			av_freep(&ioBuffer);         // Free the allocated buffer on failure
-			UnloadMediaContext(ctx);        // Free resources and exit on error
-			return NULL;
-		}
+	// The decode worker converts into the frame queue, which is about to be replaced.
+	// Frames already queued are lost, playback resumes with the next decoded one.
+	const bool resumeWorkers = StopMediaWorkers(ctx);
 
-		// Assign the custom AVIOContext to the format context
-		ctx->formatContext->pb = avIOContext;
+	AVUnloadVideoOutput(ctx);
 
-		// Set the custom IO flag for the format context
-		ctx->formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
-	}
+	bool ret = AVLoadVideoOutput(ctx, outputWidth, outputHeight);
 
-	int ret = avformat_open_input(&ctx->formatContext, fileName, NULL, NULL);
+	if (!ret)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed to resize the video output to %ix%i, keeping %ix%i.", outputWidth, outputHeight, previousWidth, previousHeight);
 
-	if ( ret < 0) {
-		AVPrintError(ret);
-		UnloadMediaContext(ctx);
-		return NULL;
+		if (!AVLoadVideoOutput(ctx, previousWidth, previousHeight))
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Failed to restore the video output.");
+		}
 	}
 
-	ret = avformat_find_stream_info(ctx->formatContext, NULL);
+	// Conversion bands of the new size may need the shared worker pool
+	if (!ctx->usesPool && ctx->convertBandCount > 1)
+	{
+		ctx->usesPool = AcquireWorkerPool();
 
-	if (ret < 0) {
-		AVPrintError(ret);
-		UnloadMediaContext(ctx);
-		return NULL;
+		if (!ctx->usesPool)
+		{
+			AVUnloadConvertBands(ctx);
+		}
 	}
 
-	for (int i = 0; i < (int)ctx->formatContext->nb_streams; i++)
+	if (ret && !ctx->headless)
 	{
-		const AVCodecParameters* localCodecParameters = ctx->formatContext->streams[i]->codecpar;
+		UnloadVideoTextures(media);
 
-		const AVCodec* localCodec = avcodec_find_decoder(localCodecParameters->codec_id);
-
-		if (localCodec == NULL) 
+		if (!LoadVideoTextures(media))
 		{
-			TraceLog(LOG_WARNING, "MEDIA: Unsupported codec.");
-
-			continue;
+			TraceLog(LOG_ERROR, "MEDIA: Failed to create the video textures of the new size.");
+			ret = false;
 		}
+	}
 
-		if (localCodecParameters->codec_type == AVMEDIA_TYPE_VIDEO &&
-			(flags & MEDIA_LOAD_NO_VIDEO) == 0)
-		{
-			StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+	if (resumeWorkers)
+	{
+		StartMediaWorkers(ctx);
+	}
 
-			ret = AVLoadCodecContext(videoCtx, localCodec, localCodecParameters);
+	EndVideoFrameWrite(ctx);
 
-			if(ret == MEDIA_RET_SUCCEED)
-			{
-				//-------------------------------------------------------------
+	return ret;
+}
 
-				videoCtx->streamIdx = -1;
+bool AcquireMediaFrame(MediaStream media, MediaFrame* frame)
+{
+	assert(frame);
+
+	*frame = (MediaFrame){ 0 };
+
+	if (!IsMediaValid(media) || !HasStream(media.ctx, STREAM_VIDEO))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to acquire the frame of an invalid media or a media without video.");
+		return false;
+	}
+
+	MediaContext* ctx = media.ctx;
+
+	atomic_fetch_add(&ctx->frameBorrowers, 1);
+
+	// A frame replacement already in progress can't see this borrower, let it end (see BeginVideoFrameWrite).
+	// Frames are swapped in, so this is short, except while SetMediaOutputSize reloads the output.
+	WaitJobStatus(&ctx->frameWriting, true);
+
+	uint8_t* planes[4] = { 0 };
+	int lineSizes[4] = { 0 };
+
+	AVGetVideoPlanes(ctx, ctx->videoOutputImage.data, planes, lineSizes);
+
+	for (int i = 0; i < 4 && planes[i]; ++i)
+	{
+		frame->data[i] = planes[i];
+		frame->lineSize[i] = lineSizes[i];
+		frame->planeCount++;
+	}
+
+	switch (ctx->videoOutputFormat)
+	{
+	case AV_PIX_FMT_RGBA:     frame->format = MEDIA_FRAME_RGBA32; break;
+	case AV_PIX_FMT_YUV420P:  frame->format = MEDIA_FRAME_YUV420P; break;
+	case AV_PIX_FMT_YUVJ420P: frame->format = MEDIA_FRAME_YUVJ420P; break;
+	case AV_PIX_FMT_NV12:     frame->format = MEDIA_FRAME_NV12; break;
+	default:                  frame->format = MEDIA_FRAME_RGB24; break;
+	}
+
+	frame->width = ctx->videoOutputImage.width;
+	frame->height = ctx->videoOutputImage.height;
+	frame->time = ctx->videoFrameTime;
+	frame->sequence = ctx->videoFrameSequence;
+
+	return true;
+}
+
+void ReleaseMediaFrame(MediaStream media, MediaFrame* frame)
+{
+	assert(frame);
+
+	if (!media.ctx || !frame->data[0])
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to release a frame that was not acquired.");
+		return;
+	}
+
+	atomic_fetch_sub(&media.ctx->frameBorrowers, 1);
+
+	*frame = (MediaFrame){ 0 };
+}
+
+bool SetMediaTextureUpload(MediaStream media, bool upload)
+{
+	if (!IsMediaValid(media))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the texture upload of an invalid media.");
+		return false;
+	}
+
+	MediaContext* ctx = media.ctx;
+
+	// The textures missed the frames decoded while disabled
+	if (upload && !ctx->textureUpload)
+	{
+		ctx->textureUpload = true;
+
+		if (HasStream(ctx, STREAM_VIDEO))
+		{
+			AVUploadVideoImage(&media);
+		}
+	}
+
+	ctx->textureUpload = upload;
+
+	return true;
+}
+
+void DrawMediaVideo(MediaStream media, Rectangle source, Rectangle dest, Color tint)
+{
+	if (!IsMediaValid(media) || !HasStream(media.ctx, STREAM_VIDEO))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to draw an invalid media or a media without video.");
+		return;
+	}
+
+	if (!media.ctx->yuvOutput)
+	{
+		DrawTexturePro(media.videoTexture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, tint);
+		return;
+	}
+
+	const Shader shader = GetMediaVideoShader(media);
+
+	BeginShaderMode(shader);
+
+	// The luma plane is bound to texture0 by the draw call, chroma planes to the next units
+	SetShaderValueTexture(shader, YUV_SHADER.texture1Loc, media.videoPlanes[1]);
+
+	if (IsTextureValid(media.videoPlanes[2]))
+	{
+		SetShaderValueTexture(shader, YUV_SHADER.texture2Loc, media.videoPlanes[2]);
+	}
+
+	DrawTexturePro(media.videoPlanes[0], source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, tint);
+
+	EndShaderMode();
+}
+
+Shader GetMediaVideoShader(MediaStream media)
+{
+	if (!IsMediaValid(media) || !media.ctx->yuvShaderUser)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to get the video shader of a media without YUV video textures.");
+		return (Shader){ 0 };
+	}
+
+	const MediaContext* ctx = media.ctx;
+	const int semiPlanar = (ctx->videoOutputFormat == AV_PIX_FMT_NV12);
+
+	SetShaderValue(YUV_SHADER.shader, YUV_SHADER.semiPlanarLoc, &semiPlanar, SHADER_UNIFORM_INT);
+	SetShaderValue(YUV_SHADER.shader, YUV_SHADER.fullRangeLoc, &ctx->yuvFullRange, SHADER_UNIFORM_INT);
+	SetShaderValue(YUV_SHADER.shader, YUV_SHADER.colorMatrixLoc, &ctx->yuvColorMatrix, SHADER_UNIFORM_INT);
+
+	return YUV_SHADER.shader;
+}
+
+bool SetMediaAudioCallback(MediaStream media, MediaAudioCallback callback, void* userData)
+{
+	bool ret = false;
+
+	if (IsMediaValid(media) && media.ctx->pullAudio)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Cannot set the audio callback of a media pulling its audio (MEDIA_FLAG_AUDIO_PULL).");
+	}
+	else if (IsMediaValid(media))
+	{
+		media.ctx->audioCallback = callback;
+		media.ctx->audioCallbackData = userData;
+		ret = true;
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the audio callback of an invalid media.");
+	}
+
+	return ret;
+}
+
+bool SetMediaLooping(MediaStream media, bool loopPlay)
+{
+	int ret = false;
+
+	if (IsMediaValid(media))
+	{
+		media.ctx->loopPlay = loopPlay;
+		ret = true;
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the looping mode of an invalid media.");
+	}
+
+	return ret;
+}
+
+bool SetMediaPlaybackRate(MediaStream media, double rate)
+{
+	if (!IsMediaValid(media))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to set the playback rate of an invalid media.");
+		return false;
+	}
+
+	// CLAMP would let a NaN through
+	if (!isfinite(rate))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Invalid playback rate.");
+		return false;
+	}
+
+	MediaContext* ctx = media.ctx;
+
+	rate = CLAMP(rate, MEDIA_PLAYBACK_RATE_MIN, MEDIA_PLAYBACK_RATE_MAX);
+
+	// A seek job may be resetting the stretcher
+	InterruptMediaSeek(ctx);
+
+	if (rate != 1.0 && !IsTimeStretchReady(&ctx->timeStretch) && HasStream(ctx, STREAM_AUDIO))
+	{
+		if (!LoadTimeStretch(&ctx->timeStretch, ctx->audioChannels, ctx->audioSampleRate, ctx->audioBytesPerFrame, &ctx->streams[STREAM_AUDIO].memory))
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Cannot allocate the audio time-stretcher.");
+			return false;
+		}
+	}
+
+	ctx->playbackRate = rate;
+	ctx->timeStretch.rate = rate;
+
+	return true;
+}
+
+double GetMediaPlaybackRate(MediaStream media)
+{
+	if (!IsMediaValid(media))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to get the playback rate of an invalid media.");
+		return -1.0;
+	}
+
+	return media.ctx->playbackRate;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Media Context loading and unloading
+//---------------------------------------------------------------------------------------------------
+
+MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamReader, int flags)
+{
+	MediaContext* ctx = (MediaContext*) RL_MALLOC(sizeof(MediaContext));
+
+	*ctx = (MediaContext){ 0 };
+
+	InitMediaMemory(ctx);
+
+	ctx->config = MEDIA;
+	ctx->audioDeviceReady = IsAudioDeviceReady();
+	ctx->state = MEDIA_STATE_INVALID;
+
+	if (!OpenMediaContext(ctx, fileName, streamReader, flags))
+	{
+		UnloadMediaContext(ctx);
+		return NULL;
+	}
+
+	StartMediaContext(ctx);
+
+	return ctx;
+}
+
+bool OpenMediaContext(MediaContext* ctx, const char* fileName, MediaStreamReader streamReader, int flags)
+{
+	// Decoding in the background requires packets to be demuxed in the background too
+	ctx->threadedDecode = (flags & MEDIA_FLAG_THREADED_DECODE) != 0;
+	ctx->threadedDemux = ctx->threadedDecode || (flags & MEDIA_FLAG_THREADED_DEMUX) != 0;
+
+	ctx->fastCatchUp = (flags & MEDIA_FLAG_FAST_CATCH_UP) != 0;
+	ctx->accurateSeek = (flags & MEDIA_FLAG_ACCURATE_SEEK) != 0;
+
+	ctx->gopCache.budget = (long long)ctx->config.gopCacheSize * 1024 * 1024;
+	ctx->gopCache.current = -1;
+
+	ctx->playbackRate = 1.0;
+
+	ctx->headless = (flags & MEDIA_LOAD_HEADLESS) != 0;
+	ctx->yuvOutput = (flags & MEDIA_FLAG_VIDEO_YUV) != 0;
+	ctx->textureUpload = true;
+
+	ctx->formatContext = avformat_alloc_context();
+
+	if (!ctx->formatContext)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVFormatContext");
+		return false;
+	}
+
+	// Lets UnloadMedia interrupt a pending asynchronous load
+	ctx->formatContext->interrupt_callback = (AVIOInterruptCB){ AVInterruptCallback, ctx };
+
+	// If a custom read function is provided, set up the AVIOContext for custom IO
+	if (streamReader.readFn)
+	{
+		// Allocate buffer for AVIOContext
+		unsigned char* ioBuffer = av_malloc(ctx->config.ioBufferSize);
+		if (!ioBuffer)
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVIOContext buffer");
+			return false; // The caller frees the resources
+		}
+
+		// Allocate and initialize the AVIOContext for custom IO
+		AVIOContext* avIOContext = avio_alloc_context(
+			ioBuffer,                        // Buffer for IO operations
+			ctx->config.ioBufferSize,        // Size of the buffer in bytes
+			0,                               // Write flag (0 for read-only operations)
+			streamReader.userData,           // Opaque pointer to custom stream context
+			streamReader.readFn,             // Custom read function
+			NULL,                            // Custom write function (NULL for read-only)
+			streamReader.seekFn              // Custom seek function (NULL if not supported)
+		);
+
+		if (!avIOContext)
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Can't allocate AVIOContext");
+			av_freep(&ioBuffer);         // Free the allocated buffer on failure
+			return false;                // The caller frees the resources
+		}
+
+		// Assign the custom AVIOContext to the format context
+		ctx->formatContext->pb = avIOContext;
+
+		// Owned by FFmpeg from now on (it may even replace it), only its size is accounted
+		ctx->ioBufferSize = ctx->config.ioBufferSize;
+		TrackMemory(&ctx->sharedMemory, ctx->ioBufferSize);
+
+		// Set the custom IO flag for the format context
+		ctx->formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+	}
+
+	int ret = avformat_open_input(&ctx->formatContext, fileName, NULL, NULL);
+
+	if ( ret < 0) {
+		AVPrintError(ret);
+		return false;
+	}
+
+	ret = avformat_find_stream_info(ctx->formatContext, NULL);
+
+	if (ret < 0) {
+		AVPrintError(ret);
+		return false;
+	}
+
+	for (int i = 0; i < (int)ctx->formatContext->nb_streams; i++)
+	{
+		const AVCodecParameters* localCodecParameters = ctx->formatContext->streams[i]->codecpar;
+
+		const AVCodec* localCodec = avcodec_find_decoder(localCodecParameters->codec_id);
+
+		if (localCodec == NULL) 
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Unsupported codec.");
+
+			continue;
+		}
+
+		if (localCodecParameters->codec_type == AVMEDIA_TYPE_VIDEO &&
+			(flags & MEDIA_LOAD_NO_VIDEO) == 0)
+		{
+			StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+			// Decoder threading: global settings, overridden by the load flags
+			int threadCount = (flags & MEDIA_FLAG_DECODE_SINGLE_THREAD) ? 1 : ctx->config.decodeThreads;
+			int threadType = ctx->config.decodeThreadType;
+
+			if (flags & (MEDIA_FLAG_DECODE_FRAME_THREADS | MEDIA_FLAG_DECODE_SLICE_THREADS))
+			{
+				threadType = ((flags & MEDIA_FLAG_DECODE_FRAME_THREADS) ? MEDIA_DECODE_THREAD_FRAME : 0) |
+							 ((flags & MEDIA_FLAG_DECODE_SLICE_THREADS) ? MEDIA_DECODE_THREAD_SLICE : 0);
+			}
+
+			ret = AVLoadCodecContext(videoCtx, localCodec, localCodecParameters, threadCount, threadType);
+
+			if(ret == MEDIA_RET_SUCCEED)
+			{
+				//-------------------------------------------------------------
+
+				videoCtx->streamIdx = -1;
 
 				//-------------------------------------------------------------
 
@@ -651,7 +2499,7 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				//-------------------------------------------------------------
 
-				videoCtx->pendingPackets = LoadQueue(MEDIA.videoQueueSize);
+				videoCtx->pendingPackets = LoadQueue(ctx->config.videoQueueSize, &videoCtx->memory);
 
 				if(!IsQueueReady(&videoCtx->pendingPackets))
 				{
@@ -664,41 +2512,18 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				//-------------------------------------------------------------
 
-				// Video resampling and scaling context
-				ctx->swsContext = sws_getContext(
-					codecCtx->width, codecCtx->height, codecCtx->pix_fmt,  // Input format
-					codecCtx->width, codecCtx->height, AV_PIX_FMT_RGB24,   // Output format
-					SWS_BILINEAR, NULL, NULL, NULL);
-
-				if(!ctx->swsContext)
-				{
-					TraceLog(LOG_ERROR, "MEDIA: Cannot initialize the SWS context.");
-
-					AVUnloadCodecContext(videoCtx);
-
-					continue;
-				}
-
-				//-------------------------------------------------------------
+				int outputWidth = 0;
+				int outputHeight = 0;
 
-				ctx->videoOutputImage.data = RL_MALLOC(av_image_get_buffer_size(AV_PIX_FMT_RGB24, codecCtx->width, codecCtx->height, 1));
+				AVGetVideoOutputSize(codecCtx, ctx->config.videoOutputWidth, ctx->config.videoOutputHeight, &outputWidth, &outputHeight);
 
-				if(!ctx->videoOutputImage.data)
+				if(!AVLoadVideoOutput(ctx, outputWidth, outputHeight))
 				{
-					TraceLog(LOG_ERROR, "MEDIA: Cannot allocate memory for holding the decoded frame.");
-
 					AVUnloadCodecContext(videoCtx);
 
 					continue;
 				}
 
-				ctx->videoOutputImage.width   = codecCtx->width;
-				ctx->videoOutputImage.height  = codecCtx->height;
-				ctx->videoOutputImage.mipmaps = 1;
-				ctx->videoOutputImage.format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8;
-
-				ImageClearBackground(&ctx->videoOutputImage, BLANK),
-
 				//-------------------------------------------------------------
 
 				videoCtx->streamIdx = i;
@@ -716,15 +2541,17 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 			(flags & MEDIA_LOAD_NO_AUDIO) == 0) 
 		{
 
-			if(!IsAudioDeviceReady())
+			// Headless audio goes to a callback, not to the audio device
+			if(!ctx->headless && !ctx->audioDeviceReady)
 			{
-				TraceLog(LOG_WARNING, "MEDIA: '%s' - Audio Codec: raylib audio device is not initialized. Audio will be skipped.");
+				TraceLog(LOG_WARNING, "MEDIA: '%s' - Audio Codec: raylib audio device is not initialized. Audio will be skipped.", fileName);
 				continue;
 			}
 
 			StreamDataContext* audioCtx = &ctx->streams[STREAM_AUDIO];
 
-			ret = AVLoadCodecContext(audioCtx, localCodec, localCodecParameters);
+			// Audio decoders are cheap and rarely threaded, keep FFmpeg's single thread default
+			ret = AVLoadCodecContext(audioCtx, localCodec, localCodecParameters, 1, MEDIA_DECODE_THREAD_SLICE);
 
 			if (ret == MEDIA_RET_SUCCEED)
 			{
@@ -734,7 +2561,7 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				//-------------------------------------------------------------
 
-				audioCtx->pendingPackets = LoadQueue(MEDIA.audioQueueSize);
+				audioCtx->pendingPackets = LoadQueue(ctx->config.audioQueueSize, &audioCtx->memory);
 
 				if (!IsQueueReady(&audioCtx->pendingPackets))
 				{
@@ -747,7 +2574,7 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				//-------------------------------------------------------------
 
-				ctx->audioOutputBuffer = LoadBuffer(MEDIA.audioDecodedBufferSize);
+				ctx->audioOutputBuffer = LoadBuffer(ctx->config.audioDecodedBufferSize, &audioCtx->memory);
 
 				if (!IsBufferReady(&ctx->audioOutputBuffer))
 				{
@@ -760,8 +2587,11 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				//-------------------------------------------------------------
 
-				ctx->audioOutputFmt = MEDIA.audioOutputFmt;
-				ctx->audioMaxUpdateSize = MEDIA.audioMaxUpdateSize;
+				ctx->audioOutputFmt = ctx->config.audioOutputFmt;
+				ctx->audioMaxUpdateSize = ctx->config.audioMaxUpdateSize;
+				ctx->audioChannels = ctx->config.audioOutputChannels;
+				ctx->audioBytesPerFrame = av_get_bytes_per_sample(ctx->audioOutputFmt) * ctx->audioChannels;
+				ctx->audioSampleRate = codecCtx->sample_rate;
 
 				//-------------------------------------------------------------
 
@@ -779,7 +2609,7 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 
 				// Prepare output channel layout
 				AVChannelLayout out_ch_layout;
-				av_channel_layout_default(&out_ch_layout, MEDIA.audioOutputChannels);
+				av_channel_layout_default(&out_ch_layout, ctx->audioChannels);
 
 				// Set options for SwrContext
 				ret = swr_alloc_set_opts2(&ctx->swrContext,
@@ -836,6 +2666,9 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 		TraceLog(LOG_DEBUG, "Media Debug: '%s' - Audio Codec: %s ID %d bit_rate %lld", fileName, localCodec->name, localCodec->id, localCodecParameters->bit_rate);
 	}
 	
+	// Without a video stream there is nothing to decode in the background
+	ctx->threadedDecode = ctx->threadedDecode && IsFrameQueueReady(&ctx->decodedFrames);
+
 	if (HasStream(ctx, STREAM_VIDEO) || HasStream(ctx, STREAM_AUDIO))
 	{
 		ctx->avFrame  = av_frame_alloc();
@@ -843,8 +2676,7 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 		if(!ctx->avFrame)
 		{
 			TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for AVFrame");
-			UnloadMediaContext(ctx);
-			return NULL;
+			return false;
 		}
 
 		ctx->avPacket = av_packet_alloc();
@@ -852,22 +2684,129 @@ MediaContext* LoadMediaContext(const char* fileName, MediaStreamReader streamRea
 		if (!ctx->avPacket)
 		{
 			TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for AVPacket");
-			UnloadMediaContext(ctx);
-			return NULL;
+			return false;
 		}
 
-		ctx->state = MEDIA_STATE_STOPPED;
+		if (HasStream(ctx, STREAM_VIDEO))
+		{
+			ctx->pendingVideoFrame = av_frame_alloc();
+			ctx->nextVideoFrame = av_frame_alloc();
+
+			if (!ctx->pendingVideoFrame || !ctx->nextVideoFrame)
+			{
+				TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for AVFrame");
+				return false;
+			}
+		}
+
+		if (ctx->threadedDemux)
+		{
+			ctx->demuxPacket = av_packet_alloc();
+
+			if (!ctx->demuxPacket)
+			{
+				TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for AVPacket");
+				return false;
+			}
+		}
+
+		if (ctx->threadedDecode)
+		{
+			ctx->decodeFrame = av_frame_alloc();
+
+			if (!ctx->decodeFrame)
+			{
+				TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for AVFrame");
+				return false;
+			}
+		}
+	}
+
+	if (HasStream(ctx, STREAM_VIDEO) && (flags & (MEDIA_FLAG_KEYFRAME_INDEX | MEDIA_FLAG_KEYFRAME_INDEX_CACHE)))
+	{
+		LoadKeyframeIndex(ctx, streamReader.readFn ? NULL : fileName, (flags & MEDIA_FLAG_KEYFRAME_INDEX_CACHE) != 0);
+	}
+
+	return true;
+}
+
+void StartMediaContext(MediaContext* ctx)
+{
+	if (!HasStream(ctx, STREAM_VIDEO) && !HasStream(ctx, STREAM_AUDIO))
+	{
+		return;
+	}
+
+	ctx->state = MEDIA_STATE_STOPPED;
+
+	const bool wantsPooledWorkers = ctx->threadedDemux && ctx->config.workerThreads > 0;
+
+	ctx->usesPool = (wantsPooledWorkers || ctx->convertBandCount > 1) && AcquireWorkerPool();
+	ctx->pooledWorkers = wantsPooledWorkers && ctx->usesPool;
+
+	if (!ctx->usesPool && ctx->convertBandCount > 1)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Worker pool unavailable, video frames will be converted in a single band.");
+		AVUnloadConvertBands(ctx);
+	}
+
+	if (ctx->threadedDemux && !StartMediaWorkers(ctx))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed to start the background workers, packets will be read on the calling thread.");
 	}
-	
-	return ctx;
 }
 
 void UnloadMediaContext(MediaContext* ctx)
 {
 	assert(ctx);
 
+	// A pending load job still uses the context
+	if (ctx->loadHoldsPool)
+	{
+		atomic_store(&ctx->abortLoad, true);
+
+		WaitMediaLoad(ctx);
+
+		ReleaseWorkerPool();
+		ctx->loadHoldsPool = false;
+	}
+
+	if (ctx->loadFileName)
+	{
+		MediaFree(ctx->loadFileName);
+		ctx->loadFileName = NULL;
+	}
+
+	// A pending scan still uses the context
+	UnloadKeyframeIndex(ctx);
+
+	// So does a pending seek job
+	CancelMediaSeek(ctx);
+
+	// And a reverse playback job
+	StopReversePlayback(ctx);
+
+	if (ctx->seekHoldsPool)
+	{
+		ReleaseWorkerPool();
+		ctx->seekHoldsPool = false;
+	}
+
+	// Workers must be stopped before freeing anything they may be using
+	StopMediaWorkers(ctx);
+
+	if (ctx->usesPool)
+	{
+		ReleaseWorkerPool();
+		ctx->usesPool = false;
+		ctx->pooledWorkers = false;
+	}
+
 	ctx->state = MEDIA_STATE_INVALID;
 
+	// Cached frames hold buffers of the video decoder
+	UnloadGopCache(&ctx->gopCache);
+
 	for(int i = 0; i < STREAM_COUNT; ++i)
 	{
 		const StreamDataContext* streamCtx = &ctx->streams[i];
@@ -881,17 +2820,7 @@ void UnloadMediaContext(MediaContext* ctx)
 		}		
 	}
 
-	if(ctx->swsContext)
-	{
-		sws_freeContext(ctx->swsContext);
-		ctx->swsContext = NULL;
-	}
-
-	if (IsImageValid(ctx->videoOutputImage))
-	{
-		UnloadImage(ctx->videoOutputImage);
-		ctx->videoOutputImage = (Image){ 0 };
-	}
+	AVUnloadVideoOutput(ctx);
 
 	if(ctx->swrContext)
 	{
@@ -903,6 +2832,8 @@ void UnloadMediaContext(MediaContext* ctx)
 		UnloadBuffer(&ctx->audioOutputBuffer);
 	}
 
+	UnloadTimeStretch(&ctx->timeStretch);
+
 	if(ctx->formatContext)
 	{
 		//AVIOContext
@@ -910,6 +2841,9 @@ void UnloadMediaContext(MediaContext* ctx)
 	    {
 		    av_freep(&ctx->formatContext->pb->buffer);
 		    avio_context_free(&ctx->formatContext->pb);
+
+		    TrackMemory(&ctx->sharedMemory, -ctx->ioBufferSize);
+		    ctx->ioBufferSize = 0;
 	    }
 
 		avformat_close_input(&ctx->formatContext);
@@ -920,14 +2854,61 @@ void UnloadMediaContext(MediaContext* ctx)
 		av_packet_free(&ctx->avPacket);
 	}
 
+	if(ctx->demuxPacket)
+	{
+		av_packet_free(&ctx->demuxPacket);
+	}
+
+	if(ctx->pendingVideoFrame)
+	{
+		av_frame_free(&ctx->pendingVideoFrame);
+	}
+
+	if(ctx->nextVideoFrame)
+	{
+		av_frame_free(&ctx->nextVideoFrame);
+	}
+
+	if(ctx->decodeFrame)
+	{
+		av_frame_free(&ctx->decodeFrame);
+	}
+
 	if (ctx->avFrame)
 	{
 		av_frame_free(&ctx->avFrame);
 	}
 
+	if (atomic_load(&ctx->memory.current) != (long long)sizeof(MediaContext))
+	{
+		TraceLog(LOG_DEBUG, "MEDIA: %lld bytes still accounted to the media being unloaded.", atomic_load(&ctx->memory.current) - (long long)sizeof(MediaContext));
+	}
+
+	TrackMemory(&ctx->sharedMemory, -(long long)sizeof(MediaContext));
+
 	RL_FREE(ctx);
 }
 
+void RunLoadJob(void* arg)
+{
+	MediaContext* ctx = (MediaContext*)arg;
+
+	const bool loaded = OpenMediaContext(ctx, ctx->loadFileName, (MediaStreamReader){ 0 }, ctx->loadFlags);
+
+	// Must be the last access: the main thread may finish or unload the media right after
+	SetJobStatus(&ctx->loadStatus, loaded ? LOAD_STATUS_DONE : LOAD_STATUS_FAILED);
+}
+
+void WaitMediaLoad(MediaContext* ctx)
+{
+	WaitJobStatus(&ctx->loadStatus, LOAD_STATUS_PENDING);
+}
+
+int AVInterruptCallback(void* ctx)
+{
+	return atomic_load(&((MediaContext*)ctx)->abortLoad) ? 1 : 0;
+}
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - MediaStream loading and unloading 
@@ -946,27 +2927,19 @@ MediaStream LoadMediaFromContext(MediaContext *ctx, int flags)
 		isLoaded = false;
 	}
 
-	if (isLoaded && ret.ctx->streams[STREAM_VIDEO].codecCtx)
+	if (isLoaded && ret.ctx->streams[STREAM_VIDEO].codecCtx && !ret.ctx->headless)
 	{
-		ret.videoTexture = LoadTextureFromImage(ret.ctx->videoOutputImage);
-
-		if (IsTextureValid(ret.videoTexture))
-		{
-			SetTextureFilter(ret.videoTexture, TEXTURE_FILTER_BILINEAR);
-		}
-		else
-		{
-			isLoaded = false;
-		}
+		isLoaded = LoadVideoTextures(&ret);
 	}
 
-	if (isLoaded && ret.ctx->streams[STREAM_AUDIO].codecCtx)
+	if (isLoaded && ret.ctx->streams[STREAM_AUDIO].codecCtx && !ret.ctx->headless)
 	{
-		const int sampleRate = ret.ctx->streams[STREAM_AUDIO].codecCtx->sample_rate;
-		const int sampleSize = 8 * av_get_bytes_per_sample(MEDIA.audioOutputFmt);
-		const int channels = MEDIA.audioOutputChannels;
+		// Same format as the SwrContext and the buffer, set up when the load started (see LoadMediaAsync)
+		const int sampleRate = ret.ctx->audioSampleRate;
+		const int sampleSize = 8 * av_get_bytes_per_sample(ret.ctx->audioOutputFmt);
+		const int channels = ret.ctx->audioChannels;
 
-		SetAudioStreamBufferSizeDefault(MEDIA.audioStreamBufferSize);
+		SetAudioStreamBufferSizeDefault(ret.ctx->config.audioStreamBufferSize);
 
 		ret.audioStream = LoadAudioStream(sampleRate, sampleSize, channels);
 
@@ -977,6 +2950,10 @@ MediaStream LoadMediaFromContext(MediaContext *ctx, int flags)
 		{
 			isLoaded = false;
 		}
+		else if ((flags & MEDIA_FLAG_AUDIO_PULL) != 0 && !AcquireAudioPullSlot(&ret))
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Too many media pulling their audio, pushing it from UpdateMedia instead.");
+		}
 	}
 
 	if (isLoaded)
@@ -1011,6 +2988,129 @@ MediaStream LoadMediaFromContext(MediaContext *ctx, int flags)
 	 return LoadMediaFromContext(ctx, flags);
  }
 
+ MediaStream LoadMediaAsync(const char* fileName, int flags)
+ {
+	 if (!fileName)
+	 {
+		 TraceLog(LOG_ERROR, "MEDIA: A file name is required to load media asynchronously");
+		 return (MediaStream) { 0 };
+	 }
+
+	 if (!AcquireWorkerPool())
+	 {
+		 TraceLog(LOG_ERROR, "MEDIA: Worker pool unavailable, can't load '%s' asynchronously", fileName);
+		 return (MediaStream) { 0 };
+	 }
+
+	 MediaContext* ctx = (MediaContext*) RL_MALLOC(sizeof(MediaContext));
+
+	 if (ctx)
+	 {
+		 *ctx = (MediaContext){ 0 };
+
+		 InitMediaMemory(ctx);
+
+		 // The load job runs later: it must use the settings in force now, and SetMediaFlag may be called meanwhile
+		 ctx->config = MEDIA;
+		 ctx->audioDeviceReady = IsAudioDeviceReady();
+	 }
+
+	 char* fileNameCopy = ctx ? MediaMalloc(&ctx->sharedMemory, strlen(fileName) + 1) : NULL;
+
+	 if (!ctx || !fileNameCopy)
+	 {
+		 TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for loading '%s'", fileName);
+
+		 if (ctx)
+		 {
+			 TrackMemory(&ctx->sharedMemory, -(long long)sizeof(MediaContext));
+		 }
+
+		 RL_FREE(ctx);
+		 ReleaseWorkerPool();
+		 return (MediaStream) { 0 };
+	 }
+
+	 ctx->state = MEDIA_STATE_INVALID;
+	 ctx->loadFileName = strcpy(fileNameCopy, fileName);
+	 ctx->loadFlags = flags;
+	 ctx->loadHoldsPool = true;
+	 atomic_store(&ctx->loadStatus, LOAD_STATUS_PENDING);
+
+	 if (!SubmitPoolJob((PoolJob){ RunLoadJob, ctx }))
+	 {
+		 atomic_store(&ctx->loadStatus, LOAD_STATUS_FAILED);
+		 UnloadMediaContext(ctx);
+		 return (MediaStream) { 0 };
+	 }
+
+	 return (MediaStream) { .ctx = ctx };
+ }
+
+ int LoadMediaAsyncBatch(const char** fileNames, int count, int flags, MediaStream* medias)
+ {
+	 assert(fileNames && medias);
+
+	 int started = 0;
+
+	 // Every load is a separate pool job, so they run in parallel
+	 for (int i = 0; i < count; ++i)
+	 {
+		 medias[i] = LoadMediaAsync(fileNames[i], flags);
+
+		 if (medias[i].ctx)
+		 {
+			 started++;
+		 }
+	 }
+
+	 return started;
+ }
+
+ bool IsMediaLoaded(MediaStream media)
+ {
+	 return media.ctx != NULL && atomic_load(&media.ctx->loadStatus) != LOAD_STATUS_PENDING;
+ }
+
+ bool FinishMediaLoad(MediaStream* media)
+ {
+	 assert(media);
+
+	 MediaContext* ctx = media->ctx;
+
+	 if (ctx && ctx->loadHoldsPool)
+	 {
+		 WaitMediaLoad(ctx);
+
+		 const bool loaded = atomic_load(&ctx->loadStatus) == LOAD_STATUS_DONE;
+
+		 // Started before releasing the load reference, so a context using the pool keeps it alive
+		 if (loaded)
+		 {
+			 StartMediaContext(ctx);
+		 }
+
+		 ReleaseWorkerPool();
+		 ctx->loadHoldsPool = false;
+
+		 if (!loaded)
+		 {
+			 TraceLog(LOG_ERROR, "MEDIA: Failed to load '%s'", ctx->loadFileName);
+			 UnloadMediaContext(ctx);
+			 *media = (MediaStream){ 0 };
+			 return false;
+		 }
+
+		 MediaFree(ctx->loadFileName);
+		 ctx->loadFileName = NULL;
+
+		 // GPU texture and AudioStream must be created on the main thread
+		 *media = LoadMediaFromContext(ctx, ctx->loadFlags);
+	 }
+
+	 return IsMediaValid(*media);
+ }
+
  MediaStream LoadMediaFromStream(MediaStreamReader streamReader, int flags)
  {
 	 if (!streamReader.readFn)
@@ -1038,14 +3138,17 @@ void UnloadMedia(MediaStream* media)
 		media->audioStream = (AudioStream){ 0 };
 	}
 
-	if(IsTextureValid(media->videoTexture))
-{
-		UnloadTexture(media->videoTexture);
-		media->videoTexture = (Texture2D){ 0 };
-}
-
 	if(media->ctx)
 {
+		// The callback of the AudioStream can't run anymore
+		ReleaseAudioPullSlot(media->ctx);
+
+		if (atomic_load(&media->ctx->frameBorrowers) > 0)
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Unloading a media whose frame is still borrowed (see ReleaseMediaFrame).");
+		}
+
+		UnloadVideoTextures(media);
 		UnloadMediaContext(media->ctx);
 		media->ctx = NULL;
 	}
@@ -1111,7 +3214,7 @@ int SetMediaState(MediaStream media, int newState)
 		if (curState != MEDIA_STATE_STOPPED) 
 		{
 			UpdateState(&media, MEDIA_STATE_STOPPED);
-			if (!AVSeek(&media, 0)) 
+			if (!AVSeek(&media, 0, false)) 
 			{
 				TraceLog(LOG_WARNING, "MEDIA: Could not reset the stream.");
 			}
@@ -1148,11 +3251,55 @@ bool UpdateMediaEx(MediaStream* media, double deltaTime)
 
 	MediaContext* ctx = media->ctx;
 
+	// Only the allocations of this thread are counted, once: nested calls are part of the outermost one
+	const int allocations = THREAD_ALLOCATIONS;
+	++UPDATE_DEPTH;
+
+	bool ret = true;
+
+	// While an asynchronous seek runs, the previous frame stays on screen
+	if (PollMediaSeek(media))
+	{
+		// The last seek was served by the GOP cache: the decoder must get there before playing
+		if (ctx->deferredSeek && ctx->state == MEDIA_STATE_PLAYING)
+		{
+			AVResolveDeferredSeek(media);
+		}
+
+		ret = UpdateMediaStreams(media, deltaTime * ctx->playbackRate);
+	}
+
+	if (--UPDATE_DEPTH == 0)
+	{
+		atomic_fetch_add(&ctx->updateAllocations, THREAD_ALLOCATIONS - allocations);
+	}
+
+	return ret;
+}
+
+bool UpdateMediaStreams(MediaStream* media, double deltaTime)
+{
+	MediaContext* ctx = media->ctx;
+
+	// Pooled workers sleep when they have nothing to do (e.g. full queues): give them a chance to resume
+	WakeMediaWorkers(ctx);
+
 	if (media->ctx->state != MEDIA_STATE_PLAYING)
 	{
 		return true;
 	}
 
+	if (deltaTime < 0.0 || (ctx->reversePlay && deltaTime == 0.0))
+	{
+		return UpdateReversePlayback(media, deltaTime);
+	}
+
+	// Playing forward again: the decoder must start from the frame displayed
+	if (ctx->reversePlay)
+	{
+		AVSeek(media, (int64_t)(ctx->timePos * AV_TIME_BASE), true);
+	}
+
 	ctx->timePos += deltaTime;
 
 	int ret = MEDIA_RET_SUCCEED;
@@ -1166,6 +3313,34 @@ bool UpdateMediaEx(MediaStream* media, double deltaTime)
 			continue;
 		}
 
+		// Video frames are already decoded by the decode worker, only the upload is left
+		if (i == STREAM_VIDEO && ctx->decodeWorker.running)
+		{
+			ret = PresentDecodedFrame(media);
+
+			if (ret == MEDIA_EOF)
+			{
+				NotifyEndOfStream(media);
+				return true;
+			}
+
+			if (ret != MEDIA_RET_SUCCEED)
+			{
+				TraceLog(LOG_WARNING, "MEDIA: Failed decoding video in the background. (Error code: %i)", ret);
+			}
+
+			continue;
+		}
+
+		// Frame decoded ahead by an accurate seek or a step, shown once due
+		if (i == STREAM_VIDEO && ctx->hasNextVideoFrame && ctx->timePos >= AVGetVideoFrameTime(ctx, ctx->nextVideoFrame))
+		{
+			av_frame_move_ref(ctx->avFrame, ctx->nextVideoFrame);
+			ctx->hasNextVideoFrame = false;
+
+			AVProcessVideoFrame(ctx);
+		}
+
 		bool discardPacketAndContinue = true;
 
 		while(discardPacketAndContinue)
@@ -1176,12 +3351,32 @@ bool UpdateMediaEx(MediaStream* media, double deltaTime)
 			// Peek at a packet from the queue without modifying the queue or changing packet references.
 			ret = AVPeekPacket(ctx, i, &avPacket);
 
+			// Pulled audio is decoded ahead, its end comes before the end of the media
+			if (ret == MEDIA_EOF && i == STREAM_AUDIO && ctx->pullAudio && ctx->timePos < ctx->audioEndTime)
+			{
+				ret = MEDIA_RET_SUCCEED;
+				break;
+			}
+
 			if (ret == MEDIA_EOF)
 			{
+				// Show the last frame before looping or stopping
+				if (i == STREAM_VIDEO)
+				{
+					AVFlushVideoFrame(media);
+				}
+
 				NotifyEndOfStream(media);
 				return true;
 			}
 
+			if (ret == MEDIA_RET_WAIT)
+			{
+				// The demux worker has not read the packet yet, try again on the next update
+				ret = MEDIA_RET_SUCCEED;
+				break;
+			}
+
 			if (ret != MEDIA_RET_SUCCEED)
 			{
 				TraceLog(LOG_WARNING, "MEDIA: Failed grabbing packet from stream #i. (Error code: %i)", i, ret);
@@ -1196,103 +3391,335 @@ bool UpdateMediaEx(MediaStream* media, double deltaTime)
 			const double nextFrameTime = (double)(avPacket->pts - streamCtx->startPts) *
 				av_q2d(ctx->formatContext->streams[streamCtx->streamIdx]->time_base);
 
+			// Pulled audio is decoded ahead while the buffer is less than half full, so the callback doesn't depend on
+			// the update rate
+			const bool decodeAhead = i == STREAM_AUDIO && ctx->pullAudio &&
+				GetBufferReadableSpace(&ctx->audioOutputBuffer.state) < ctx->audioOutputBuffer.state.capacity / 2;
+
 			// It's not yet time to use the packet
 			// Since we have just "peeked" the packet no reference handling is needed
-			if (ctx->timePos < nextFrameTime)
+			if (ctx->timePos < nextFrameTime && !decodeAhead)
 			{
 				break;
 			}
 		   
 			const double delaySec = ctx->timePos - nextFrameTime;
-			
-			discardPacketAndContinue = delaySec > MEDIA.maxAllowedDelay[i];
 
-			ret = AVDecodePacket(media, i, avPacket, discardPacketAndContinue);
-
-			if (ret < 0)
+			// Far behind: jump to the last keyframe before the current position instead of decoding the whole backlog.
+			// The guard prevents jumping again while decoding from the previous jump position.
+			if (i == STREAM_VIDEO && MEDIA.keyframeJumpDelay > 0 && delaySec > MEDIA.keyframeJumpDelay &&
+				nextFrameTime >= ctx->keyframeJumpGuard && AVKeyframeJumpSkipsBacklog(ctx, avPacket))
 			{
-				TraceLog(LOG_ERROR, "MEDIA: Decoding packet (stream type: %i, error code: %i)", i, ret);
-			}
+				const double jumpPos = ctx->timePos;
 
-			// Advance the read position in the circular buffer queue and un-reference the packet.
-			// This is equivalent to DequeueBuffer but avoids transferring ownership of the packet reference.
-			AdvanceReadPos(&streamCtx->pendingPackets.state);
-			av_packet_unref(avPacket);
-		}		
-	}
+				TraceLog(LOG_DEBUG, "MEDIA: Video is %.2f s behind, jumping to the keyframe before %.2f s.", delaySec, jumpPos);
 
-	if (HasStream(ctx, STREAM_AUDIO) && IsAudioStreamProcessed(media->audioStream))
-	{
-		const int readableSegmentBytes = GetBufferReadableSegmentSize(&ctx->audioOutputBuffer.state);
+				// Seeking drops the queued packets (the peeked one included) and resynchronizes the audio
+				AVSeek(media, (int64_t)(jumpPos * AV_TIME_BASE), false);
 
-		const int updateSize = MIN(readableSegmentBytes, ctx->audioMaxUpdateSize);
+				ctx->keyframeJumpGuard = jumpPos;
+				atomic_fetch_add(&ctx->keyframeJumps, 1);
 
-		const int bytesPerSample = (int)((media->audioStream.sampleSize / 8) * media->audioStream.channels);
+				return true;
+			}
 
-		const int frameCount = updateSize / bytesPerSample;
+			// Timing is based on packets, not on decoded frames. With frame threading (MEDIA_DECODE_THREADS != 1)
+			// the decoder returns each frame (threads - 1) packets later, so the video lags behind by that many
+			// frames and the first packets after a seek produce no frame at all. Slice threading adds no delay.
+			discardPacketAndContinue = delaySec > MEDIA.maxAllowedDelay[i];
 
-		UpdateAudioStream(media->audioStream, &ctx->audioOutputBuffer.data[ctx->audioOutputBuffer.state.readPos], frameCount);
+			if (i == STREAM_AUDIO && discardPacketAndContinue)
+			{
+				ctx->droppedAudioPackets++;
+			}
 
-		AdvanceReadPosN(&ctx->audioOutputBuffer.state, updateSize);
-	}
+			if (i == STREAM_VIDEO && ctx->fastCatchUp)
+			{
+				AVSetVideoCatchUp(ctx, discardPacketAndContinue);
+			}
 
-	return ret == MEDIA_RET_SUCCEED;
-}
+			// Nothing depends on a late disposable packet, don't even decode it
+			if (i == STREAM_VIDEO && ctx->catchingUp && discardPacketAndContinue && (avPacket->flags & AV_PKT_FLAG_DISPOSABLE))
+			{
+				atomic_fetch_add(&ctx->skippedVideoPackets, 1);
 
+				// The GOP being cached now has a hole
+				BreakGopCache(&ctx->gopCache);
+			}
+			else
+			{
+				ret = AVDecodePacket(media, i, avPacket, discardPacketAndContinue);
+			}
 
-//---------------------------------------------------------------------------------------------------
-// Functions Declaration - Circular buffer logic
-//---------------------------------------------------------------------------------------------------
+			if (ret < 0)
+			{
+				TraceLog(LOG_ERROR, "MEDIA: Decoding packet (stream type: %i, error code: %i)", i, ret);
+			}
 
+			// Un-reference the packet and advance the read position in the circular buffer queue.
+			SkipPacket(&streamCtx->pendingPackets);
 
-int IsBufferFull(const BufferState* state)
-{
-	return (state->writePos + 1) % state->capacity == state->readPos;
-}
+			discardPacketAndContinue = discardPacketAndContinue || decodeAhead;
+		}
+
+		// Only the last frame decoded in this update is converted and uploaded
+		if (i == STREAM_VIDEO)
+		{
+			AVFlushVideoFrame(media);
+		}
+	}
+
+	if (HasStream(ctx, STREAM_AUDIO) && (ctx->audioCallback || ctx->headless))
+	{
+		// Everything decoded so far goes to the callback (headless without a callback: discarded)
+		while (true)
+		{
+			const int frameCount = GetBufferReadableSegmentSize(&ctx->audioOutputBuffer.state) / ctx->audioBytesPerFrame;
+
+			if (frameCount <= 0)
+			{
+				break;
+			}
+
+			if (ctx->audioCallback)
+			{
+				ctx->audioCallback(ctx->audioCallbackData, &ctx->audioOutputBuffer.data[ctx->audioOutputBuffer.state.readPos], frameCount);
+			}
+
+			AdvanceReadPosN(&ctx->audioOutputBuffer.state, frameCount * ctx->audioBytesPerFrame);
+		}
+	}
+	else if (HasStream(ctx, STREAM_AUDIO) && !ctx->pullAudio && IsAudioStreamProcessed(media->audioStream))
+	{
+		const int readableSegmentBytes = GetBufferReadableSegmentSize(&ctx->audioOutputBuffer.state);
+
+		const int updateSize = MIN(readableSegmentBytes, ctx->audioMaxUpdateSize);
+
+		const int frameCount = updateSize / ctx->audioBytesPerFrame;
+
+		UpdateAudioStream(media->audioStream, &ctx->audioOutputBuffer.data[ctx->audioOutputBuffer.state.readPos], frameCount);
+
+		AdvanceReadPosN(&ctx->audioOutputBuffer.state, updateSize);
+	}
+
+	return ret == MEDIA_RET_SUCCEED;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Memory tracking
+//---------------------------------------------------------------------------------------------------
+
+void* MediaMalloc(MemoryUsage* usage, size_t size)
+{
+	uint8_t* block = RL_MALLOC(MEDIA_MEMORY_HEADER_SIZE + size);
+
+	if (!block)
+	{
+		return NULL;
+	}
+
+	*(MemoryHeader*)block = (MemoryHeader){ usage, size };
+
+	TrackMemory(usage, (long long)size);
+
+	return block + MEDIA_MEMORY_HEADER_SIZE;
+}
+
+void* MediaCalloc(MemoryUsage* usage, size_t count, size_t size)
+{
+	void* ptr = MediaMalloc(usage, count * size);
+
+	if (ptr)
+	{
+		memset(ptr, 0, count * size);
+	}
+
+	return ptr;
+}
+
+void MediaFree(void* ptr)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	uint8_t* block = (uint8_t*)ptr - MEDIA_MEMORY_HEADER_SIZE;
+	const MemoryHeader* header = (const MemoryHeader*)block;
+
+	TrackMemory(header->usage, -(long long)header->size);
+
+	RL_FREE(block);
+}
+
+void* MediaAlignedMalloc(MemoryUsage* usage, size_t size)
+{
+	// A header as large as the alignment keeps the returned pointer aligned
+	uint8_t* block = av_malloc(MEDIA_FRAME_ALIGN + size);
+
+	if (!block)
+	{
+		return NULL;
+	}
+
+	*(MemoryHeader*)block = (MemoryHeader){ usage, size };
+
+	TrackMemory(usage, (long long)size);
+
+	return block + MEDIA_FRAME_ALIGN;
+}
+
+void MediaAlignedFree(void* ptr)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	uint8_t* block = (uint8_t*)ptr - MEDIA_FRAME_ALIGN;
+	const MemoryHeader* header = (const MemoryHeader*)block;
+
+	TrackMemory(header->usage, -(long long)header->size);
+
+	av_free(block);
+}
+
+void InitMemoryUsage(MemoryUsage* usage, MemoryUsage* parent)
+{
+	atomic_store(&usage->current, 0);
+	atomic_store(&usage->peak, 0);
+	atomic_store(&usage->allocations, 0);
+	usage->parent = parent;
+}
+
+void InitMediaMemory(MediaContext* ctx)
+{
+	InitMemoryUsage(&ctx->memory, &MEDIA_MEMORY);
+	InitMemoryUsage(&ctx->sharedMemory, &ctx->memory);
+
+	for (int i = 0; i < STREAM_COUNT; ++i)
+	{
+		InitMemoryUsage(&ctx->streams[i].memory, &ctx->memory);
+	}
+
+	TrackMemory(&ctx->sharedMemory, (long long)sizeof(MediaContext));
+}
+
+void TrackMemory(MemoryUsage* usage, long long bytes)
+{
+	if (bytes > 0)
+	{
+		++THREAD_ALLOCATIONS;
+	}
+
+	for (; usage; usage = usage->parent)
+	{
+		const long long current = atomic_fetch_add(&usage->current, bytes) + bytes;
+
+		if (bytes > 0)
+		{
+			atomic_fetch_add(&usage->allocations, 1);
+
+			if (WORKER_THREAD)
+			{
+				atomic_fetch_add(&usage->workerAllocations, 1);
+			}
+
+			long long peak = atomic_load(&usage->peak);
+
+			while (current > peak && !atomic_compare_exchange_weak(&usage->peak, &peak, current))
+			{
+				// peak was reloaded by the failed exchange
+			}
+		}
+	}
+}
+
+MediaMemoryUsage GetMemoryUsage(const MemoryUsage* usage)
+{
+	return (MediaMemoryUsage){
+		.current = atomic_load(&usage->current),
+		.peak = atomic_load(&usage->peak)
+	};
+}
+
+//---------------------------------------------------------------------------------------------------
+// Functions Declaration - Circular buffer logic
+//---------------------------------------------------------------------------------------------------
+
+
+// Positions are loaded once per call, so each function works on a consistent snapshot even if the
+// other side of the buffer is moving its own position concurrently.
+
+int IsBufferFull(const BufferState* state)
+{
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	return (writePos + 1) % state->capacity == readPos;
+}
 
 int IsBufferEmpty(const BufferState* state)
 {
-	return state->writePos == state->readPos;
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	return writePos == readPos;
 }
 
 int GetBufferWritableSpace(const BufferState* state)
 {
-	if(state->readPos > state->writePos)
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	if(readPos > writePos)
 	{
-		return state->readPos - state->writePos - 1;
+		return readPos - writePos - 1;
 	}
 
-	return state->capacity - state->writePos + state->readPos;
+	// One byte stays free: a full buffer would look empty
+	return state->capacity - writePos + readPos - 1;
 }
 
 int GetBufferWritableSegmentSize(const BufferState* state)
 {
-	if(state->readPos > state->writePos)
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	if(readPos > writePos)
 	{
-		return state->readPos - state->writePos - 1;
+		return readPos - writePos - 1;
 	}
 
-	return state->capacity - state->writePos;	
+	// Up to the end of the buffer, unless the write position would wrap onto the read position
+	return readPos == 0 ? state->capacity - writePos - 1 : state->capacity - writePos;
 }
 
 int GetBufferReadableSpace(const BufferState* state)
 {
-	if (state->readPos > state->writePos)
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	if (readPos > writePos)
 	{
-		return state->capacity - state->readPos + state->writePos;
+		return state->capacity - readPos + writePos;
 	}
 
-	return state->writePos - state->readPos;
+	return writePos - readPos;
 }
 
 int GetBufferReadableSegmentSize(const BufferState* state)
 {
-	if(state->readPos > state->writePos)
+	const int readPos  = atomic_load_explicit(&state->readPos, memory_order_acquire);
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_acquire);
+
+	if(readPos > writePos)
 	{
-		return state->capacity - state->readPos;
+		return state->capacity - readPos;
 	}
 
-	return state->writePos - state->readPos;
+	return writePos - readPos;
 }
 
 void AdvanceWritePos(BufferState* state)
@@ -1302,7 +3729,9 @@ void AdvanceWritePos(BufferState* state)
 
 void AdvanceWritePosN(BufferState* state, int n)
 {
-	state->writePos = (state->writePos + n) % state->capacity;
+	// Release: the data written before this call becomes visible to the consumer together with the new position
+	const int writePos = atomic_load_explicit(&state->writePos, memory_order_relaxed);
+	atomic_store_explicit(&state->writePos, (writePos + n) % state->capacity, memory_order_release);
 }
 
 void AdvanceReadPos(BufferState* state)
@@ -1312,20 +3741,22 @@ void AdvanceReadPos(BufferState* state)
 
 void AdvanceReadPosN(BufferState* state, int n)
 {
-	state->readPos = (state->readPos + n) % state->capacity;
+	// Release: the consumer is done with the data before the producer can see the slot as free
+	const int readPos = atomic_load_explicit(&state->readPos, memory_order_relaxed);
+	atomic_store_explicit(&state->readPos, (readPos + n) % state->capacity, memory_order_release);
 }
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - Buffer management
 //---------------------------------------------------------------------------------------------------
 
-Buffer LoadBuffer(int capacity)
+Buffer LoadBuffer(int capacity, MemoryUsage* memory)
 {
 	assert(capacity > 0); 
 
 	Buffer ret = (Buffer){ 0 };
 
-	ret.data = RL_MALLOC(capacity);
+	ret.data = MediaMalloc(memory, capacity);
 
 	if (ret.data)
 	{
@@ -1345,7 +3776,7 @@ void UnloadBuffer(Buffer* buffer)
 
 	if(buffer->data)
 	{
-		RL_FREE(buffer->data);
+		MediaFree(buffer->data);
 		*buffer = (Buffer){ 0 };
 	}
 	else
@@ -1474,7 +3905,13 @@ int ReadBuffer(Buffer* buffer, uint8_t* dstData, int dstSize)
 // Functions Declaration - PacketQueue management
 //---------------------------------------------------------------------------------------------------
 
-PacketQueue LoadQueue(int capacity)
+// Size of the payload of a packet, allocated by libavformat
+static inline long long GetPacketMemory(const AVPacket* packet)
+{
+	return packet->buf ? (long long)packet->buf->size : 0;
+}
+
+PacketQueue LoadQueue(int capacity, MemoryUsage* memory)
 {
 	assert(capacity > 0);
 
@@ -1482,11 +3919,12 @@ PacketQueue LoadQueue(int capacity)
 
 	const int sizeToAllocate = (int)sizeof(AVPacket*) * capacity;
 
-	ret.packets = RL_MALLOC(sizeToAllocate);
+	ret.packets = MediaMalloc(memory, sizeToAllocate);
 
 	if (ret.packets)
 	{
 		ret.state.capacity = capacity;
+		ret.memory = memory;
 
 		memset((void*)ret.packets, 0, sizeToAllocate);
 
@@ -1527,9 +3965,7 @@ void UnloadQueue(PacketQueue* queue)
 
 		while(!IsBufferEmpty(&queue->state))
 		{
-			av_packet_unref(queue->packets[queue->state.readPos]);
-
-			AdvanceReadPos(&queue->state);			
+			SkipPacket(queue);
 		}
 
 		for (int i = 0; i < queue->state.capacity; ++i)
@@ -1537,7 +3973,7 @@ void UnloadQueue(PacketQueue* queue)
 			av_packet_free(&queue->packets[i]);
 		}
 
-		RL_FREE((void*)queue->packets);
+		MediaFree((void*)queue->packets);
 
 		*queue = (PacketQueue){ 0 };
 	}
@@ -1555,9 +3991,7 @@ void ClearQueue(PacketQueue* queue)
 	{
 		while (!IsBufferEmpty(&queue->state))
 		{
-			av_packet_unref(queue->packets[queue->state.readPos]);
-
-			AdvanceReadPos(&queue->state);
+			SkipPacket(queue);
 		}
 
 		queue->state.readPos = 0;
@@ -1609,6 +4043,8 @@ bool EnqueuePacket(PacketQueue* queue, AVPacket* src)
 		return false;
 	}
 
+	TrackMemory(queue->memory, GetPacketMemory(src));
+
 	av_packet_move_ref(queue->packets[queue->state.writePos], src);
 
 	AdvanceWritePos(&queue->state);
@@ -1639,6 +4075,8 @@ bool DequeuePacket(PacketQueue* queue, AVPacket* dst)
 		return false;
 	}
 
+	TrackMemory(queue->memory, -GetPacketMemory(queue->packets[queue->state.readPos]));
+
 	av_packet_move_ref(dst, queue->packets[queue->state.readPos]);
 
 	AdvanceReadPos(&queue->state);
@@ -1659,6 +4097,107 @@ AVPacket* PeekPacket(const PacketQueue* queue)
 	return !IsQueueEmpty(queue) ? queue->packets[queue->state.readPos] : NULL;
 }
 
+void SkipPacket(PacketQueue* queue)
+{
+	assert(queue);
+	assert(!IsQueueEmpty(queue));
+
+	AVPacket* packet = queue->packets[queue->state.readPos];
+
+	TrackMemory(queue->memory, -GetPacketMemory(packet));
+
+	// The slot must be released only after the unref, as the producer may refill it right away
+	av_packet_unref(packet);
+
+	AdvanceReadPos(&queue->state);
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - FrameQueue management
+//---------------------------------------------------------------------------------------------------
+
+FrameQueue LoadFrameQueue(int capacity, int frameSize, MemoryUsage* memory)
+{
+	assert(capacity > 0);
+	assert(frameSize > 0);
+
+	FrameQueue ret = (FrameQueue){ 0 };
+
+	const int sizeToAllocate = (int)sizeof(VideoFrame) * capacity;
+
+	ret.frames = MediaMalloc(memory, sizeToAllocate);
+
+	if (ret.frames)
+	{
+		ret.state.capacity = capacity;
+
+		memset((void*)ret.frames, 0, sizeToAllocate);
+
+		for (int i = 0; i < capacity; ++i)
+		{
+			ret.frames[i].data = AVAllocVideoBuffer(memory, frameSize);
+			if (!ret.frames[i].data)
+			{
+				TraceLog(LOG_ERROR, "MEDIA: Failed to allocate frame at index %i, the queue will be unloaded.", i);
+
+				UnloadFrameQueue(&ret);
+
+				return (FrameQueue) { 0 };
+			}
+		}
+	}
+	else
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to allocate a frame queue with capacity of %i frames.", capacity);
+	}
+
+	return ret;
+}
+
+void UnloadFrameQueue(FrameQueue* queue)
+{
+	assert(queue);
+
+	if (queue->frames)
+	{
+		for (int i = 0; i < queue->state.capacity; ++i)
+		{
+			MediaAlignedFree(queue->frames[i].data);
+		}
+
+		MediaFree((void*)queue->frames);
+
+		*queue = (FrameQueue){ 0 };
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to unload a NULL frame queue.");
+	}
+}
+
+bool IsFrameQueueReady(const FrameQueue* queue)
+{
+	assert(queue);
+
+	return queue->frames != NULL;
+}
+
+void ClearFrameQueue(FrameQueue* queue)
+{
+	assert(queue);
+
+	if (queue->frames)
+	{
+		queue->state.readPos = 0;
+		queue->state.writePos = 0;
+	}
+	else
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Trying to clear a frame queue with no allocated frames.");
+	}
+}
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - AV management - FFmpeg(libav)
@@ -1744,7 +4283,18 @@ int AVPeekPacket(MediaContext* ctx, int streamType, AVPacket** ptr)
 
 	PacketQueue* queue = &ctx->streams[streamType].pendingPackets;
 
-	if (IsQueueEmpty(queue))
+	if (ctx->demuxWorker.running)
+	{
+		// The queue is filled in the background: never block, report the end of the stream only once it's drained.
+		// The status is loaded before checking the queue, as the worker sets it only after its last enqueue.
+		const int status = atomic_load(&ctx->demuxStatus);
+
+		if (IsQueueEmpty(queue))
+		{
+			return status == MEDIA_RET_SUCCEED ? MEDIA_RET_WAIT : status;
+		}
+	}
+	else if (IsQueueEmpty(queue))
 	{
 		int ret = AVGrabPacket(ctx, streamType, ctx->avPacket);
 		if (ret != MEDIA_RET_SUCCEED)
@@ -1760,6 +4310,27 @@ int AVPeekPacket(MediaContext* ctx, int streamType, AVPacket** ptr)
 	return MEDIA_RET_SUCCEED;
 }
 
+bool AVKeyframeJumpSkipsBacklog(const MediaContext* ctx, const AVPacket* latePacket)
+{
+	const StreamDataContext* streamCtx = &ctx->streams[STREAM_VIDEO];
+	AVStream* stream = ctx->formatContext->streams[streamCtx->streamIdx];
+
+	const int64_t targetPts = streamCtx->startPts + (int64_t)(ctx->timePos / av_q2d(stream->time_base));
+
+	const KeyframeIndex* index = GetKeyframeIndex(ctx);
+
+	if (index)
+	{
+		const KeyframeEntry* keyframe = FindKeyframe(index, targetPts);
+
+		return !keyframe || keyframe->pts > latePacket->pts;
+	}
+
+	const AVIndexEntry* keyframe = avformat_index_get_entry_from_timestamp(stream, targetPts, AVSEEK_FLAG_BACKWARD);
+
+	return !keyframe || keyframe->timestamp > latePacket->pts;
+}
+
 bool AVSeekRelative(MediaStream* media, double factor)
 {
 	assert(media->ctx);
@@ -1768,17 +4339,16 @@ bool AVSeekRelative(MediaStream* media, double factor)
 
 	const int64_t targetTimestamp = (int64_t)((double)media->ctx->formatContext->duration * factor);
 
-	return AVSeek(media, targetTimestamp);
+	return AVSeek(media, targetTimestamp, false);
 }
 
-bool AVSeekVideoKeyframe(const MediaStream* media)
+int AVSeekVideoKeyframe(MediaContext* ctx, double* keyframeTime)
 {
-	assert(media);
+	assert(ctx);
 
-	if (!HasStream(media->ctx, STREAM_VIDEO))
-		return true;
+	if (!HasStream(ctx, STREAM_VIDEO))
+		return MEDIA_RET_SUCCEED;
 
-	MediaContext* ctx = media->ctx;
 	StreamDataContext* streamCtx = &ctx->streams[STREAM_VIDEO];
 
 	while (true)
@@ -1788,74 +4358,191 @@ bool AVSeekVideoKeyframe(const MediaStream* media)
 
 		if (ret == MEDIA_EOF)
 		{
-			NotifyEndOfStream(media);
-			break;
+			return MEDIA_EOF;
 		}
 
 		if (ret != MEDIA_RET_SUCCEED)
 		{
 			TraceLog(LOG_WARNING, "MEDIA: Failed grabbing packet from video stream. (Error code: %i)", ret);
-			return false;
+			return ret;
 		}
 
 		// A video keyframe has just been found, we are done.
 		if (vPacket->flags & AV_PKT_FLAG_KEY)
 		{
-			// Set the media time to match this keyframe
-			ctx->timePos = (double)(vPacket->pts - streamCtx->startPts) *
+			*keyframeTime = (double)(vPacket->pts - streamCtx->startPts) *
 				av_q2d(ctx->formatContext->streams[streamCtx->streamIdx]->time_base);
 			break;
 		}
 
-		// Discard non-keyframe packets (Same of DequeuePacket, but it avoids redundant reference moving)
-		AdvanceReadPos(&streamCtx->pendingPackets.state);
-		av_packet_unref(vPacket);
+		// Discard non-keyframe packets
+		SkipPacket(&streamCtx->pendingPackets);
 	}
 
-	return true;
+	return MEDIA_RET_SUCCEED;
 }
 
 
-bool AVSeek(MediaStream* media, int64_t targetTimestamp)
+bool AVSeek(MediaStream* media, int64_t targetTimestamp, bool accurate)
+{
+	assert(media->ctx);
+
+	// A background seek still owns the demuxer, and this one supersedes it
+	CancelMediaSeek(media->ctx);
+
+	AVSeekBegin(media);
+
+	return AVSeekEnd(media, AVSeekCore(media->ctx, targetTimestamp, accurate));
+}
+
+void AVSeekBegin(MediaStream* media)
 {
 	MediaContext* ctx = media->ctx;
 
 	assert(ctx);
 
-	const int ret = avformat_seek_file(ctx->formatContext, -1, INT64_MIN, targetTimestamp, INT64_MAX, AVSEEK_FLAG_BACKWARD);
+	// Reverse playback uses the decoder too, it's resumed by the next negative update
+	StopReversePlayback(ctx);
 
-	if (ret < 0) 
+	// A seek replacing one in progress is timed from the first request
+	if (ctx->seekStartTime == 0)
 	{
-		AVPrintError(ret);
-		return false;
+		ctx->seekStartTime = av_gettime_relative();
 	}
 
-	// Update the time to the target TS
-	ctx->timePos = (double)targetTimestamp / AV_TIME_BASE;
+	// The format context and the packet queues can't be shared with the background workers while seeking
+	ctx->seekResumeWorkers = StopMediaWorkers(ctx) || ctx->seekResumeWorkers;
 
-	for(int i = 0; i < STREAM_COUNT; ++i)
+	if (IsAudioStreamValid(media->audioStream))
 	{
-		AVCodecContext* codecCtx = ctx->streams[i].codecCtx;
+		StopAudioStream(media->audioStream);
+	}
+}
 
-		if(codecCtx)
-		{
-			avcodec_flush_buffers(codecCtx);
+int AVSeekCore(MediaContext* ctx, int64_t targetTimestamp, bool accurate)
+{
+	assert(ctx);
 
-			ClearQueue(&ctx->streams[i].pendingPackets);
-		}		
+	// Recently decoded frames are shown right away
+	if (AVSeekCachedFrame(ctx, targetTimestamp, accurate))
+	{
+		return MEDIA_RET_SUCCEED;
 	}
 
-	// If the media has a video stream then seek the first video keyframe to avoid image output artifacts
-	if(!AVSeekVideoKeyframe(media))
-	{
-		return false;
+	return AVSeekStreams(ctx, targetTimestamp, accurate);
+}
+
+int AVSeekStreams(MediaContext* ctx, int64_t targetTimestamp, bool accurate)
+{
+	ctx->deferredSeek = false;
+	ctx->keyframeJumpGuard = 0.0;
+
+	// With a keyframe index, go straight to the keyframe instead of letting the demuxer search for it
+	int ret = AVSeekIndexedKeyframe(ctx, targetTimestamp) ? 0 :
+		avformat_seek_file(ctx->formatContext, -1, INT64_MIN, targetTimestamp, INT64_MAX, AVSEEK_FLAG_BACKWARD);
+
+	if (ret < 0) 
+	{
+		AVPrintError(ret);
+
+		return ret;
 	}
 
-	if (IsAudioStreamValid(media->audioStream))
+	// Update the time to the target TS
+	ctx->timePos = (double)targetTimestamp / AV_TIME_BASE;
+
+	for(int i = 0; i < STREAM_COUNT; ++i)
 	{
-		StopAudioStream(media->audioStream);
+		AVCodecContext* codecCtx = ctx->streams[i].codecCtx;
+
+		if(codecCtx)
+		{
+			avcodec_flush_buffers(codecCtx);
+
+			ClearQueue(&ctx->streams[i].pendingPackets);
+		}		
+	}
+
+	if (IsFrameQueueReady(&ctx->decodedFrames))
+	{
+		ClearFrameQueue(&ctx->decodedFrames);
+	}
+
+	// The audio output buffer is cleared by AVSeekEnd
+	ResetTimeStretch(&ctx->timeStretch);
+
+	AVDropVideoFrame(ctx);
+	AVDropNextVideoFrame(ctx);
+
+	BreakGopCache(&ctx->gopCache);
 
+	if (HasStream(ctx, STREAM_VIDEO))
+	{
+		AVSetVideoCatchUp(ctx, false);
+	}
+
+	// If the media has a video stream then seek the first video keyframe to avoid image output artifacts.
+	// The media time is set to match this keyframe.
+	ret = AVSeekVideoKeyframe(ctx, &ctx->timePos);
+
+	ctx->audioEndTime = ctx->timePos;
+	ctx->lastSeekDecodedFrames = 0;
+
+	if (ret == MEDIA_RET_SUCCEED && accurate && HasStream(ctx, STREAM_VIDEO) && !atomic_load(&ctx->abortSeek))
+	{
+		AVDecodeToTarget(ctx, (double)targetTimestamp / AV_TIME_BASE);
+	}
+
+	return ret;
+}
+
+bool AVSeekEnd(MediaStream* media, int result)
+{
+	MediaContext* ctx = media->ctx;
+
+	assert(ctx);
+
+	// Frame found by an accurate seek (AVSeekCore can't upload it)
+	if (result == MEDIA_RET_SUCCEED)
+	{
+		AVFlushVideoFrame(media);
+	}
+
+	// Served by the GOP cache: the workers and the audio stay stopped until the decoder catches up
+	const bool deferred = result == MEDIA_RET_SUCCEED && ctx->deferredSeek;
+
+	if (ctx->seekResumeWorkers && !deferred)
+	{
+		ctx->seekResumeWorkers = false;
+
+		StartMediaWorkers(ctx);
+	}
+
+	const int64_t seekStart = ctx->seekStartTime;
+
+	ctx->seekStartTime = 0;
+
+	if (result == MEDIA_EOF)
+	{
+		// Stops the media, or seeks back to the start when looping
+		NotifyEndOfStream(media);
+
+		return true;
+	}
+
+	// Without an AudioStream (headless or audio callback), only the decoded audio must be dropped
+	if (!IsAudioStreamValid(media->audioStream) && IsBufferReady(&ctx->audioOutputBuffer))
+	{
 		ClearBuffer(&ctx->audioOutputBuffer);
+	}
+
+	// Stopped by AVSeekBegin: restart it even if the seek failed
+	if (IsAudioStreamValid(media->audioStream) && !deferred)
+	{
+		if (result == MEDIA_RET_SUCCEED)
+		{
+			ClearMediaAudio(ctx);
+		}
 
 		switch (GetMediaState(*media))
 		{
@@ -1886,8 +4573,294 @@ bool AVSeek(MediaStream* media, int64_t targetTimestamp)
 		}
 	}	
 
+	if (result != MEDIA_RET_SUCCEED)
+	{
+		return false;
+	}
+
+	ctx->lastSeekTime = av_gettime_relative() - seekStart;
+	ctx->seekTime += ctx->lastSeekTime;
+	ctx->seekCount++;
+
+	return true;
+}
+
+bool AVResolveDeferredSeek(MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	CancelMediaSeek(ctx);
+
+	AVSeekBegin(media);
+
+	return AVSeekEnd(media, AVSeekStreams(ctx, ctx->deferredSeekTarget, true));
+}
+
+void AVDecodeToTarget(MediaContext* ctx, double targetTime)
+{
+	StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+	bool reached = false;
+
+	while (!reached && !atomic_load(&ctx->abortSeek))
+	{
+		AVPacket* packet = NULL;
+
+		// End of the stream or error: the last decoded frame is the closest one
+		if (AVPeekPacket(ctx, STREAM_VIDEO, &packet) != MEDIA_RET_SUCCEED)
+		{
+			break;
+		}
+
+		const int ret = avcodec_send_packet(videoCtx->codecCtx, packet);
+
+		SkipPacket(&videoCtx->pendingPackets);
+
+		if (ret < 0)
+		{
+			AVPrintError(ret); // Skip corrupted packets
+			continue;
+		}
+
+		// Frames come out in presentation order, even if packets don't (B-frames): stop at the first frame
+		// past the target, it's only kept if there is no earlier one
+		while (!reached && avcodec_receive_frame(videoCtx->codecCtx, ctx->avFrame) >= 0)
+		{
+			atomic_fetch_add(&ctx->decodedVideoFrames, 1);
+			ctx->lastSeekDecodedFrames++;
+
+			CacheVideoFrame(ctx, ctx->avFrame);
+
+			reached = AVGetVideoFrameTime(ctx, ctx->avFrame) > targetTime;
+
+			if (reached && ctx->hasPendingVideoFrame)
+			{
+				// Not shown yet, but due right after the target
+				if (ctx->threadedDecode && IsFrameQueueReady(&ctx->decodedFrames))
+				{
+					AVQueueVideoFrame(ctx, ctx->avFrame);
+				}
+				else
+				{
+					av_frame_move_ref(ctx->nextVideoFrame, ctx->avFrame);
+					ctx->hasNextVideoFrame = true;
+				}
+			}
+			else
+			{
+				AVProcessVideoFrame(ctx); // Replaces the pending frame without converting it
+			}
+
+			av_frame_unref(ctx->avFrame);
+		}
+
+		// Reading video packets queues the audio ones, the queue must not fill up with packets before the target
+		AVSkipAudioBefore(ctx, targetTime);
+	}
+
+	ctx->timePos = targetTime;
+}
+
+void AVSkipAudioBefore(MediaContext* ctx, double targetTime)
+{
+	StreamDataContext* audioCtx = &ctx->streams[STREAM_AUDIO];
+
+	if (!audioCtx->codecCtx || audioCtx->startPts == AV_NOPTS_VALUE)
+	{
+		return;
+	}
+
+	const double timeBase = av_q2d(ctx->formatContext->streams[audioCtx->streamIdx]->time_base);
+
+	AVPacket* packet = NULL;
+
+	while ((packet = PeekPacket(&audioCtx->pendingPackets)) != NULL &&
+		(double)(packet->pts + packet->duration - audioCtx->startPts) * timeBase <= targetTime)
+	{
+		SkipPacket(&audioCtx->pendingPackets);
+	}
+}
+
+bool AVStepForward(MediaStream* media, int count)
+{
+	MediaContext* ctx = media->ctx;
+
+	bool resumeWorkers = false;
+	bool ret = true;
+
+	for (int i = 0; ret && i < count; ++i)
+	{
+		const int sequence = ctx->videoFrameSequence;
+
+		// A borrowed frame isn't replaced: the step succeeds only if a new frame was presented
+		ret = AVStepNextFrame(media, &resumeWorkers) && ctx->videoFrameSequence != sequence;
+	}
+
+	if (resumeWorkers)
+	{
+		StartMediaWorkers(ctx);
+	}
+
+	if (!ret)
+	{
+		return false;
+	}
+
+	// Decoded audio was meant for the previous position
+	ClearMediaAudio(ctx);
+
+	ResetTimeStretch(&ctx->timeStretch);
+
+	return true;
+}
+
+bool AVStepNextFrame(MediaStream* media, bool* resumeWorkers)
+{
+	MediaContext* ctx = media->ctx;
+
+	// After a seek served by the GOP cache, the decoder only moves once the cache runs out of frames
+	if (ctx->deferredSeek)
+	{
+		const CachedFrame* next = FindNextCachedFrame(&ctx->gopCache, ctx->videoFrameTime);
+
+		if (next && AVSeek(media, (int64_t)(next->time * AV_TIME_BASE) + 1, true))
+		{
+			return true;
+		}
+
+		if (!AVResolveDeferredSeek(media))
+		{
+			return false;
+		}
+	}
+
+	FrameQueue* frames = &ctx->decodedFrames;
+
+	if (ctx->decodeWorker.running)
+	{
+		// Status is loaded before the queue is checked, as the decode worker sets it only after its last frame
+		const int status = atomic_load(&ctx->decodeStatus);
+
+		if (IsBufferEmpty(&frames->state))
+		{
+			if (status != MEDIA_RET_SUCCEED)
+			{
+				return false;
+			}
+
+			// Take the decoder over rather than waiting for the worker; it may still queue a frame while stopping
+			*resumeWorkers = StopMediaWorkers(ctx) || *resumeWorkers;
+		}
+	}
+
+	// The decode worker already converted the following frames
+	if (IsFrameQueueReady(frames) && !IsBufferEmpty(&frames->state))
+	{
+		ctx->timePos = frames->frames[frames->state.readPos].time;
+
+		return PresentDecodedFrame(media) == MEDIA_RET_SUCCEED;
+	}
+
+	if (ctx->hasNextVideoFrame)
+	{
+		av_frame_move_ref(ctx->avFrame, ctx->nextVideoFrame);
+		ctx->hasNextVideoFrame = false;
+
+		AVProcessVideoFrame(ctx);
+	}
+	else if (AVDecodeNextFrame(ctx) != MEDIA_RET_SUCCEED)
+	{
+		return false;
+	}
+
+	AVFlushVideoFrame(media);
+
+	return true;
+}
+
+bool AVStepBackward(MediaStream* media, int count)
+{
+	MediaContext* ctx = media->ctx;
+
+	for (int i = 0; i < count; ++i)
+	{
+		const double frameTime = ctx->videoFrameTime;
+
+		// Last frame before the displayed one
+		if (frameTime <= 0.0 || !AVSeek(media, (int64_t)(frameTime * AV_TIME_BASE) - 1, true))
+		{
+			return false;
+		}
+
+		// Nothing earlier: the displayed frame is the first one
+		if (ctx->videoFrameTime >= frameTime)
+		{
+			return false;
+		}
+	}
+
 	return true;
+}
+
+int AVDecodeNextFrame(MediaContext* ctx)
+{
+	StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+	bool draining = false;
+
+	while (true)
+	{
+		const int ret = avcodec_receive_frame(videoCtx->codecCtx, ctx->avFrame);
+
+		if (ret >= 0)
+		{
+			atomic_fetch_add(&ctx->decodedVideoFrames, 1);
+
+			CacheVideoFrame(ctx, ctx->avFrame);
+
+			AVProcessVideoFrame(ctx);
+
+			return MEDIA_RET_SUCCEED;
+		}
+
+		if (ret == AVERROR_EOF)
+		{
+			return MEDIA_EOF;
+		}
+
+		if (ret != AVERROR(EAGAIN))
+		{
+			AVPrintError(ret);
+			return MEDIA_ERR_DECODE_VIDEO;
+		}
+
+		// The decoder needs more input; at the end of the stream, it gives back the frames it still holds
+		AVPacket* packet = NULL;
 
+		if (draining || AVPeekPacket(ctx, STREAM_VIDEO, &packet) != MEDIA_RET_SUCCEED)
+		{
+			if (draining)
+			{
+				return MEDIA_EOF;
+			}
+
+			draining = true;
+			avcodec_send_packet(videoCtx->codecCtx, NULL);
+			continue;
+		}
+
+		const int sendRet = avcodec_send_packet(videoCtx->codecCtx, packet);
+
+		SkipPacket(&videoCtx->pendingPackets);
+
+		if (sendRet < 0)
+		{
+			AVPrintError(sendRet); // Skip corrupted packets
+		}
+
+		// Audio packets are not played meanwhile: they must not fill up their queue
+		AVSkipAudioBefore(ctx, ctx->videoFrameTime);
+	}
 }
 
 void AVPrintError(int errCode)
@@ -1933,12 +4906,25 @@ int AVDecodePacket(const MediaStream* media, int streamType, const AVPacket* pac
 			break;
 		}
 
+		if (streamType == STREAM_VIDEO)
+		{
+			// Presented frames are counted once uploaded (see AVFlushVideoFrame)
+			atomic_fetch_add(&media->ctx->decodedVideoFrames, 1);
+
+			CacheVideoFrame(media->ctx, media->ctx->avFrame);
+
+			if (discardPacket)
+			{
+				atomic_fetch_add(&media->ctx->droppedVideoFrames, 1);
+			}
+		}
+
 		if (ret >= 0 && !discardPacket) {
 
 			switch(streamType)
 			{
 			case STREAM_VIDEO:
-				ret = AVProcessVideoFrame(media);
+				ret = AVProcessVideoFrame(media->ctx);
 				break;
 			case STREAM_AUDIO:
 				ret = AVProcessAudioFrame(media);
@@ -1957,142 +4943,4066 @@ int AVDecodePacket(const MediaStream* media, int streamType, const AVPacket* pac
 	return ret;
 }
 
-int  AVProcessVideoFrame(const MediaStream* media)
+int  AVProcessVideoFrame(MediaContext* ctx)
 {
-	const MediaContext* ctx = media->ctx;
-	const AVCodecContext* codec = ctx->streams[STREAM_VIDEO].codecCtx;
-	const int rgbLineSize = codec->width * 3;
+	// A later frame is available within the same update, the previous one would never be visible
+	if (ctx->hasPendingVideoFrame)
+	{
+		av_frame_unref(ctx->pendingVideoFrame);
 
-	// Convert the frame to RGB
-	sws_scale(ctx->swsContext, (const uint8_t* const*)ctx->avFrame->data, ctx->avFrame->linesize, 0, codec->height, (uint8_t* const*) &ctx->videoOutputImage.data, &rgbLineSize);
+		atomic_fetch_add(&ctx->droppedVideoFrames, 1);
+		atomic_fetch_add(&ctx->avoidedVideoConversions, 1);
+	}
 
-	// Update texture with the decoded image data
-	UpdateTexture(media->videoTexture, ctx->videoOutputImage.data);
+	av_frame_move_ref(ctx->pendingVideoFrame, ctx->avFrame);
+	ctx->hasPendingVideoFrame = true;
 
 	return 0;
 }
 
-int  AVProcessAudioFrame(const MediaStream* media)
+void AVFlushVideoFrame(const MediaStream* media)
 {
 	MediaContext* ctx = media->ctx;
 
-	int ret = 0;
+	if (!ctx->hasPendingVideoFrame)
+	{
+		return;
+	}
 
-	// Initialize input data and sample count for conversion. After the first call, inData and inSamples 
-	// will be set to NULL and 0 respectively to signal swr_convert to finish processing remaining data.
-	const uint8_t* const* inData = (const uint8_t* const*)ctx->avFrame->data;
+	// The current frame is borrowed (AcquireMediaFrame), keep this one pending for a later update
+	if (atomic_load(&ctx->frameBorrowers) > 0)
+	{
+		return;
+	}
+
+	// Converted aside: borrowers wait for the frame write window (see AcquireMediaFrame), which only swaps buffers
+	const int64_t convertStart = av_gettime_relative();
+
+	AVConvertVideoFrame(ctx, ctx->pendingVideoFrame, ctx->videoBackBuffer);
+
+	atomic_fetch_add(&ctx->videoConvertTime, av_gettime_relative() - convertStart);
+
+	// Borrowed during the conversion: converted again in a later update
+	if (!BeginVideoFrameWrite(ctx))
+	{
+		return;
+	}
+
+	uint8_t* pixels = ctx->videoBackBuffer;
+	ctx->videoBackBuffer = ctx->videoOutputImage.data;
+	ctx->videoOutputImage.data = pixels;
+	ctx->videoFrameTime = AVGetVideoFrameTime(ctx, ctx->pendingVideoFrame);
+
+	EndVideoFrameWrite(ctx);
+
+	// Update texture with the decoded image data
+	AVUploadVideoImage(media);
+
+	atomic_fetch_add(&ctx->presentedVideoFrames, 1);
+
+	AVDropVideoFrame(ctx);
+}
+
+void AVUploadVideoImage(const MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	if (ctx->headless || !ctx->textureUpload)
+	{
+		return;
+	}
+
+	const int64_t uploadStart = av_gettime_relative();
+
+	if (ctx->yuvOutput)
+	{
+		uint8_t* planes[4] = { 0 };
+		int lineSizes[4] = { 0 };
+
+		AVGetVideoPlanes(ctx, ctx->videoOutputImage.data, planes, lineSizes);
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (IsTextureValid(media->videoPlanes[i]))
+			{
+				UpdateTexture(media->videoPlanes[i], planes[i]);
+			}
+		}
+	}
+	else
+	{
+		UpdateTexture(media->videoTexture, ctx->videoOutputImage.data);
+	}
+
+	atomic_fetch_add(&ctx->videoUploadTime, av_gettime_relative() - uploadStart);
+}
+
+void AVDropVideoFrame(MediaContext* ctx)
+{
+	if (ctx->hasPendingVideoFrame)
+	{
+		av_frame_unref(ctx->pendingVideoFrame);
+		ctx->hasPendingVideoFrame = false;
+	}
+}
+
+void AVDropNextVideoFrame(MediaContext* ctx)
+{
+	if (ctx->hasNextVideoFrame)
+	{
+		av_frame_unref(ctx->nextVideoFrame);
+		ctx->hasNextVideoFrame = false;
+	}
+}
+
+void AVQueueVideoFrame(MediaContext* ctx, const AVFrame* frame)
+{
+	FrameQueue* frames = &ctx->decodedFrames;
+	VideoFrame* slot = &frames->frames[frames->state.writePos];
+
+	slot->time = AVGetVideoFrameTime(ctx, frame);
+
+	const int64_t convertStart = av_gettime_relative();
+
+	AVConvertVideoFrame(ctx, frame, slot->data);
+
+	atomic_fetch_add(&ctx->videoConvertTime, av_gettime_relative() - convertStart);
+
+	AdvanceWritePos(&frames->state);
+}
+
+void AVSetVideoCatchUp(MediaContext* ctx, bool enable)
+{
+	if (ctx->catchingUp == enable)
+	{
+		return;
+	}
+
+	AVCodecContext* codecCtx = ctx->streams[STREAM_VIDEO].codecCtx;
+
+	// Skipping the loop filter degrades reference frames too: artifacts may remain until the next keyframe
+	codecCtx->skip_frame       = enable ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+	codecCtx->skip_loop_filter = enable ? AVDISCARD_ALL    : AVDISCARD_DEFAULT;
+	codecCtx->skip_idct        = enable ? AVDISCARD_BIDIR  : AVDISCARD_DEFAULT;
+
+	ctx->catchingUp = enable;
+
+	TraceLog(LOG_DEBUG, "MEDIA: Video decoding %s.", enable ? "lagging, fast catch-up enabled" : "on time, back to full quality");
+}
+
+void AVGetVideoOutputSize(const AVCodecContext* codecCtx, int requestedWidth, int requestedHeight, int* width, int* height)
+{
+	*width = codecCtx->width;
+	*height = codecCtx->height;
+
+	if (requestedWidth > 0 && requestedHeight > 0)
+	{
+		*width = requestedWidth;
+		*height = requestedHeight;
+	}
+	else if (requestedWidth > 0)
+	{
+		*width = requestedWidth;
+		*height = MAX(1, (int)av_rescale(requestedWidth, codecCtx->height, codecCtx->width));
+	}
+	else if (requestedHeight > 0)
+	{
+		*width = MAX(1, (int)av_rescale(requestedHeight, codecCtx->width, codecCtx->height));
+		*height = requestedHeight;
+	}
+}
+
+bool AVLoadVideoOutput(MediaContext* ctx, int width, int height)
+{
+	const AVCodecContext* codecCtx = ctx->streams[STREAM_VIDEO].codecCtx;
+	const bool scaled = (width != codecCtx->width || height != codecCtx->height);
+
+	if (ctx->yuvOutput)
+	{
+		// 4:2:0 planes the shader can sample are uploaded as decoded, other formats go through swscale
+		const enum AVPixelFormat srcFormat = codecCtx->pix_fmt;
+		const bool supported = (srcFormat == AV_PIX_FMT_YUV420P || srcFormat == AV_PIX_FMT_YUVJ420P || srcFormat == AV_PIX_FMT_NV12);
+
+		ctx->videoOutputFormat = supported ? srcFormat : AV_PIX_FMT_YUV420P;
+		ctx->videoPixelSize = 1;
+		ctx->yuvDirectCopy = supported && !scaled;
+		ctx->yuvFullRange = (ctx->videoOutputFormat == AV_PIX_FMT_YUVJ420P) || (ctx->yuvDirectCopy && codecCtx->color_range == AVCOL_RANGE_JPEG);
+		ctx->yuvColorMatrix = (codecCtx->colorspace == AVCOL_SPC_BT709) ? 1 : 0;
+	}
+	else
+	{
+		// Output pixel layout (MEDIA_VIDEO_FORMAT)
+		ctx->videoOutputFormat = (ctx->config.videoFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) ? AV_PIX_FMT_RGBA : AV_PIX_FMT_RGB24;
+		ctx->videoPixelSize = (ctx->videoOutputFormat == AV_PIX_FMT_RGBA) ? 4 : 3;
+	}
+
+	// Video resampling and scaling context
+	if (!ctx->yuvDirectCopy)
+	{
+		ctx->swsContext = sws_getContext(
+			codecCtx->width, codecCtx->height, codecCtx->pix_fmt,  // Input format
+			width, height, ctx->videoOutputFormat,                 // Output format
+			SWS_BILINEAR, NULL, NULL, NULL);
+
+		if(!ctx->swsContext)
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Cannot initialize the SWS context.");
+			return false;
+		}
+
+		// YUV output keeps the range of the source, see yuvFullRange
+		if (!ctx->yuvOutput)
+		{
+			AVSetSwsColorspace(ctx->swsContext, codecCtx);
+		}
+	}
+
+	// Built-in converter for the common formats and color spaces, swscale stays available as fallback.
+	// Note: the kernels don't scale.
+	if (ctx->config.videoFastConvert && !scaled && !ctx->yuvOutput)
+	{
+		ctx->yuvCoefficients = GetYUVCoefficients(codecCtx);
+		ctx->yuvRowKernel = ctx->yuvCoefficients ? GetYUVRowKernel(codecCtx->pix_fmt) : NULL;
+	}
+
+	// Parallel conversion in bands, requires the shared worker pool (acquired once the context is loaded).
+	// Bands are converted independently, which a vertical filter spanning band edges doesn't allow when scaling.
+	int bandCount = (scaled || ctx->yuvOutput) ? 1 : ctx->config.videoConvertBands;
+
+	if (bandCount == 0)
+	{
+		const int threadCount = ctx->config.workerThreads > 0 ? ctx->config.workerThreads : av_cpu_count();
+
+		bandCount = MIN(threadCount, codecCtx->height / MEDIA_CONVERT_MIN_BAND);
+	}
+
+	if (bandCount > 1)
+	{
+		AVLoadConvertBands(ctx, bandCount);
+	}
+
+	//-------------------------------------------------------------
+
+	const int frameSize = av_image_get_buffer_size(ctx->videoOutputFormat, width, height, 1);
+
+	ctx->videoFrameSize = frameSize;
+	ctx->videoOutputImage.data = AVAllocVideoBuffer(&ctx->streams[STREAM_VIDEO].memory, frameSize);
+	ctx->videoBackBuffer = AVAllocVideoBuffer(&ctx->streams[STREAM_VIDEO].memory, frameSize);
+
+	if(!ctx->videoOutputImage.data || !ctx->videoBackBuffer)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Cannot allocate memory for holding the decoded frame.");
+		AVUnloadVideoOutput(ctx);
+		return false;
+	}
+
+	// With YUV output, the image shows the luma plane, followed in memory by the chroma planes
+	ctx->videoOutputImage.width   = width;
+	ctx->videoOutputImage.height  = height;
+	ctx->videoOutputImage.mipmaps = 1;
+	ctx->videoOutputImage.format  = ctx->yuvOutput ? PIXELFORMAT_UNCOMPRESSED_GRAYSCALE : ctx->config.videoFormat;
+
+	if (ctx->yuvOutput)
+	{
+		// Black: lowest luma and neutral chroma
+		uint8_t* planes[4] = { 0 };
+		int lineSizes[4] = { 0 };
+
+		AVGetVideoPlanes(ctx, ctx->videoOutputImage.data, planes, lineSizes);
+
+		memset(planes[0], ctx->yuvFullRange ? 0 : 16, (size_t)lineSizes[0] * height);
+		memset(planes[1], 128, frameSize - (planes[1] - planes[0]));
+	}
+	else
+	{
+		ImageClearBackground(&ctx->videoOutputImage, BLANK);
+	}
+
+	//-------------------------------------------------------------
+
+	if (ctx->threadedDecode)
+	{
+		ctx->decodedFrames = LoadFrameQueue(ctx->config.videoFrameQueueSize, frameSize, &ctx->streams[STREAM_VIDEO].memory);
+
+		if (!IsFrameQueueReady(&ctx->decodedFrames))
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Cannot initialize the decoded frame queue, video will be decoded on the calling thread.");
+
+			ctx->threadedDecode = false;
+		}
+	}
+
+	if (scaled)
+	{
+		TraceLog(LOG_INFO, "MEDIA: Video scaled from %ix%i to %ix%i.", codecCtx->width, codecCtx->height, width, height);
+	}
+
+	return true;
+}
+
+void AVGetVideoPlanes(const MediaContext* ctx, uint8_t* data, uint8_t* planes[4], int lineSizes[4])
+{
+	av_image_fill_arrays(planes, lineSizes, data, ctx->videoOutputFormat, ctx->videoOutputImage.width, ctx->videoOutputImage.height, 1);
+}
+
+void AVUnloadVideoOutput(MediaContext* ctx)
+{
+	if(ctx->swsContext)
+	{
+		sws_freeContext(ctx->swsContext);
+		ctx->swsContext = NULL;
+	}
+
+	ctx->yuvRowKernel = NULL;
+	ctx->yuvCoefficients = NULL;
+	ctx->yuvDirectCopy = false;
+
+	AVUnloadConvertBands(ctx);
+
+	if (IsFrameQueueReady(&ctx->decodedFrames))
+	{
+		UnloadFrameQueue(&ctx->decodedFrames);
+	}
+
+	if (IsImageValid(ctx->videoOutputImage))
+	{
+		MediaAlignedFree(ctx->videoOutputImage.data);
+		ctx->videoOutputImage = (Image){ 0 };
+	}
+
+	MediaAlignedFree(ctx->videoBackBuffer);
+	ctx->videoBackBuffer = NULL;
+}
+
+double AVGetVideoFrameTime(const MediaContext* ctx, const AVFrame* frame)
+{
+	const StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+	const int64_t pts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+
+	return (double)(pts - videoCtx->startPts) * av_q2d(ctx->formatContext->streams[videoCtx->streamIdx]->time_base);
+}
+
+double AVGetAudioFrameTime(const MediaContext* ctx, const AVFrame* frame)
+{
+	const StreamDataContext* audioCtx = &ctx->streams[STREAM_AUDIO];
+
+	const int64_t pts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+
+	if (pts == AV_NOPTS_VALUE || audioCtx->startPts == AV_NOPTS_VALUE)
+	{
+		return ctx->audioEndTime;
+	}
+
+	return (double)(pts - audioCtx->startPts) * av_q2d(ctx->formatContext->streams[audioCtx->streamIdx]->time_base);
+}
+
+void AVConvertVideoFrame(const MediaContext* ctx, const AVFrame* frame, uint8_t* dst)
+{
+	const AVCodecContext* codec = ctx->streams[STREAM_VIDEO].codecCtx;
+	const int rgbLineSize = ctx->videoOutputImage.width * ctx->videoPixelSize;
+
+	if (ctx->convertBandCount <= 1 && ctx->yuvRowKernel)
+	{
+		ConvertYUVRows(ctx->yuvRowKernel, ctx->yuvCoefficients, frame, dst, rgbLineSize, codec->width, ctx->videoPixelSize, 0, codec->height);
+		return;
+	}
+
+	if (ctx->yuvDirectCopy)
+	{
+		// Drops the padding of the decoder rows, the textures expect tightly packed planes
+		av_image_copy_to_buffer(dst, ctx->videoFrameSize, (const uint8_t* const*)frame->data, frame->linesize,
+								ctx->videoOutputFormat, codec->width, codec->height, 1);
+		return;
+	}
+
+	if (ctx->convertBandCount <= 1)
+	{
+		uint8_t* planes[4] = { 0 };
+		int lineSizes[4] = { 0 };
+
+		AVGetVideoPlanes(ctx, dst, planes, lineSizes);
+
+		sws_scale(ctx->swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, codec->height, planes, lineSizes);
+		return;
+	}
+
+	// Fork: the calling thread converts the first band, the pool the others
+	atomic_int pending = ctx->convertBandCount;
+
+	for (int i = ctx->convertBandCount - 1; i >= 0; --i)
+	{
+		ConvertBand* band = &ctx->convertBands[i];
+
+		band->frame = frame;
+		band->dst = dst;
+		band->pending = &pending;
+
+		if (i == 0 || !SubmitUrgentPoolJob((PoolJob){ RunConvertBand, band }))
+		{
+			RunConvertBand(band);
+		}
+	}
+
+	// Join: help with urgent jobs only, a background worker step could keep this thread busy for much longer
+	while (atomic_load_explicit(&pending, memory_order_acquire) > 0)
+	{
+		PoolJob job;
+
+		if (TakeUrgentPoolJob(&job))
+		{
+			job.run(job.arg);
+		}
+		else
+		{
+			sched_yield();
+		}
+	}
+}
+
+bool AVLoadConvertBands(MediaContext* ctx, int bandCount)
+{
+	const AVCodecContext* codec = ctx->streams[STREAM_VIDEO].codecCtx;
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(codec->pix_fmt);
+
+	// Each band is converted as a standalone image: it needs a format whose rows can be addressed plane by plane
+	if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL)))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Video format can't be converted in bands, using a single band.");
+		return false;
+	}
+
+	// Bands must start on a chroma row
+	const int rowAlign = 1 << desc->log2_chroma_h;
+
+	bandCount = MIN(bandCount, codec->height / rowAlign);
+
+	if (bandCount <= 1)
+	{
+		return false;
+	}
+
+	const int bandHeight = (((codec->height + bandCount - 1) / bandCount + rowAlign - 1) / rowAlign) * rowAlign;
+
+	bandCount = (codec->height + bandHeight - 1) / bandHeight;
+
+	ctx->convertBands = MediaCalloc(&ctx->streams[STREAM_VIDEO].memory, bandCount, sizeof(ConvertBand));
+
+	if (!ctx->convertBands)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to allocate memory for the conversion bands.");
+		return false;
+	}
+
+	ctx->convertBandCount = bandCount;
+
+	for (int i = 0; i < bandCount; ++i)
+	{
+		ConvertBand* band = &ctx->convertBands[i];
+
+		band->y = i * bandHeight;
+		band->height = MIN(bandHeight, codec->height - band->y);
+		band->chromaShift = desc->log2_chroma_h;
+		band->dstLineSize = codec->width * ctx->videoPixelSize;
+		band->width = codec->width;
+		band->rowKernel = ctx->yuvRowKernel;
+		band->rowCoefficients = ctx->yuvCoefficients;
+
+		if (band->rowKernel)
+		{
+			continue;
+		}
+
+		band->swsContext = sws_getContext(
+			codec->width, band->height, codec->pix_fmt,  // Input format
+			codec->width, band->height, ctx->videoOutputFormat,  // Output format
+			SWS_BILINEAR, NULL, NULL, NULL);
+
+		if (!band->swsContext)
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Cannot initialize the SWS context of conversion band #%i.", i);
+			AVUnloadConvertBands(ctx);
+			return false;
+		}
+
+		AVSetSwsColorspace(band->swsContext, codec);
+	}
+
+	TraceLog(LOG_INFO, "MEDIA: Video frames converted in %i bands of %i rows.", bandCount, bandHeight);
+
+	return true;
+}
+
+void AVUnloadConvertBands(MediaContext* ctx)
+{
+	if (ctx->convertBands)
+	{
+		for (int i = 0; i < ctx->convertBandCount; ++i)
+		{
+			if (ctx->convertBands[i].swsContext)
+			{
+				sws_freeContext(ctx->convertBands[i].swsContext);
+			}
+		}
+
+		MediaFree(ctx->convertBands);
+	}
+
+	ctx->convertBands = NULL;
+	ctx->convertBandCount = 0;
+}
+
+void RunConvertBand(void* arg)
+{
+	const ConvertBand* band = (const ConvertBand*)arg;
+	const AVFrame* frame = band->frame;
+
+	if (band->rowKernel)
+	{
+		ConvertYUVRows(band->rowKernel, band->rowCoefficients, frame, band->dst, band->dstLineSize, band->width, band->dstLineSize / band->width, band->y, band->y + band->height);
+
+		atomic_fetch_sub_explicit(band->pending, 1, memory_order_release);
+		return;
+	}
+
+	const uint8_t* src[AV_NUM_DATA_POINTERS] = { 0 };
+
+	// Chroma planes (1 and 2) are vertically subsampled, luma and alpha planes are not
+	for (int p = 0; p < AV_NUM_DATA_POINTERS && frame->data[p]; ++p)
+	{
+		const int row = (p == 1 || p == 2) ? (band->y >> band->chromaShift) : band->y;
+
+		src[p] = frame->data[p] + (ptrdiff_t)row * frame->linesize[p];
+	}
+
+	uint8_t* dst = band->dst + (ptrdiff_t)band->y * band->dstLineSize;
+
+	sws_scale(band->swsContext, src, frame->linesize, 0, band->height, (uint8_t* const*)&dst, &band->dstLineSize);
+
+	// Must be the last access to the band: the converting thread may return as soon as the count reaches zero
+	atomic_fetch_sub_explicit(band->pending, 1, memory_order_release);
+}
+
+uint8_t* AVAllocVideoBuffer(MemoryUsage* memory, int size)
+{
+	return MediaAlignedMalloc(memory, size);
+}
+
+int  AVProcessAudioFrame(const MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	ctx->audioEndTime = AVGetAudioFrameTime(ctx, ctx->avFrame) + (double)ctx->avFrame->nb_samples / ctx->audioSampleRate;
+
+	if (IsTimeStretchReady(&ctx->timeStretch))
+	{
+		// Off 1x the audio goes through the time-stretcher
+		if (ctx->timeStretch.rate != 1.0)
+		{
+			return AVStretchAudioFrame(ctx);
+		}
+
+		// Back at 1x: what it still holds goes out first, then the samples pass through
+		AVFlushTimeStretch(ctx);
+	}
+
+	int ret = 0;
+
+	// Initialize input data and sample count for conversion. After the first call, inData and inSamples 
+	// will be set to NULL and 0 respectively to signal swr_convert to finish processing remaining data.
+	const uint8_t* const* inData = (const uint8_t* const*)ctx->avFrame->data;
+	int inSamples = ctx->avFrame->nb_samples;
+
+	// Initialize the number of samples left to convert. The loop will continue until all samples are converted.
+	int leftSamples = inSamples;
+
+	do
+	{
+		const int writableSegmentSizeBytes = GetBufferWritableSegmentSize(&ctx->audioOutputBuffer.state);
+
+		// Number of bytes per audio frame, based on sample size and channel count.
+		const int bytesPerFrame = ctx->audioBytesPerFrame;
+
+		// Calculate the writable segment size in terms of audio samples.
+		const int writableSegmentSizeSamples = writableSegmentSizeBytes / bytesPerFrame;
+
+		// Full, or less than a frame left before the read position
+		if(writableSegmentSizeSamples <= 0)
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Not enough space for decoding in the audio buffer.");
+			ctx->audioOverflows++;
+			ret = MEDIA_ERR_OVERFLOW;
+			break;
+		}
+
+		uint8_t* outputBuffer = &ctx->audioOutputBuffer.data[ctx->audioOutputBuffer.state.writePos];
+
+		// Convert and store the incoming audio samples into the output buffer.
+		// This will fill up to the writable segment size in samples, using the provided input data.
+		const int convertedSamples = swr_convert(ctx->swrContext,
+		                                         &outputBuffer,
+		                                         writableSegmentSizeSamples,
+		                                         inData,
+			 									 inSamples);
+
+		if(convertedSamples < 0)
+		{
+			AVPrintError(convertedSamples);
+			ret = MEDIA_ERR_DECODE_AUDIO;
+			break; 
+		}
+
+		// Calculate the size in bytes of the converted samples just written to the buffer.
+		const int convertedSamplesBytes = av_samples_get_buffer_size(
+			NULL,
+			ctx->audioChannels,
+			convertedSamples,
+			ctx->audioOutputFmt,
+			1
+		);
+
+		AdvanceWritePosN(&ctx->audioOutputBuffer.state, convertedSamplesBytes);
+
+		leftSamples -= convertedSamples;
+
+		// Setting inData to NULL and inSamples to 0 instructs subsequent swr_convert calls
+		// to process any remaining buffered data
+		inData = NULL;
+		inSamples = 0;
+
+	} while (leftSamples > 0);
+
+	return ret;
+}
+
+
+bool AVLoadCodecContext(StreamDataContext* streamCtx, const AVCodec* codec, const AVCodecParameters* params, int threadCount, int threadType)
+{
+	if (streamCtx->codecCtx)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Multiple stream of the same type (%i), only the first will be used.", params->codec_type);
+
+		return MEDIA_ERR_DUPLICATE_STREAM;
+	}
+
+	streamCtx->startPts = AV_NOPTS_VALUE;
+
+	streamCtx->codecCtx = avcodec_alloc_context3(codec);
+
+	if (!streamCtx->codecCtx)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed to allocate memory for a codec (type %i)", params->codec_type);
+
+		return MEDIA_ERR_CODEC_ALLOC_FAILED;
+	}
+
+	// Paired with AVUnloadCodecContext, like codecCtx
+	streamCtx->framePool = NULL;
+	streamCtx->framePoolBufferSize = 0;
+	atomic_store(&streamCtx->frameBufferAllocations, 0);
+	pthread_mutex_init(&streamCtx->framePoolLock, NULL);
+
+	int ret = avcodec_parameters_to_context(streamCtx->codecCtx, params);
+
+	if (ret < 0)
+	{
+		AVPrintError(ret);
+
+		return MEDIA_ERR_CTX_PARAMS_FAILED;
+	}
+
+	// Must be set before opening the codec. MediaDecodeThreadType values match FF_THREAD_FRAME and FF_THREAD_SLICE.
+	streamCtx->codecCtx->thread_count = threadCount;
+	streamCtx->codecCtx->thread_type = threadType;
+
+	if (params->codec_type == AVMEDIA_TYPE_VIDEO)
+	{
+		streamCtx->codecCtx->opaque = streamCtx;
+		streamCtx->codecCtx->get_buffer2 = AVGetFrameBuffer;
+	}
+
+	// Initialize the AVCodecContext to use the given AVCodec.
+	ret = avcodec_open2(streamCtx->codecCtx, codec, NULL);
+
+	if (ret < 0)
+	{
+		AVPrintError(ret);
+
+		return MEDIA_ERR_CODEC_OPEN_FAILED;
+	}
+
+	return MEDIA_RET_SUCCEED;
+}
+
+void AVUnloadCodecContext(StreamDataContext* streamCtx)
+{
+	assert(streamCtx->codecCtx);
+
+	avcodec_free_context(&streamCtx->codecCtx);
+
+	// Buffers still referenced by frames (e.g. the frame queue) keep the pool alive until they are released
+	av_buffer_pool_uninit(&streamCtx->framePool);
+	pthread_mutex_destroy(&streamCtx->framePoolLock);
+}
+
+int AVGetFrameBuffer(AVCodecContext* codecCtx, AVFrame* frame, int flags)
+{
+	StreamDataContext* streamCtx = codecCtx->opaque;
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(frame->format);
+
+	if (!desc || (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_HWACCEL)) ||
+		!(codecCtx->codec->capabilities & AV_CODEC_CAP_DR1))
+	{
+		return avcodec_default_get_buffer2(codecCtx, frame, flags);
+	}
+
+	// Decoders may write past the visible area: pad the dimensions and the rows as the codec requires
+	int width = frame->width;
+	int height = frame->height;
+	int lineAlign[AV_NUM_DATA_POINTERS];
+	avcodec_align_dimensions2(codecCtx, &width, &height, lineAlign);
+
+	int lineSizes[4] = { 0 };
+	ptrdiff_t planeLineSizes[4] = { 0 };
+	size_t planeSizes[4] = { 0 };
+
+	if (av_image_fill_linesizes(lineSizes, frame->format, width) < 0)
+	{
+		return avcodec_default_get_buffer2(codecCtx, frame, flags);
+	}
+
+	for (int i = 0; i < 4; ++i)
+	{
+		// Also keeps every plane aligned, as the planes share a single buffer
+		lineSizes[i] = FFALIGN(lineSizes[i], MAX(MEDIA_FRAME_ALIGN, lineAlign[i]));
+		planeLineSizes[i] = lineSizes[i];
+	}
+
+	if (av_image_fill_plane_sizes(planeSizes, frame->format, height, planeLineSizes) < 0)
+	{
+		return avcodec_default_get_buffer2(codecCtx, frame, flags);
+	}
+
+	// Extra bytes for the SIMD readers overrunning the last row
+	size_t bufferSize = planeSizes[0] + planeSizes[1] + planeSizes[2] + planeSizes[3] + MEDIA_FRAME_ALIGN;
+
+	pthread_mutex_lock(&streamCtx->framePoolLock);
+
+	if (!streamCtx->framePool || streamCtx->framePoolBufferSize != bufferSize)
+	{
+		// New stream dimensions: buffers of the previous pool are freed as soon as their frames release them
+		av_buffer_pool_uninit(&streamCtx->framePool);
+
+		streamCtx->framePool = av_buffer_pool_init2(bufferSize, streamCtx, AVAllocFrameBuffer, NULL);
+		streamCtx->framePoolBufferSize = bufferSize;
+	}
+
+	AVBufferRef* buffer = streamCtx->framePool ? av_buffer_pool_get(streamCtx->framePool) : NULL;
+
+	pthread_mutex_unlock(&streamCtx->framePoolLock);
+
+	if (!buffer)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed to allocate a frame buffer of %zu bytes.", bufferSize);
+
+		return AVERROR(ENOMEM);
+	}
+
+	frame->buf[0] = buffer;
+	av_image_fill_pointers(frame->data, frame->format, height, buffer->data, lineSizes);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		frame->linesize[i] = lineSizes[i];
+	}
+
+	frame->extended_data = frame->data;
+
+	return 0;
+}
+
+AVBufferRef* AVAllocFrameBuffer(void* opaque, size_t size)
+{
+	StreamDataContext* streamCtx = opaque;
+
+	atomic_fetch_add(&streamCtx->frameBufferAllocations, 1);
+
+	uint8_t* data = MediaAlignedMalloc(&streamCtx->memory, size);
+
+	if (!data)
+	{
+		return NULL;
+	}
+
+	AVBufferRef* buffer = av_buffer_create(data, size, AVFreeFrameBuffer, NULL, 0);
+
+	if (!buffer)
+	{
+		MediaAlignedFree(data);
+	}
+
+	return buffer;
+}
+
+void AVFreeFrameBuffer(void* opaque, uint8_t* data)
+{
+	MediaAlignedFree(data);
+}
+
+int AVDemuxStep(MediaContext* ctx)
+{
+	if (atomic_load(&ctx->demuxStatus) != MEDIA_RET_SUCCEED)
+	{
+		return WORKER_IDLE; // Nothing left to read until the next seek
+	}
+
+	AVPacket* packet = ctx->demuxPacket;
+
+	if (!ctx->demuxPending)
+	{
+		const int ret = av_read_frame(ctx->formatContext, packet);
+
+		if (ret == AVERROR(EAGAIN))
+		{
+			return WORKER_IDLE;
+		}
+
+		if (ret < 0)
+		{
+			if (ret != AVERROR_EOF)
+			{
+				AVPrintError(ret);
+				TraceLog(LOG_ERROR, "MEDIA: Error reading packet in the demux worker");
+			}
+
+			atomic_store(&ctx->demuxStatus, ret == AVERROR_EOF ? MEDIA_EOF : MEDIA_ERR_GRAB_PACKET);
+
+			return WORKER_IDLE;
+		}
+
+		ctx->demuxPending = true;
+	}
+
+	PacketQueue* queue = GetStreamPacketQueue(ctx, packet->stream_index);
+
+	if (!queue) // Unhandled packet
+	{
+		av_packet_unref(packet);
+		ctx->demuxPending = false;
+		return WORKER_PROGRESS;
+	}
+
+	// Keep the packet until the consumer makes room for it
+	if (IsQueueFull(queue))
+	{
+		return WORKER_IDLE;
+	}
+
+	EnqueuePacket(queue, packet);
+	ctx->demuxPending = false;
+
+	// The decode worker may be waiting for this packet
+	if (queue == &ctx->streams[STREAM_VIDEO].pendingPackets)
+	{
+		WakeWorker(&ctx->decodeWorker);
+	}
+
+	return WORKER_PROGRESS;
+}
+
+PacketQueue* GetStreamPacketQueue(MediaContext* ctx, int streamIndex)
+{
+	for (int i = 0; i < STREAM_COUNT; ++i)
+	{
+		if (ctx->streams[i].codecCtx && streamIndex == ctx->streams[i].streamIdx)
+		{
+			return &ctx->streams[i].pendingPackets;
+		}
+	}
+
+	return NULL;
+}
+
+int AVDecodeStep(MediaContext* ctx)
+{
+	if (atomic_load(&ctx->decodeStatus) != MEDIA_RET_SUCCEED)
+	{
+		return WORKER_IDLE; // Nothing left to decode until the next seek
+	}
+
+	FrameQueue* frames = &ctx->decodedFrames;
+
+	// Don't pull a frame out of the decoder before there is room for it
+	if (IsBufferFull(&frames->state))
+	{
+		return WORKER_IDLE;
+	}
+
+	StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+	int ret = avcodec_receive_frame(videoCtx->codecCtx, ctx->decodeFrame);
+
+	if (ret >= 0)
+	{
+		CacheVideoFrame(ctx, ctx->decodeFrame);
+
+		AVQueueVideoFrame(ctx, ctx->decodeFrame);
+
+		av_frame_unref(ctx->decodeFrame);
+
+		atomic_fetch_add(&ctx->decodedVideoFrames, 1);
+
+		return WORKER_PROGRESS;
+	}
+
+	if (ret == AVERROR_EOF)
+	{
+		atomic_store(&ctx->decodeStatus, MEDIA_EOF);
+		return WORKER_IDLE;
+	}
+
+	if (ret != AVERROR(EAGAIN))
+	{
+		AVPrintError(ret);
+		atomic_store(&ctx->decodeStatus, MEDIA_ERR_DECODE_VIDEO);
+		return WORKER_IDLE;
+	}
+
+	// The decoder needs more input
+	if (ctx->decodeDraining)
+	{
+		return WORKER_IDLE;
+	}
+
+	PacketQueue* queue = &videoCtx->pendingPackets;
+
+	// Status is loaded before the queue is checked, as the demux worker sets it only after its last enqueue
+	const int demuxStatus = atomic_load(&ctx->demuxStatus);
+
+	AVPacket* packet = PeekPacket(queue);
+
+	if (!packet)
+	{
+		if (demuxStatus == MEDIA_RET_SUCCEED)
+		{
+			return WORKER_IDLE;
+		}
+
+		// No more packets will come: let the decoder output the frames it's still holding
+		avcodec_send_packet(videoCtx->codecCtx, NULL);
+		ctx->decodeDraining = true;
+
+		return WORKER_PROGRESS;
+	}
+
+	if (videoCtx->startPts == AV_NOPTS_VALUE)
+	{
+		videoCtx->startPts = packet->pts;
+	}
+
+	ret = avcodec_send_packet(videoCtx->codecCtx, packet);
+
+	if (ret < 0)
+	{
+		AVPrintError(ret); // Skip corrupted packets
+	}
+
+	SkipPacket(queue);
+
+	// The demux worker may be waiting for room in the queue
+	WakeWorker(&ctx->demuxWorker);
+
+	return WORKER_PROGRESS;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Keyframe index
+//---------------------------------------------------------------------------------------------------
+
+void LoadKeyframeIndex(MediaContext* ctx, const char* fileName, bool useCache)
+{
+	const StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+	const AVStream* stream = ctx->formatContext->streams[videoCtx->streamIdx];
+
+	if (LoadContainerKeyframes(ctx, &ctx->keyframeIndex))
+	{
+		TraceLog(LOG_DEBUG, "MEDIA: Keyframe index taken from the container (%i keyframes).", ctx->keyframeIndex.count);
+		atomic_store(&ctx->indexStatus, INDEX_STATUS_READY);
+		return;
+	}
+
+	if (!fileName)
+	{
+		TraceLog(LOG_DEBUG, "MEDIA: Incomplete container index, custom streams can't be scanned for keyframes.");
+		return;
+	}
+
+	ctx->indexHeader = (KeyframeIndexHeader){ 0 };
+	memcpy(ctx->indexHeader.magic, MEDIA_INDEX_FILE_MAGIC, sizeof(ctx->indexHeader.magic));
+	ctx->indexHeader.fileSize = avio_size(ctx->formatContext->pb);
+	ctx->indexHeader.fileTime = GetFileModTime(fileName);
+	ctx->indexHeader.streamIdx = videoCtx->streamIdx;
+	ctx->indexHeader.timeBaseNum = stream->time_base.num;
+	ctx->indexHeader.timeBaseDen = stream->time_base.den;
+
+	if (useCache)
+	{
+		const size_t length = strlen(fileName) + sizeof(MEDIA_INDEX_FILE_EXT);
+
+		ctx->indexCacheFileName = MediaMalloc(&ctx->sharedMemory, length);
+
+		if (ctx->indexCacheFileName)
+		{
+			snprintf(ctx->indexCacheFileName, length, "%s%s", fileName, MEDIA_INDEX_FILE_EXT);
+
+			if (LoadKeyframeIndexCache(&ctx->keyframeIndex, ctx->indexCacheFileName, &ctx->indexHeader, &ctx->streams[STREAM_VIDEO].memory))
+			{
+				TraceLog(LOG_DEBUG, "MEDIA: Keyframe index loaded from '%s' (%i keyframes).", ctx->indexCacheFileName, ctx->keyframeIndex.count);
+				atomic_store(&ctx->indexStatus, INDEX_STATUS_READY);
+				return;
+			}
+		}
+	}
+
+	ctx->indexFileName = MediaMalloc(&ctx->sharedMemory, strlen(fileName) + 1);
+
+	if (!ctx->indexFileName)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Can't scan '%s' for keyframes, seeking without a keyframe index.", fileName);
+		return;
+	}
+
+	strcpy(ctx->indexFileName, fileName);
+	atomic_store(&ctx->indexStatus, INDEX_STATUS_PENDING);
+
+	// A scan may read the whole file for seconds: on a pool thread it would hold back the workers of every media
+	if (pthread_create(&ctx->indexThread, NULL, RunKeyframeScan, ctx) != 0)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed to create the keyframe scan thread, seeking without a keyframe index.");
+		atomic_store(&ctx->indexStatus, INDEX_STATUS_FAILED);
+		return;
+	}
+
+	ctx->indexThreadRunning = true;
+}
+
+void UnloadKeyframeIndex(MediaContext* ctx)
+{
+	if (ctx->indexThreadRunning)
+	{
+		atomic_store(&ctx->abortIndex, true);
+
+		pthread_join(ctx->indexThread, NULL);
+		ctx->indexThreadRunning = false;
+	}
+
+	FreeKeyframeIndexData(&ctx->keyframeIndex);
+
+	MediaFree(ctx->indexFileName);
+	MediaFree(ctx->indexCacheFileName);
+	ctx->indexFileName = NULL;
+	ctx->indexCacheFileName = NULL;
+
+	atomic_store(&ctx->indexStatus, INDEX_STATUS_NONE);
+}
+
+bool LoadContainerKeyframes(MediaContext* ctx, KeyframeIndex* index)
+{
+	AVStream* stream = ctx->formatContext->streams[ctx->streams[STREAM_VIDEO].streamIdx];
+
+	const int entryCount = avformat_index_get_entries_count(stream);
+
+	if (entryCount <= 0)
+	{
+		return false;
+	}
+
+	int64_t duration = stream->duration;
+
+	if (duration == AV_NOPTS_VALUE && ctx->formatContext->duration != AV_NOPTS_VALUE)
+	{
+		duration = av_rescale_q(ctx->formatContext->duration, AV_TIME_BASE_Q, stream->time_base);
+	}
+
+	const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+	const int64_t margin = av_rescale_q((int64_t)(MEDIA_INDEX_END_MARGIN * AV_TIME_BASE), AV_TIME_BASE_Q, stream->time_base);
+
+	// Some demuxers (e.g. MPEG-TS) only index what they have read so far
+	if (duration == AV_NOPTS_VALUE || duration <= 0 ||
+		avformat_index_get_entry(stream, entryCount - 1)->timestamp < start + duration - margin)
+	{
+		return false;
+	}
+
+	KeyframeEntry* entries = MediaMalloc(&ctx->streams[STREAM_VIDEO].memory, sizeof(KeyframeEntry) * entryCount);
+
+	if (!entries)
+	{
+		return false;
+	}
+
+	int count = 0;
+
+	for (int i = 0; i < entryCount; ++i)
+	{
+		const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+
+		if (entry->flags & AVINDEX_KEYFRAME)
+		{
+			entries[count++] = (KeyframeEntry){ entry->timestamp, entry->pos };
+		}
+	}
+
+	if (count == 0)
+	{
+		MediaFree(entries);
+		return false;
+	}
+
+	*index = (KeyframeIndex){ .entries = entries, .count = count, .data = entries, .dataSize = sizeof(KeyframeEntry) * entryCount };
+
+	return true;
+}
+
+static int CompareKeyframes(const void* a, const void* b)
+{
+	const int64_t ptsA = ((const KeyframeEntry*)a)->pts;
+	const int64_t ptsB = ((const KeyframeEntry*)b)->pts;
+
+	return (ptsA > ptsB) - (ptsA < ptsB);
+}
+
+bool ScanKeyframes(MediaContext* ctx, KeyframeIndex* index)
+{
+	MemoryUsage* memory = &ctx->streams[STREAM_VIDEO].memory;
+	const int streamIdx = ctx->streams[STREAM_VIDEO].streamIdx;
+
+	AVFormatContext* fmtCtx = avformat_alloc_context();
+
+	if (!fmtCtx)
+	{
+		return false;
+	}
+
+	fmtCtx->interrupt_callback = (AVIOInterruptCB){ AVInterruptIndexScan, ctx };
+
+	if (avformat_open_input(&fmtCtx, ctx->indexFileName, NULL, NULL) < 0)
+	{
+		return false; // fmtCtx is freed on failure
+	}
+
+	// Only the video packets are needed: don't even return the others
+	for (int i = 0; i < (int)fmtCtx->nb_streams; ++i)
+	{
+		if (i != streamIdx)
+		{
+			fmtCtx->streams[i]->discard = AVDISCARD_ALL;
+		}
+	}
+
+	AVPacket* packet = av_packet_alloc();
+
+	KeyframeEntry* entries = NULL;
+	int capacity = 0;
+	int count = 0;
+
+	bool ret = packet && streamIdx < (int)fmtCtx->nb_streams;
+
+	while (ret && !atomic_load(&ctx->abortIndex))
+	{
+		const int err = av_read_frame(fmtCtx, packet);
+
+		if (err == AVERROR_EOF)
+		{
+			break;
+		}
+
+		if (err < 0)
+		{
+			AVPrintError(err);
+			ret = false;
+			break;
+		}
+
+		const int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+
+		if (packet->stream_index == streamIdx && (packet->flags & AV_PKT_FLAG_KEY) && pts != AV_NOPTS_VALUE)
+		{
+			if (count == capacity)
+			{
+				capacity = capacity ? capacity * 2 : 256;
+
+				KeyframeEntry* grown = MediaMalloc(memory, sizeof(KeyframeEntry) * capacity);
+
+				if (grown && count > 0)
+				{
+					memcpy(grown, entries, sizeof(KeyframeEntry) * count);
+				}
+
+				MediaFree(entries);
+				entries = grown;
+				ret = grown != NULL;
+			}
+
+			if (ret)
+			{
+				entries[count++] = (KeyframeEntry){ pts, packet->pos };
+			}
+		}
+
+		av_packet_unref(packet);
+	}
+
+	ret = ret && !atomic_load(&ctx->abortIndex) && count > 0;
+
+	av_packet_free(&packet);
+	avformat_close_input(&fmtCtx);
+
+	if (!ret)
+	{
+		MediaFree(entries);
+		return false;
+	}
+
+	// Packets come in decoding order
+	qsort(entries, count, sizeof(KeyframeEntry), CompareKeyframes);
+
+	*index = (KeyframeIndex){ .entries = entries, .count = count, .data = entries,
+		.dataSize = sizeof(KeyframeEntry) * capacity, .byteSeek = true };
+
+	return true;
+}
+
+void* RunKeyframeScan(void* arg)
+{
+	MediaContext* ctx = (MediaContext*)arg;
+
+	WORKER_THREAD = true;
+
+	const bool scanned = ScanKeyframes(ctx, &ctx->keyframeIndex);
+
+	if (scanned)
+	{
+		TraceLog(LOG_DEBUG, "MEDIA: Keyframe index of '%s' built (%i keyframes).", ctx->indexFileName, ctx->keyframeIndex.count);
+
+		if (ctx->indexCacheFileName)
+		{
+			SaveKeyframeIndexCache(&ctx->keyframeIndex, ctx->indexCacheFileName, ctx->indexHeader);
+		}
+	}
+
+	atomic_store(&ctx->indexStatus, scanned ? INDEX_STATUS_READY : INDEX_STATUS_FAILED);
+
+	return NULL;
+}
+
+int AVInterruptIndexScan(void* ctx)
+{
+	return atomic_load(&((MediaContext*)ctx)->abortIndex) ? 1 : 0;
+}
+
+bool LoadKeyframeIndexCache(KeyframeIndex* index, const char* cacheFileName, const KeyframeIndexHeader* expected, MemoryUsage* memory)
+{
+	KeyframeIndex cache = { .byteSeek = true };
+
+#if defined(_WIN32)
+	// No mmap here: read the whole file instead
+	FILE* file = fopen(cacheFileName, "rb");
+
+	if (!file)
+	{
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	const long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (length > 0)
+	{
+		cache.data = MediaMalloc(memory, length);
+		cache.dataSize = length;
+
+		if (cache.data && fread(cache.data, 1, length, file) != (size_t)length)
+		{
+			cache.dataSize = 0;
+		}
+	}
+
+	fclose(file);
+#else
+	const int fd = open(cacheFileName, O_RDONLY);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mapping != MAP_FAILED)
+		{
+			cache.data = mapping;
+			cache.dataSize = (size_t)info.st_size;
+			cache.mapped = true;
+		}
+	}
+
+	close(fd); // The mapping stays valid
+#endif
+
+	const KeyframeIndexHeader* header = cache.data;
+
+	const bool valid = header && cache.dataSize >= sizeof(KeyframeIndexHeader) &&
+		memcmp(header->magic, expected->magic, sizeof(header->magic)) == 0 &&
+		header->fileSize == expected->fileSize &&
+		header->fileTime == expected->fileTime &&
+		header->streamIdx == expected->streamIdx &&
+		header->timeBaseNum == expected->timeBaseNum &&
+		header->timeBaseDen == expected->timeBaseDen &&
+		header->count > 0 &&
+		cache.dataSize == sizeof(KeyframeIndexHeader) + sizeof(KeyframeEntry) * (size_t)header->count;
+
+	if (!valid)
+	{
+		if (header)
+		{
+			TraceLog(LOG_DEBUG, "MEDIA: Ignoring the outdated keyframe index '%s'.", cacheFileName);
+		}
+
+		FreeKeyframeIndexData(&cache);
+		return false;
+	}
+
+	cache.entries = (const KeyframeEntry*)(header + 1);
+	cache.count = header->count;
+
+	*index = cache;
+
+	return true;
+}
+
+bool SaveKeyframeIndexCache(const KeyframeIndex* index, const char* cacheFileName, KeyframeIndexHeader header)
+{
+	header.count = index->count;
+
+	FILE* file = fopen(cacheFileName, "wb");
+
+	if (!file)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Can't write the keyframe index '%s'.", cacheFileName);
+		return false;
+	}
+
+	bool ret = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(index->entries, sizeof(KeyframeEntry), index->count, file) == (size_t)index->count;
+
+	ret = fclose(file) == 0 && ret;
+
+	// A partial file would fail the size check anyway, but don't leave it around
+	if (!ret)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Failed writing the keyframe index '%s'.", cacheFileName);
+		remove(cacheFileName);
+	}
+
+	return ret;
+}
+
+void FreeKeyframeIndexData(KeyframeIndex* index)
+{
+	if (index->data)
+	{
+#if !defined(_WIN32)
+		if (index->mapped)
+		{
+			munmap(index->data, index->dataSize);
+		}
+		else
+#endif
+		{
+			MediaFree(index->data);
+		}
+	}
+
+	*index = (KeyframeIndex){ 0 };
+}
+
+const KeyframeIndex* GetKeyframeIndex(const MediaContext* ctx)
+{
+	return atomic_load(&((MediaContext*)ctx)->indexStatus) == INDEX_STATUS_READY ? &ctx->keyframeIndex : NULL;
+}
+
+const KeyframeEntry* FindKeyframe(const KeyframeIndex* index, int64_t pts)
+{
+	const KeyframeEntry* found = NULL;
+
+	int low = 0;
+	int high = index->count - 1;
+
+	while (low <= high)
+	{
+		const int mid = low + (high - low) / 2;
+
+		if (index->entries[mid].pts <= pts)
+		{
+			found = &index->entries[mid];
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	return found;
+}
+
+int64_t AVGetVideoStreamPts(const MediaContext* ctx, int64_t timestamp)
+{
+	const StreamDataContext* streamCtx = &ctx->streams[STREAM_VIDEO];
+	const AVStream* stream = ctx->formatContext->streams[streamCtx->streamIdx];
+
+	int64_t startPts = streamCtx->startPts;
+
+	if (startPts == AV_NOPTS_VALUE)
+	{
+		startPts = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+	}
+
+	return startPts + av_rescale_q(timestamp, AV_TIME_BASE_Q, stream->time_base);
+}
+
+bool AVSeekIndexedKeyframe(MediaContext* ctx, int64_t targetTimestamp)
+{
+	const KeyframeIndex* index = HasStream(ctx, STREAM_VIDEO) ? GetKeyframeIndex(ctx) : NULL;
+
+	if (!index)
+	{
+		return false;
+	}
+
+	const KeyframeEntry* keyframe = FindKeyframe(index, AVGetVideoStreamPts(ctx, targetTimestamp));
+
+	if (!keyframe)
+	{
+		return false;
+	}
+
+	const int streamIdx = ctx->streams[STREAM_VIDEO].streamIdx;
+	int ret = -1;
+
+	if (index->byteSeek && keyframe->pos >= 0 && !(ctx->formatContext->iformat->flags & AVFMT_NO_BYTE_SEEK))
+	{
+		ret = avformat_seek_file(ctx->formatContext, streamIdx, keyframe->pos, keyframe->pos, keyframe->pos, AVSEEK_FLAG_BYTE);
+	}
+
+	if (ret < 0)
+	{
+		ret = avformat_seek_file(ctx->formatContext, streamIdx, INT64_MIN, keyframe->pts, keyframe->pts, 0);
+	}
+
+	if (ret < 0)
+	{
+		AVPrintError(ret);
+		return false;
+	}
+
+	atomic_fetch_add(&ctx->indexedSeeks, 1);
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Decoded GOP cache
+//---------------------------------------------------------------------------------------------------
+
+// Bytes of frame data referenced by a decoded frame
+static inline long long GetFrameMemory(const AVFrame* frame)
+{
+	long long size = 0;
+
+	for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; ++i)
+	{
+		size += (long long)frame->buf[i]->size;
+	}
+
+	return size;
+}
+
+void CacheVideoFrame(MediaContext* ctx, const AVFrame* frame)
+{
+	GopCache* cache = &ctx->gopCache;
+
+	if (cache->budget <= 0)
+	{
+		return;
+	}
+
+	const double time = AVGetVideoFrameTime(ctx, frame);
+
+	if (frame->flags & AV_FRAME_FLAG_KEY)
+	{
+		// The GOP being filled is complete up to this keyframe
+		if (cache->current >= 0)
+		{
+			cache->gops[cache->current].endTime = MAX(cache->gops[cache->current].endTime, time);
+		}
+
+		cache->current = -1;
+
+		for (int i = 0; i < cache->count; ++i)
+		{
+			if (cache->gops[i].count > 0 && cache->gops[i].frames[0].time == time)
+			{
+				cache->current = i;
+				break;
+			}
+		}
+
+		if (cache->current < 0)
+		{
+			if (cache->count == MEDIA_GOP_CACHE_MAX_GOPS)
+			{
+				int oldest = 0;
+
+				for (int i = 1; i < cache->count; ++i)
+				{
+					if (cache->gops[i].lastUse < cache->gops[oldest].lastUse)
+					{
+						oldest = i;
+					}
+				}
+
+				EvictCachedGop(cache, oldest);
+			}
+
+			cache->current = cache->count++;
+			cache->gops[cache->current] = (CachedGop){ .endTime = time };
+		}
+	}
+
+	if (cache->current < 0)
+	{
+		return;
+	}
+
+	CachedGop* gop = &cache->gops[cache->current];
+
+	gop->lastUse = ++cache->clock;
+
+	// Already cached (GOP decoded again), or before the keyframe (leading frames of an open GOP)
+	if (gop->count > 0 && time <= gop->frames[gop->count - 1].time)
+	{
+		return;
+	}
+
+	if (gop->count == gop->capacity)
+	{
+		const int capacity = MAX(gop->capacity * 2, 16);
+		CachedFrame* frames = MediaMalloc(&ctx->streams[STREAM_VIDEO].memory, capacity * sizeof(CachedFrame));
+
+		if (!frames)
+		{
+			BreakGopCache(cache);
+			return;
+		}
+
+		if (gop->frames)
+		{
+			memcpy(frames, gop->frames, gop->count * sizeof(CachedFrame));
+			MediaFree(gop->frames);
+		}
+
+		gop->frames = frames;
+		gop->capacity = capacity;
+	}
+
+	AVFrame* cached = av_frame_alloc();
+
+	if (!cached || av_frame_ref(cached, frame) < 0)
+	{
+		av_frame_free(&cached);
+		BreakGopCache(cache);
+		return;
+	}
+
+	const long long memory = GetFrameMemory(cached);
+
+	gop->frames[gop->count++] = (CachedFrame){ .frame = cached, .time = time };
+	gop->endTime = MAX(gop->endTime, time);
+	gop->memory += memory;
+
+	atomic_fetch_add(&cache->memory, memory);
+	atomic_fetch_add(&cache->frames, 1);
+
+	// Evict the least recently used GOPs; a GOP larger than the whole budget is given up
+	while (atomic_load(&cache->memory) > cache->budget && cache->count > 0)
+	{
+		int oldest = -1;
+
+		for (int i = 0; i < cache->count; ++i)
+		{
+			if (i != cache->current && (oldest < 0 || cache->gops[i].lastUse < cache->gops[oldest].lastUse))
+			{
+				oldest = i;
+			}
+		}
+
+		if (oldest < 0)
+		{
+			oldest = cache->current;
+			BreakGopCache(cache);
+		}
+
+		EvictCachedGop(cache, oldest);
+	}
+}
+
+void BreakGopCache(GopCache* cache)
+{
+	cache->current = -1;
+}
+
+const CachedFrame* FindCachedFrame(GopCache* cache, double time, bool accurate)
+{
+	for (int i = 0; i < cache->count; ++i)
+	{
+		CachedGop* gop = &cache->gops[i];
+
+		if (gop->count == 0 || time < gop->frames[0].time || time >= gop->endTime)
+		{
+			continue;
+		}
+
+		int found = 0;
+
+		// Last frame at or before time (binary search, frames are sorted)
+		if (accurate)
+		{
+			int low = 0;
+			int high = gop->count - 1;
+
+			while (low <= high)
+			{
+				const int mid = (low + high) / 2;
+
+				if (gop->frames[mid].time <= time)
+				{
+					found = mid;
+					low = mid + 1;
+				}
+				else
+				{
+					high = mid - 1;
+				}
+			}
+		}
+
+		gop->lastUse = ++cache->clock;
+
+		return &gop->frames[found];
+	}
+
+	return NULL;
+}
+
+const CachedFrame* FindNextCachedFrame(GopCache* cache, double time)
+{
+	const CachedFrame* frame = FindCachedFrame(cache, time, true);
+
+	if (!frame)
+	{
+		return NULL;
+	}
+
+	for (int i = 0; i < cache->count; ++i)
+	{
+		const CachedGop* gop = &cache->gops[i];
+
+		if (frame >= gop->frames && frame < gop->frames + gop->count)
+		{
+			return (frame + 1 < gop->frames + gop->count) ? frame + 1 : NULL;
+		}
+	}
+
+	return NULL;
+}
+
+void EvictCachedGop(GopCache* cache, int index)
+{
+	CachedGop* gop = &cache->gops[index];
+
+	for (int i = 0; i < gop->count; ++i)
+	{
+		av_frame_free(&gop->frames[i].frame);
+	}
+
+	atomic_fetch_sub(&cache->memory, gop->memory);
+	atomic_fetch_sub(&cache->frames, gop->count);
+
+	MediaFree(gop->frames);
+
+	// Keep the array packed: the last GOP takes the freed slot
+	cache->count--;
+
+	if (index != cache->count)
+	{
+		cache->gops[index] = cache->gops[cache->count];
+
+		if (cache->current == cache->count)
+		{
+			cache->current = index;
+		}
+	}
+
+	cache->gops[cache->count] = (CachedGop){ 0 };
+}
+
+void UnloadGopCache(GopCache* cache)
+{
+	while (cache->count > 0)
+	{
+		EvictCachedGop(cache, cache->count - 1);
+	}
+
+	BreakGopCache(cache);
+}
+
+bool AVSeekCachedFrame(MediaContext* ctx, int64_t targetTimestamp, bool accurate)
+{
+	GopCache* cache = &ctx->gopCache;
+
+	// Resuming playback from a cached frame would require the decoder state: only paused or stopped media are served
+	if (cache->budget <= 0 || !HasStream(ctx, STREAM_VIDEO) || ctx->state == MEDIA_STATE_PLAYING)
+	{
+		return false;
+	}
+
+	const double targetTime = (double)targetTimestamp / AV_TIME_BASE;
+	const CachedFrame* cached = FindCachedFrame(cache, targetTime, accurate);
+
+	AVDropVideoFrame(ctx);
+	AVDropNextVideoFrame(ctx);
+
+	if (!cached || av_frame_ref(ctx->pendingVideoFrame, cached->frame) < 0)
+	{
+		atomic_fetch_add(&cache->misses, 1);
+		return false;
+	}
+
+	atomic_fetch_add(&cache->hits, 1);
+
+	ctx->hasPendingVideoFrame = true;
+	ctx->timePos = accurate ? targetTime : cached->time;
+	ctx->lastSeekDecodedFrames = 0;
+
+	// The decoder resumes from this exact position
+	ctx->deferredSeek = true;
+	ctx->deferredSeekTarget = (int64_t)(ctx->timePos * AV_TIME_BASE);
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Reverse playback
+//---------------------------------------------------------------------------------------------------
+
+bool UpdateReversePlayback(MediaStream* media, double deltaTime)
+{
+	MediaContext* ctx = media->ctx;
+
+	if (!ctx->reversePlay && !StartReversePlayback(media))
+	{
+		return false;
+	}
+
+	// The first frame stays displayed once the start is reached
+	ctx->timePos = MAX(0.0, ctx->timePos + deltaTime);
+
+	ReverseSegment* front = &ctx->reverseSegments[ctx->reverseFront];
+
+	while (true)
+	{
+		// Frames after the media time are over, the last one left is due
+		while (front->count > 0 && front->frames[front->count - 1].time > ctx->timePos)
+		{
+			front->count--;
+
+			av_frame_unref(front->frames[front->count].frame);
+
+			if (front->frames[front->count].time != ctx->reverseShownTime)
+			{
+				atomic_fetch_add(&ctx->droppedVideoFrames, 1);
+			}
+		}
+
+		if (front->count > 0)
+		{
+			break;
+		}
+
+		// The earlier segment is still being decoded: keep showing the current frame
+		if (atomic_load(&ctx->reverseJobPending))
+		{
+			ctx->reverseStalls++;
+			return true;
+		}
+
+		ReverseSegment* back = &ctx->reverseSegments[!ctx->reverseFront];
+
+		// Nothing before the back segment: the start of the video is reached
+		if (back->count == 0)
+		{
+			return true;
+		}
+
+		ctx->reverseFront = !ctx->reverseFront;
+		front = back;
+
+		// Decode the segment before this one while it's presented
+		SubmitReverseJob(ctx, front->frames[0].time);
+	}
+
+	const CachedFrame* due = &front->frames[front->count - 1];
+
+	if (due->time != ctx->reverseShownTime)
+	{
+		AVDropVideoFrame(ctx);
+
+		if (av_frame_ref(ctx->pendingVideoFrame, due->frame) >= 0)
+		{
+			ctx->hasPendingVideoFrame = true;
+			ctx->reverseShownTime = due->time;
+
+			AVFlushVideoFrame(media);
+		}
+	}
+
+	return true;
+}
+
+bool StartReversePlayback(MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	if (!HasStream(ctx, STREAM_VIDEO))
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Reverse playback requires a video stream.");
+		return false;
+	}
+
+	MemoryUsage* memory = &ctx->streams[STREAM_VIDEO].memory;
+
+	if (!LoadReverseSegment(&ctx->reverseSegments[0], MEDIA.reverseFrames, memory) ||
+		!LoadReverseSegment(&ctx->reverseSegments[1], MEDIA.reverseFrames, memory))
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to allocate the reverse playback segments.");
+		UnloadReverseSegment(&ctx->reverseSegments[0]);
+		UnloadReverseSegment(&ctx->reverseSegments[1]);
+		return false;
+	}
+
+	// The segments are decoded with the demuxer and the video decoder of the media, as a seek does.
+	// Audio is not played backwards.
+	ctx->seekResumeWorkers = StopMediaWorkers(ctx) || ctx->seekResumeWorkers;
+
+	if (IsAudioStreamValid(media->audioStream))
+	{
+		StopAudioStream(media->audioStream);
+	}
+
+	AVDropVideoFrame(ctx);
+	AVDropNextVideoFrame(ctx);
+	AVSetVideoCatchUp(ctx, false);
+
+	ctx->reverseHoldsPool = AcquireWorkerPool();
+	ctx->reversePlay = true;
+	ctx->reverseFront = 0;
+	ctx->reverseShownTime = -1.0;
+
+	// The back segment is presented first, with the frame currently displayed
+	SubmitReverseJob(ctx, ctx->timePos + MEDIA_REVERSE_START_MARGIN);
+
+	return true;
+}
+
+void StopReversePlayback(MediaContext* ctx)
+{
+	if (!ctx->reversePlay)
+	{
+		return;
+	}
+
+	// A long GOP may take the job hundreds of frames to decode: don't wait for the rest of them
+	atomic_store(&ctx->abortReverse, true);
+
+	WaitJobStatus(&ctx->reverseJobPending, true);
+
+	atomic_store(&ctx->abortReverse, false);
+
+	UnloadReverseSegment(&ctx->reverseSegments[0]);
+	UnloadReverseSegment(&ctx->reverseSegments[1]);
+
+	if (ctx->reverseHoldsPool)
+	{
+		ReleaseWorkerPool();
+		ctx->reverseHoldsPool = false;
+	}
+
+	ctx->reversePlay = false;
+}
+
+void SubmitReverseJob(MediaContext* ctx, double endTime)
+{
+	ReverseSegment* back = &ctx->reverseSegments[!ctx->reverseFront];
+
+	ClearReverseSegment(back);
+	back->endTime = endTime;
+
+	atomic_store(&ctx->reverseJobPending, true);
+
+	if (!ctx->reverseHoldsPool || !SubmitPoolJob((PoolJob){ RunReverseJob, ctx }))
+	{
+		RunReverseJob(ctx);
+	}
+}
+
+void RunReverseJob(void* arg)
+{
+	MediaContext* ctx = (MediaContext*)arg;
+
+	AVDecodeReverseSegment(ctx, &ctx->reverseSegments[!ctx->reverseFront]);
+
+	// Must be the last access: the main thread may swap the segments or unload the media right after
+	SetJobStatus(&ctx->reverseJobPending, false);
+}
+
+void AVDecodeReverseSegment(MediaContext* ctx, ReverseSegment* segment)
+{
+	StreamDataContext* videoCtx = &ctx->streams[STREAM_VIDEO];
+
+	// Keyframe strictly before the end of the segment
+	const int64_t targetTimestamp = (int64_t)(segment->endTime * AV_TIME_BASE) - 1;
+
+	int ret = AVSeekIndexedKeyframe(ctx, targetTimestamp) ? 0 :
+		avformat_seek_file(ctx->formatContext, -1, INT64_MIN, targetTimestamp, INT64_MAX, AVSEEK_FLAG_BACKWARD);
+
+	if (ret < 0)
+	{
+		AVPrintError(ret);
+		return;
+	}
+
+	for (int i = 0; i < STREAM_COUNT; ++i)
+	{
+		if (ctx->streams[i].codecCtx)
+		{
+			avcodec_flush_buffers(ctx->streams[i].codecCtx);
+
+			ClearQueue(&ctx->streams[i].pendingPackets);
+		}
+	}
+
+	BreakGopCache(&ctx->gopCache);
+
+	double keyframeTime = 0.0;
+
+	if (AVSeekVideoKeyframe(ctx, &keyframeTime) != MEDIA_RET_SUCCEED)
+	{
+		return;
+	}
+
+	bool done = false;
+
+	while (!done && !atomic_load(&ctx->abortReverse))
+	{
+		AVPacket* packet = NULL;
+
+		// At the end of the stream, drain the frames still held by the decoder
+		const bool draining = AVPeekPacket(ctx, STREAM_VIDEO, &packet) != MEDIA_RET_SUCCEED;
+
+		ret = avcodec_send_packet(videoCtx->codecCtx, draining ? NULL : packet);
+
+		if (!draining)
+		{
+			SkipPacket(&videoCtx->pendingPackets);
+		}
+
+		if (ret < 0 && !draining)
+		{
+			AVPrintError(ret); // Skip corrupted packets
+			continue;
+		}
+
+		while (!done && avcodec_receive_frame(videoCtx->codecCtx, ctx->avFrame) >= 0)
+		{
+			atomic_fetch_add(&ctx->reverseDecodedFrames, 1);
+
+			const double time = AVGetVideoFrameTime(ctx, ctx->avFrame);
+
+			// Frames come out in presentation order: the first one at the end time completes the segment
+			done = time >= segment->endTime;
+
+			// Leading frames of an open GOP, which reference the previous one, can't be decoded properly
+			if (!done && time >= keyframeTime)
+			{
+				if (segment->count == segment->capacity)
+				{
+					// Only the frames closest to endTime are kept, the next segment decodes the earlier ones again
+					CachedFrame oldest = segment->frames[0];
+
+					av_frame_unref(oldest.frame);
+					memmove(segment->frames, segment->frames + 1, (segment->count - 1) * sizeof(CachedFrame));
+					segment->frames[--segment->count] = oldest;
+				}
+
+				av_frame_move_ref(segment->frames[segment->count].frame, ctx->avFrame);
+				segment->frames[segment->count].time = time;
+				segment->count++;
+			}
+
+			av_frame_unref(ctx->avFrame);
+		}
+
+		done = done || draining;
+
+		// Reading video packets queues the audio ones, which are not played
+		if (HasStream(ctx, STREAM_AUDIO))
+		{
+			ClearQueue(&ctx->streams[STREAM_AUDIO].pendingPackets);
+		}
+	}
+
+	if (done)
+	{
+		atomic_fetch_add(&ctx->reverseSegmentCount, 1);
+	}
+}
+
+bool LoadReverseSegment(ReverseSegment* segment, int capacity, MemoryUsage* memory)
+{
+	*segment = (ReverseSegment){ .capacity = capacity };
+
+	segment->frames = MediaCalloc(memory, capacity, sizeof(CachedFrame));
+
+	if (!segment->frames)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < capacity; ++i)
+	{
+		segment->frames[i].frame = av_frame_alloc();
+
+		if (!segment->frames[i].frame)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UnloadReverseSegment(ReverseSegment* segment)
+{
+	if (segment->frames)
+	{
+		for (int i = 0; i < segment->capacity; ++i)
+		{
+			av_frame_free(&segment->frames[i].frame);
+		}
+
+		MediaFree(segment->frames);
+	}
+
+	*segment = (ReverseSegment){ 0 };
+}
+
+void ClearReverseSegment(ReverseSegment* segment)
+{
+	for (int i = 0; i < segment->count; ++i)
+	{
+		av_frame_unref(segment->frames[i].frame);
+	}
+
+	segment->count = 0;
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Asynchronous seek
+//---------------------------------------------------------------------------------------------------
+
+void SubmitMediaSeek(MediaContext* ctx, int64_t targetTimestamp)
+{
+	ctx->seekJobTarget = targetTimestamp;
+	atomic_store(&ctx->abortSeek, false);
+	atomic_store(&ctx->seekStatus, SEEK_STATUS_PENDING);
+
+	if (!SubmitPoolJob((PoolJob){ RunSeekJob, ctx }))
+	{
+		RunSeekJob(ctx);
+	}
+}
+
+void RunSeekJob(void* arg)
+{
+	MediaContext* ctx = (MediaContext*)arg;
+
+	ctx->seekResult = AVSeekCore(ctx, ctx->seekJobTarget, ctx->accurateSeek);
+
+	// Must be the last access: the main thread may end the seek or unload the media right after
+	SetJobStatus(&ctx->seekStatus, SEEK_STATUS_DONE);
+}
+
+bool PollMediaSeek(MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	switch (atomic_load(&ctx->seekStatus))
+	{
+	case SEEK_STATUS_IDLE:
+
+		return true;
+
+	case SEEK_STATUS_PENDING:
+
+		return false;
+
+	default:
+
+		break;
+	}
+
+	// Only the latest request is left: seek there before presenting anything
+	if (ctx->seekQueued)
+	{
+		ctx->seekQueued = false;
+
+		SubmitMediaSeek(ctx, ctx->seekTarget);
+
+		return false;
+	}
+
+	atomic_store(&ctx->seekStatus, SEEK_STATUS_IDLE);
+
+	AVSeekEnd(media, ctx->seekResult);
+
+	return true;
+}
+
+void WaitMediaSeek(MediaContext* ctx)
+{
+	WaitJobStatus(&ctx->seekStatus, SEEK_STATUS_PENDING);
+}
+
+void CancelMediaSeek(MediaContext* ctx)
+{
+	// The result is dropped: don't wait for an accurate seek to decode up to its target
+	atomic_store(&ctx->abortSeek, true);
+
+	WaitMediaSeek(ctx);
+
+	atomic_store(&ctx->abortSeek, false);
+	atomic_store(&ctx->seekStatus, SEEK_STATUS_IDLE);
+	ctx->seekQueued = false;
+}
+
+void InterruptMediaSeek(MediaContext* ctx)
+{
+	if (atomic_load(&ctx->seekStatus) != SEEK_STATUS_PENDING)
+	{
+		return;
+	}
+
+	atomic_store(&ctx->abortSeek, true);
+
+	WaitMediaSeek(ctx);
+
+	// The job may have stopped anywhere before its target: a later request replaces it, or it runs again
+	if (!ctx->seekQueued)
+	{
+		ctx->seekTarget = ctx->seekJobTarget;
+		ctx->seekQueued = true;
+	}
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Audio time-stretching
+//---------------------------------------------------------------------------------------------------
+
+bool LoadTimeStretch(TimeStretch* ts, int channels, int sampleRate, int bytesPerFrame, MemoryUsage* memory)
+{
+	*ts = (TimeStretch){ .channels = channels, .rate = 1.0 };
+
+	ts->hopFrames = MAX(1, sampleRate * MEDIA_STRETCH_WINDOW_MS / 2000);
+	ts->windowFrames = 2 * ts->hopFrames;
+	ts->searchFrames = sampleRate * MEDIA_STRETCH_SEARCH_MS / 1000;
+	ts->scratchFrames = MEDIA_STRETCH_CHUNK;
+
+	// Room for the furthest segment a hop at the highest rate can search, plus one converted chunk
+	ts->inputCapacity = 2 * ts->windowFrames + 2 * ts->searchFrames + ts->scratchFrames;
+
+	ts->input = MediaMalloc(memory, (size_t)ts->inputCapacity * channels * sizeof(float));
+	ts->window = MediaMalloc(memory, (size_t)ts->windowFrames * sizeof(float));
+	ts->overlap = MediaCalloc(memory, (size_t)ts->hopFrames * channels, sizeof(float));
+	ts->output = MediaMalloc(memory, (size_t)ts->hopFrames * channels * sizeof(float));
+	ts->scratch = MediaMalloc(memory, (size_t)ts->scratchFrames * bytesPerFrame);
+
+	if (!ts->input || !ts->window || !ts->overlap || !ts->output || !ts->scratch)
+	{
+		UnloadTimeStretch(ts);
+
+		return false;
+	}
+
+	// Periodic Hann window: two windows half a window apart sum to 1
+	for (int i = 0; i < ts->windowFrames; ++i)
+	{
+		ts->window[i] = 0.5f - 0.5f * cosf(2.0f * PI * i / ts->windowFrames);
+	}
+
+	ts->dotProduct = GetDotProductKernel();
+
+	ResetTimeStretch(ts);
+
+	return true;
+}
+
+void UnloadTimeStretch(TimeStretch* ts)
+{
+	MediaFree(ts->input);
+	MediaFree(ts->window);
+	MediaFree(ts->overlap);
+	MediaFree(ts->output);
+	MediaFree(ts->scratch);
+
+	*ts = (TimeStretch){ 0 };
+}
+
+void ResetTimeStretch(TimeStretch* ts)
+{
+	if (!IsTimeStretchReady(ts))
+	{
+		return;
+	}
+
+	ts->inputFrames = 0;
+	ts->readPos = 0.0;
+	ts->naturalPos = -1;
+
+	memset(ts->overlap, 0, (size_t)ts->hopFrames * ts->channels * sizeof(float));
+}
+
+bool IsTimeStretchReady(const TimeStretch* ts)
+{
+	return ts->input != NULL;
+}
+
+bool RunTimeStretch(TimeStretch* ts)
+{
+	const int channels = ts->channels;
+	const int nominal = (int)ts->readPos;
+
+	// The segment may start up to searchFrames after its nominal position
+	if (nominal + ts->searchFrames + ts->windowFrames > ts->inputFrames)
+	{
+		return false;
+	}
+
+	// The first segment after a reset has nothing to match, it fades in
+	const int start = ts->naturalPos < 0 ? nominal : FindStretchSegment(ts, nominal);
+
+	const float* segment = &ts->input[start * channels];
+	const float* tail = &segment[ts->hopFrames * channels];
+
+	for (int i = 0; i < ts->hopFrames; ++i)
+	{
+		const float fadeIn = ts->window[i];
+		const float fadeOut = ts->window[ts->hopFrames + i];
+
+		for (int c = 0; c < channels; ++c)
+		{
+			const int s = i * channels + c;
+
+			ts->output[s] = ts->overlap[s] + segment[s] * fadeIn;
+			ts->overlap[s] = tail[s] * fadeOut;
+		}
+	}
+
+	ts->naturalPos = start + ts->hopFrames;
+
+	ts->readPos += ts->hopFrames * ts->rate;
+
+	// Drop the frames neither the next search nor the next match can reach
+	const int discard = MIN(ts->naturalPos, (int)ts->readPos - ts->searchFrames);
+
+	if (discard > 0)
+	{
+		memmove(ts->input, &ts->input[discard * channels], (size_t)(ts->inputFrames - discard) * channels * sizeof(float));
+
+		ts->inputFrames -= discard;
+		ts->readPos -= discard;
+		ts->naturalPos -= discard;
+	}
+
+	return true;
+}
+
+int FindStretchSegment(const TimeStretch* ts, int nominal)
+{
+	const int channels = ts->channels;
+	const int first = MAX(0, nominal - ts->searchFrames);
+	const int last = nominal + ts->searchFrames;
+
+	// The overlapping halves are compared, all channels at once
+	const float* target = &ts->input[ts->naturalPos * channels];
+	const int count = ts->hopFrames * channels;
+
+	int best = first;
+	float bestScore = ts->dotProduct(&ts->input[first * channels], target, count);
+
+	for (int pos = first + MEDIA_STRETCH_SEARCH_STEP; pos <= last; pos += MEDIA_STRETCH_SEARCH_STEP)
+	{
+		const float score = ts->dotProduct(&ts->input[pos * channels], target, count);
+
+		if (score > bestScore)
+		{
+			best = pos;
+			bestScore = score;
+		}
+	}
+
+	const int coarseBest = best;
+	const int refineFirst = MAX(first, coarseBest - MEDIA_STRETCH_SEARCH_STEP + 1);
+	const int refineLast = MIN(last, coarseBest + MEDIA_STRETCH_SEARCH_STEP - 1);
+
+	for (int pos = refineFirst; pos <= refineLast; ++pos)
+	{
+		if (pos == coarseBest)
+		{
+			continue;
+		}
+
+		const float score = ts->dotProduct(&ts->input[pos * channels], target, count);
+
+		if (score > bestScore)
+		{
+			best = pos;
+			bestScore = score;
+		}
+	}
+
+	return best;
+}
+
+int AVStretchAudioFrame(MediaContext* ctx)
+{
+	TimeStretch* ts = &ctx->timeStretch;
+
+	int ret = MEDIA_RET_SUCCEED;
+
+	// As in AVProcessAudioFrame, later swr_convert calls only flush the samples it still holds
+	const uint8_t* const* inData = (const uint8_t* const*)ctx->avFrame->data;
 	int inSamples = ctx->avFrame->nb_samples;
 
-	// Initialize the number of samples left to convert. The loop will continue until all samples are converted.
-	int leftSamples = inSamples;
+	while (true)
+	{
+		// Stretch what is already buffered first, making room for the new samples
+		AVDrainTimeStretch(ctx);
+
+		const int room = MIN(ts->inputCapacity - ts->inputFrames, ts->scratchFrames);
+
+		if (room <= 0)
+		{
+			TraceLog(LOG_WARNING, "MEDIA: Not enough space for decoding in the audio buffer.");
+			ctx->audioOverflows++;
+			ret = MEDIA_ERR_OVERFLOW;
+			break;
+		}
+
+		const int convertedSamples = swr_convert(ctx->swrContext, &ts->scratch, room, inData, inSamples);
+
+		if (convertedSamples < 0)
+		{
+			AVPrintError(convertedSamples);
+			ret = MEDIA_ERR_DECODE_AUDIO;
+			break;
+		}
+
+		SamplesToFloat(ts->scratch, ctx->audioOutputFmt, &ts->input[ts->inputFrames * ts->channels], convertedSamples * ts->channels);
+
+		ts->inputFrames += convertedSamples;
+
+		inData = NULL;
+		inSamples = 0;
+
+		// swr_convert had less than requested: nothing is left
+		if (convertedSamples < room)
+		{
+			break;
+		}
+	}
+
+	AVDrainTimeStretch(ctx);
+
+	return ret;
+}
+
+void AVDrainTimeStretch(MediaContext* ctx)
+{
+	TimeStretch* ts = &ctx->timeStretch;
+	BufferState* state = &ctx->audioOutputBuffer.state;
+
+	while (GetBufferWritableSpace(state) >= ts->hopFrames * ctx->audioBytesPerFrame && RunTimeStretch(ts))
+	{
+		AVWriteStretchOutput(ctx, ts->output, ts->hopFrames * ts->channels);
+	}
+}
+
+void AVFlushTimeStretch(MediaContext* ctx)
+{
+	TimeStretch* ts = &ctx->timeStretch;
+
+	// Already flushed or reset
+	if (ts->inputFrames == 0 && ts->naturalPos < 0)
+	{
+		return;
+	}
+
+	const int channels = ts->channels;
+
+	int start = 0;
+	int lost = 0;
+
+	// The overlap of the last segment fades out while the exact continuation fades in
+	if (ts->naturalPos >= 0)
+	{
+		start = ts->naturalPos;
+
+		for (int i = 0; i < ts->hopFrames; ++i)
+		{
+			const float fadeIn = start + i < ts->inputFrames ? ts->window[i] : 0.0f;
+			const float* segment = &ts->input[MIN(start + i, ts->inputFrames - 1) * channels];
+
+			for (int c = 0; c < channels; ++c)
+			{
+				ts->output[i * channels + c] = ts->overlap[i * channels + c] + segment[c] * fadeIn;
+			}
+		}
+
+		lost += ts->hopFrames * channels - AVWriteStretchOutput(ctx, ts->output, ts->hopFrames * channels);
+
+		start += ts->hopFrames;
+	}
+
+	// Then the rest of the input as it is
+	if (start < ts->inputFrames)
+	{
+		const int count = (ts->inputFrames - start) * channels;
+
+		lost += count - AVWriteStretchOutput(ctx, &ts->input[start * channels], count);
+	}
+
+	if (lost > 0)
+	{
+		TraceLog(LOG_WARNING, "MEDIA: Not enough space for flushing the audio time-stretcher.");
+		ctx->audioOverflows++;
+	}
+
+	ResetTimeStretch(ts);
+}
+
+int AVWriteStretchOutput(MediaContext* ctx, const float* samples, int count)
+{
+	BufferState* state = &ctx->audioOutputBuffer.state;
+
+	const int channels = ctx->timeStretch.channels;
+	const int bytesPerSample = ctx->audioBytesPerFrame / channels;
+
+	// Whole frames only, so the segments below always make progress
+	count = MIN(count, GetBufferWritableSpace(state) / ctx->audioBytesPerFrame * channels);
+
+	// The samples may wrap around the end of the circular buffer
+	for (int written = 0; written < count; )
+	{
+		const int segmentSamples = MIN(GetBufferWritableSegmentSize(state) / bytesPerSample, count - written);
+
+		FloatToSamples(&samples[written], ctx->audioOutputFmt, &ctx->audioOutputBuffer.data[state->writePos], segmentSamples);
+
+		AdvanceWritePosN(state, segmentSamples * bytesPerSample);
+
+		written += segmentSamples;
+	}
+
+	return count;
+}
+
+double GetAudioDrift(const MediaContext* ctx)
+{
+	if (!HasStream(ctx, STREAM_AUDIO) || !IsBufferReady(&ctx->audioOutputBuffer) || ctx->audioSampleRate <= 0)
+	{
+		return 0.0;
+	}
+
+	const TimeStretch* ts = &ctx->timeStretch;
+
+	// Input frames still in the stretcher, and output frames in the buffer played at the current rate
+	const double stretchFrames = IsTimeStretchReady(ts) ? ts->inputFrames - ts->readPos : 0.0;
+	const double bufferedFrames = (double)GetBufferReadableSpace(&ctx->audioOutputBuffer.state) / ctx->audioBytesPerFrame;
+	const double rate = IsTimeStretchReady(ts) ? ts->rate : 1.0;
+
+	const double audioPos = ctx->audioEndTime - (stretchFrames + bufferedFrames * rate) / ctx->audioSampleRate;
+
+	return audioPos - ctx->timePos;
+}
+
+void SamplesToFloat(const uint8_t* src, int format, float* dst, int count)
+{
+	switch (format)
+	{
+	case AV_SAMPLE_FMT_U8:
+		for (int i = 0; i < count; ++i) dst[i] = (src[i] - 128) * (1.0f / 128.0f);
+		break;
+	case AV_SAMPLE_FMT_S16:
+		for (int i = 0; i < count; ++i) dst[i] = ((const int16_t*)src)[i] * (1.0f / 32768.0f);
+		break;
+	case AV_SAMPLE_FMT_S32:
+		for (int i = 0; i < count; ++i) dst[i] = (float)(((const int32_t*)src)[i] * (1.0 / 2147483648.0));
+		break;
+	case AV_SAMPLE_FMT_FLT:
+		memcpy(dst, src, (size_t)count * sizeof(float));
+		break;
+	case AV_SAMPLE_FMT_DBL:
+		for (int i = 0; i < count; ++i) dst[i] = (float)((const double*)src)[i];
+		break;
+	default:
+		memset(dst, 0, (size_t)count * sizeof(float));
+		break;
+	}
+}
+
+void FloatToSamples(const float* src, int format, uint8_t* dst, int count)
+{
+	switch (format)
+	{
+	case AV_SAMPLE_FMT_U8:
+		for (int i = 0; i < count; ++i) dst[i] = (uint8_t)(128 + CLAMP(lrintf(src[i] * 128.0f), -128, 127));
+		break;
+	case AV_SAMPLE_FMT_S16:
+		for (int i = 0; i < count; ++i) ((int16_t*)dst)[i] = (int16_t)CLAMP(lrintf(src[i] * 32768.0f), -32768, 32767);
+		break;
+	case AV_SAMPLE_FMT_S32:
+		for (int i = 0; i < count; ++i) ((int32_t*)dst)[i] = (int32_t)CLAMP(llrint(src[i] * 2147483648.0), -2147483648LL, 2147483647LL);
+		break;
+	case AV_SAMPLE_FMT_FLT:
+		memcpy(dst, src, (size_t)count * sizeof(float));
+		break;
+	case AV_SAMPLE_FMT_DBL:
+		for (int i = 0; i < count; ++i) ((double*)dst)[i] = src[i];
+		break;
+	default:
+		break;
+	}
+}
+
+DotProductKernel GetDotProductKernel(void)
+{
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+	pthread_once(&once, InitDotProductKernel);
+
+	return DOT_PRODUCT_KERNEL;
+}
+
+void InitDotProductKernel(void)
+{
+	const int cpuFlags = av_get_cpu_flags();
+	const char* name = "scalar";
+
+	DOT_PRODUCT_KERNEL = DotProductScalar;
+
+#if defined(MEDIA_SIMD_X86)
+	if (cpuFlags & AV_CPU_FLAG_AVX2)
+	{
+		DOT_PRODUCT_KERNEL = DotProductAVX2;
+		name = "AVX2";
+	}
+	else if (cpuFlags & AV_CPU_FLAG_SSE2)
+	{
+		DOT_PRODUCT_KERNEL = DotProductSSE2;
+		name = "SSE2";
+	}
+#elif defined(MEDIA_SIMD_NEON)
+	if (cpuFlags & AV_CPU_FLAG_NEON)
+	{
+		DOT_PRODUCT_KERNEL = DotProductNEON;
+		name = "NEON";
+	}
+#else
+	(void)cpuFlags;
+#endif
+
+	TraceLog(LOG_INFO, "MEDIA: Audio time-stretching kernel: %s", name);
+}
+
+float DotProductScalar(const float* a, const float* b, int count)
+{
+	// Independent sums, so the additions don't wait on each other
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		sum[0] += a[i] * b[i];
+		sum[1] += a[i + 1] * b[i + 1];
+		sum[2] += a[i + 2] * b[i + 2];
+		sum[3] += a[i + 3] * b[i + 3];
+	}
+
+	for (; i < count; ++i)
+	{
+		sum[0] += a[i] * b[i];
+	}
+
+	return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+#if defined(MEDIA_SIMD_X86)
+
+MEDIA_TARGET("sse2") float DotProductSSE2(const float* a, const float* b, int count)
+{
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(&a[i + 4]), _mm_loadu_ps(&b[i + 4])));
+	}
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+
+	float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+	for (; i < count; ++i)
+	{
+		sum += a[i] * b[i];
+	}
+
+	return sum;
+}
+
+MEDIA_TARGET("avx2") float DotProductAVX2(const float* a, const float* b, int count)
+{
+	__m256 sum0 = _mm256_setzero_ps();
+	__m256 sum1 = _mm256_setzero_ps();
+
+	int i = 0;
+
+	for (; i + 16 <= count; i += 16)
+	{
+		sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(&a[i]), _mm256_loadu_ps(&b[i])));
+		sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(&a[i + 8]), _mm256_loadu_ps(&b[i + 8])));
+	}
+
+	const __m256 sum8 = _mm256_add_ps(sum0, sum1);
+
+	float lanes[4];
+	_mm_storeu_ps(lanes, _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1)));
+
+	float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+	for (; i < count; ++i)
+	{
+		sum += a[i] * b[i];
+	}
+
+	return sum;
+}
+
+#endif
+
+#if defined(MEDIA_SIMD_NEON)
+
+float DotProductNEON(const float* a, const float* b, int count)
+{
+	float32x4_t sum0 = vdupq_n_f32(0.0f);
+	float32x4_t sum1 = vdupq_n_f32(0.0f);
+
+	int i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		sum0 = vmlaq_f32(sum0, vld1q_f32(&a[i]), vld1q_f32(&b[i]));
+		sum1 = vmlaq_f32(sum1, vld1q_f32(&a[i + 4]), vld1q_f32(&b[i + 4]));
+	}
+
+	const float32x4_t sum4 = vaddq_f32(sum0, sum1);
+
+	float sum = (vgetq_lane_f32(sum4, 0) + vgetq_lane_f32(sum4, 1)) + (vgetq_lane_f32(sum4, 2) + vgetq_lane_f32(sum4, 3));
+
+	for (; i < count; ++i)
+	{
+		sum += a[i] * b[i];
+	}
+
+	return sum;
+}
+
+#endif
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Pulled audio
+//---------------------------------------------------------------------------------------------------
+
+bool AcquireAudioPullSlot(MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	for (int i = 0; i < MEDIA_AUDIO_PULL_SLOTS; ++i)
+	{
+		AudioPullSlot* slot = &AUDIO_PULL_SLOTS[i];
+
+		if (atomic_load(&slot->ctx) != NULL)
+		{
+			continue;
+		}
+
+		slot->bytesPerFrame = ctx->audioBytesPerFrame;
+		slot->silence = ctx->audioOutputFmt == AV_SAMPLE_FMT_U8 ? 0x80 : 0;
+		atomic_store(&slot->locked, false);
+
+		// Published last: the callback may run as soon as it is set
+		atomic_store(&slot->ctx, ctx);
+
+		ctx->pullAudio = true;
+		ctx->audioPullSlot = i;
+
+		SetAudioStreamCallback(media->audioStream, GetAudioPullCallback(i));
+
+		return true;
+	}
+
+	return false;
+}
+
+void ReleaseAudioPullSlot(MediaContext* ctx)
+{
+	if (!ctx->pullAudio)
+	{
+		return;
+	}
+
+	AudioPullSlot* slot = &AUDIO_PULL_SLOTS[ctx->audioPullSlot];
+
+	LockAudioPull(ctx);
+
+	atomic_store(&slot->ctx, NULL);
+
+	UnlockAudioPull(ctx);
+
+	ctx->pullAudio = false;
+}
+
+void LockAudioPull(MediaContext* ctx)
+{
+	if (!ctx->pullAudio)
+	{
+		return;
+	}
+
+	AudioPullSlot* slot = &AUDIO_PULL_SLOTS[ctx->audioPullSlot];
+
+	// Sequentially consistent on both sides: either the callback sees the lock, or this sees it busy and waits
+	atomic_store(&slot->locked, true);
+
+	while (atomic_load(&slot->busy))
+	{
+		sched_yield();
+	}
+}
+
+void UnlockAudioPull(MediaContext* ctx)
+{
+	if (ctx->pullAudio)
+	{
+		atomic_store(&AUDIO_PULL_SLOTS[ctx->audioPullSlot].locked, false);
+	}
+}
+
+void ClearMediaAudio(MediaContext* ctx)
+{
+	if (!IsBufferReady(&ctx->audioOutputBuffer))
+	{
+		return;
+	}
+
+	LockAudioPull(ctx);
+
+	ClearBuffer(&ctx->audioOutputBuffer);
+
+	UnlockAudioPull(ctx);
+}
+
+void PullMediaAudio(int slotIndex, void* buffer, unsigned int frames)
+{
+	AudioPullSlot* slot = &AUDIO_PULL_SLOTS[slotIndex];
+
+	uint8_t* dst = buffer;
+	int size = (int)frames * slot->bytesPerFrame;
+
+	atomic_store(&slot->busy, true);
+
+	MediaContext* ctx = atomic_load(&slot->ctx);
+
+	if (ctx && !atomic_load(&slot->locked))
+	{
+		BufferState* state = &ctx->audioOutputBuffer.state;
+
+		// The decoded audio may wrap around the end of the circular buffer
+		while (size > 0)
+		{
+			const int segmentSize = MIN(GetBufferReadableSegmentSize(state), size);
+
+			if (segmentSize <= 0)
+			{
+				break;
+			}
+
+			memcpy(dst, &ctx->audioOutputBuffer.data[atomic_load_explicit(&state->readPos, memory_order_relaxed)], segmentSize);
+
+			AdvanceReadPosN(state, segmentSize);
+
+			dst += segmentSize;
+			size -= segmentSize;
+		}
+
+		if (size > 0)
+		{
+			atomic_fetch_add(&ctx->audioUnderruns, 1);
+		}
+	}
+
+	atomic_store(&slot->busy, false);
+
+	memset(dst, slot->silence, size);
+}
+
+AudioCallback GetAudioPullCallback(int slotIndex)
+{
+	switch (slotIndex)
+	{
+	case 0: return PullAudioSlot0;
+	case 1: return PullAudioSlot1;
+	case 2: return PullAudioSlot2;
+	case 3: return PullAudioSlot3;
+	case 4: return PullAudioSlot4;
+	case 5: return PullAudioSlot5;
+	case 6: return PullAudioSlot6;
+	case 7: return PullAudioSlot7;
+	default: return NULL;
+	}
+}
+
+void PullAudioSlot0(void* buffer, unsigned int frames) { PullMediaAudio(0, buffer, frames); }
+void PullAudioSlot1(void* buffer, unsigned int frames) { PullMediaAudio(1, buffer, frames); }
+void PullAudioSlot2(void* buffer, unsigned int frames) { PullMediaAudio(2, buffer, frames); }
+void PullAudioSlot3(void* buffer, unsigned int frames) { PullMediaAudio(3, buffer, frames); }
+void PullAudioSlot4(void* buffer, unsigned int frames) { PullMediaAudio(4, buffer, frames); }
+void PullAudioSlot5(void* buffer, unsigned int frames) { PullMediaAudio(5, buffer, frames); }
+void PullAudioSlot6(void* buffer, unsigned int frames) { PullMediaAudio(6, buffer, frames); }
+void PullAudioSlot7(void* buffer, unsigned int frames) { PullMediaAudio(7, buffer, frames); }
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Background workers
+//---------------------------------------------------------------------------------------------------
+
+bool StartWorker(MediaWorker* worker, MediaContext* ctx, int (*step)(MediaContext*))
+{
+	assert(worker);
+
+	if (worker->running)
+	{
+		return true;
+	}
+
+	worker->ctx = ctx;
+	worker->step = step;
+	worker->pooled = ctx->pooledWorkers;
+	atomic_store(&worker->quit, false);
+
+	if (worker->pooled)
+	{
+		atomic_store(&worker->poolState, WORKER_STATE_IDLE);
+
+		worker->running = true;
+
+		WakeWorker(worker);
+
+		return true;
+	}
+
+	UnloadWorker(worker); // In case the worker was stopped without StopMediaWorkers
+
+	worker->wakePending = false;
+
+	if (pthread_mutex_init(&worker->wakeLock, NULL) != 0)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to initialize a worker lock.");
+		return false;
+	}
+
+	if (pthread_cond_init(&worker->wakeUp, NULL) != 0)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to initialize a worker condition variable.");
+		pthread_mutex_destroy(&worker->wakeLock);
+		return false;
+	}
+
+	if (pthread_create(&worker->thread, NULL, RunWorker, worker) != 0)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to create a worker thread.");
+		pthread_cond_destroy(&worker->wakeUp);
+		pthread_mutex_destroy(&worker->wakeLock);
+		return false;
+	}
+
+	worker->wakeReady = true;
+	worker->running = true;
+
+	return true;
+}
+
+void StopWorker(MediaWorker* worker)
+{
+	assert(worker);
+
+	if (!worker->running)
+	{
+		return;
+	}
+
+	atomic_store(&worker->quit, true);
+
+	if (worker->pooled)
+	{
+		// A pooled worker may wake another worker of the same context while running, so wait until no job of the
+		// context is left. Callers stopping several workers must set all their quit flags first (see StopMediaWorkers).
+		pthread_mutex_lock(&POOL.jobsLock);
+
+		while (atomic_load(&worker->ctx->activeJobs) > 0)
+		{
+			pthread_cond_wait(&POOL.jobsDone, &POOL.jobsLock);
+		}
+
+		pthread_mutex_unlock(&POOL.jobsLock);
+	}
+	else
+	{
+		// Signaled under wakeLock so the worker can't miss quit between its check and its wait
+		pthread_mutex_lock(&worker->wakeLock);
+		pthread_cond_signal(&worker->wakeUp);
+		pthread_mutex_unlock(&worker->wakeLock);
+
+		// wakeLock and wakeUp stay valid: the other worker of the context may still be calling WakeWorker
+		pthread_join(worker->thread, NULL);
+	}
+
+	worker->running = false;
+}
+
+void UnloadWorker(MediaWorker* worker)
+{
+	assert(!worker->running);
+
+	if (!worker->wakeReady)
+	{
+		return;
+	}
+
+	pthread_cond_destroy(&worker->wakeUp);
+	pthread_mutex_destroy(&worker->wakeLock);
+
+	worker->wakeReady = false;
+}
+
+void WakeWorker(MediaWorker* worker)
+{
+	if (!worker->running || atomic_load(&worker->quit))
+	{
+		return;
+	}
+
+	if (!worker->pooled)
+	{
+		pthread_mutex_lock(&worker->wakeLock);
+		worker->wakePending = true;
+		pthread_cond_signal(&worker->wakeUp);
+		pthread_mutex_unlock(&worker->wakeLock);
+		return;
+	}
+
+	int state = atomic_load(&worker->poolState);
+
+	while (true)
+	{
+		if (state == WORKER_STATE_IDLE)
+		{
+			if (atomic_compare_exchange_weak(&worker->poolState, &state, WORKER_STATE_QUEUED))
+			{
+				atomic_fetch_add(&worker->ctx->activeJobs, 1);
+
+				if (!SubmitPoolJob((PoolJob){ RunWorkerJob, worker }))
+				{
+					atomic_store(&worker->poolState, WORKER_STATE_IDLE);
+					ReleaseContextJob(worker->ctx);
+				}
+
+				return;
+			}
+		}
+		else if (state == WORKER_STATE_RUNNING)
+		{
+			// Let the running step know it must be scheduled again, it may have missed the reason of this call
+			if (atomic_compare_exchange_weak(&worker->poolState, &state, WORKER_STATE_RERUN))
+			{
+				return;
+			}
+		}
+		else
+		{
+			return; // Already queued or flagged to run again
+		}
+	}
+}
+
+void RunWorkerJob(void* arg)
+{
+	MediaWorker* worker = (MediaWorker*)arg;
+	MediaContext* ctx = worker->ctx;
+
+	atomic_store(&worker->poolState, WORKER_STATE_RUNNING);
+
+	const bool progress = !atomic_load(&worker->quit) && worker->step(ctx) == WORKER_PROGRESS;
+
+	int state = WORKER_STATE_RUNNING;
+
+	// Nothing was done and nobody woke the worker meanwhile: sleep until the next WakeWorker() call
+	if (!progress && atomic_compare_exchange_strong(&worker->poolState, &state, WORKER_STATE_IDLE))
+	{
+		ReleaseContextJob(ctx);
+		return; // The context may be freed as soon as activeJobs is released, don't touch it anymore
+	}
+
+	if (!atomic_load(&worker->quit))
+	{
+		atomic_store(&worker->poolState, WORKER_STATE_QUEUED);
+
+		if (SubmitPoolJob((PoolJob){ RunWorkerJob, worker }))
+		{
+			return;
+		}
+	}
+
+	atomic_store(&worker->poolState, WORKER_STATE_IDLE);
+	ReleaseContextJob(ctx);
+}
+
+void ReleaseContextJob(MediaContext* ctx)
+{
+	// Released under jobsLock: StopWorker can't see the count reach zero, and free the context, before the signal
+	pthread_mutex_lock(&POOL.jobsLock);
+
+	if (atomic_fetch_sub(&ctx->activeJobs, 1) == 1)
+	{
+		pthread_cond_broadcast(&POOL.jobsDone);
+	}
+
+	pthread_mutex_unlock(&POOL.jobsLock);
+}
+
+void* RunWorker(void* arg)
+{
+	MediaWorker* worker = (MediaWorker*)arg;
+
+	WORKER_THREAD = true;
+
+	while (!atomic_load(&worker->quit))
+	{
+		pthread_mutex_lock(&worker->wakeLock);
+		worker->wakePending = false; // Wake-ups received until now are handled by the step below
+		pthread_mutex_unlock(&worker->wakeLock);
+
+		if (worker->step(worker->ctx) == WORKER_PROGRESS)
+		{
+			continue;
+		}
+
+		// Nothing was done and nobody woke the worker meanwhile: sleep until the next WakeWorker() call
+		pthread_mutex_lock(&worker->wakeLock);
+
+		while (!worker->wakePending && !atomic_load(&worker->quit))
+		{
+			pthread_cond_wait(&worker->wakeUp, &worker->wakeLock);
+		}
+
+		pthread_mutex_unlock(&worker->wakeLock);
+	}
+
+	return NULL;
+}
+
+bool StartMediaWorkers(MediaContext* ctx)
+{
+	assert(ctx);
+
+	if (ctx->threadedDemux && ctx->demuxPacket && !ctx->demuxWorker.running)
+	{
+		atomic_store(&ctx->demuxStatus, MEDIA_RET_SUCCEED);
+		ctx->demuxPending = false;
+
+		StartWorker(&ctx->demuxWorker, ctx, AVDemuxStep);
+	}
+
+	// The decode worker consumes the video packets read by the demux worker
+	if (ctx->threadedDecode && ctx->decodeFrame && ctx->demuxWorker.running && !ctx->decodeWorker.running)
+	{
+		atomic_store(&ctx->decodeStatus, MEDIA_RET_SUCCEED);
+		ctx->decodeDraining = false;
+
+		StartWorker(&ctx->decodeWorker, ctx, AVDecodeStep);
+	}
+
+	return ctx->demuxWorker.running || ctx->decodeWorker.running;
+}
+
+bool StopMediaWorkers(MediaContext* ctx)
+{
+	assert(ctx);
+
+	const bool wasRunning = ctx->demuxWorker.running || ctx->decodeWorker.running;
+
+	// Every worker is asked to exit before waiting for any of them, as pooled workers wake each other
+	atomic_store(&ctx->decodeWorker.quit, true);
+	atomic_store(&ctx->demuxWorker.quit, true);
+
+	// Consumer first, then the producer feeding it
+	StopWorker(&ctx->decodeWorker);
+	StopWorker(&ctx->demuxWorker);
+
+	// No worker thread of the context is left to wake the other one
+	UnloadWorker(&ctx->decodeWorker);
+	UnloadWorker(&ctx->demuxWorker);
+
+	// The packet the demux worker could not enqueue yet goes to its queue if there is room now, as synchronous
+	// decoding may go on from here (StepMediaFrame); it's dropped otherwise
+	if (ctx->demuxPending)
+	{
+		PacketQueue* queue = GetStreamPacketQueue(ctx, ctx->demuxPacket->stream_index);
+
+		if (!queue || !EnqueuePacket(queue, ctx->demuxPacket))
+		{
+			av_packet_unref(ctx->demuxPacket);
+		}
+
+		ctx->demuxPending = false;
+	}
+
+	return wasRunning;
+}
+
+void WakeMediaWorkers(MediaContext* ctx)
+{
+	assert(ctx);
+
+	WakeWorker(&ctx->demuxWorker);
+	WakeWorker(&ctx->decodeWorker);
+}
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Shared worker pool
+//---------------------------------------------------------------------------------------------------
+
+bool LoadJobDeque(JobDeque* deque, int capacity)
+{
+	assert(deque);
+	assert(capacity > 0);
+
+	*deque = (JobDeque){ 0 };
+
+	deque->jobs = MediaMalloc(&MEDIA_MEMORY, sizeof(PoolJob) * capacity);
+
+	if (!deque->jobs)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to allocate a job deque with capacity of %i jobs.", capacity);
+		return false;
+	}
+
+	deque->capacity = capacity;
+
+	pthread_mutex_init(&deque->lock, NULL);
+
+	return true;
+}
+
+void UnloadJobDeque(JobDeque* deque)
+{
+	assert(deque);
+
+	if (deque->jobs)
+	{
+		pthread_mutex_destroy(&deque->lock);
+
+		MediaFree(deque->jobs);
+
+		*deque = (JobDeque){ 0 };
+	}
+}
+
+bool PushJobBack(JobDeque* deque, PoolJob job)
+{
+	pthread_mutex_lock(&deque->lock);
+
+	if (deque->count == deque->capacity)
+	{
+		const int newCapacity = deque->capacity * 2;
+
+		PoolJob* jobs = MediaMalloc(&MEDIA_MEMORY, sizeof(PoolJob) * newCapacity);
+
+		if (!jobs)
+		{
+			pthread_mutex_unlock(&deque->lock);
+			TraceLog(LOG_ERROR, "MEDIA: Failed to grow a job deque to %i jobs.", newCapacity);
+			return false;
+		}
+
+		for (int i = 0; i < deque->count; ++i)
+		{
+			jobs[i] = deque->jobs[(deque->head + i) % deque->capacity];
+		}
+
+		MediaFree(deque->jobs);
+
+		deque->jobs = jobs;
+		deque->head = 0;
+		deque->capacity = newCapacity;
+	}
+
+	deque->jobs[(deque->head + deque->count) % deque->capacity] = job;
+	deque->count++;
+
+	pthread_mutex_unlock(&deque->lock);
+
+	return true;
+}
+
+bool PopJobFront(JobDeque* deque, PoolJob* job)
+{
+	bool ret = false;
+
+	pthread_mutex_lock(&deque->lock);
+
+	if (deque->count > 0)
+	{
+		*job = deque->jobs[deque->head];
+		deque->head = (deque->head + 1) % deque->capacity;
+		deque->count--;
+		ret = true;
+	}
+
+	pthread_mutex_unlock(&deque->lock);
+
+	return ret;
+}
+
+bool PopJobBack(JobDeque* deque, PoolJob* job)
+{
+	bool ret = false;
+
+	pthread_mutex_lock(&deque->lock);
+
+	if (deque->count > 0)
+	{
+		deque->count--;
+		*job = deque->jobs[(deque->head + deque->count) % deque->capacity];
+		ret = true;
+	}
+
+	pthread_mutex_unlock(&deque->lock);
+
+	return ret;
+}
+
+bool AcquireWorkerPool(void)
+{
+	bool ret = true;
+
+	pthread_mutex_lock(&POOL.lock);
+
+	if (POOL.threadCount == 0)
+	{
+		const int threadCount = MEDIA.workerThreads > 0 ? MEDIA.workerThreads : CLAMP(av_cpu_count(), 1, MEDIA_POOL_MAX_THREADS);
+
+		POOL.threads = MediaMalloc(&MEDIA_MEMORY, sizeof(pthread_t) * threadCount);
+		// Zeroed: on failure, the deques not loaded yet are skipped by UnloadJobDeque
+		POOL.deques = MediaCalloc(&MEDIA_MEMORY, threadCount, sizeof(JobDeque));
+
+		ret = POOL.threads && POOL.deques && LoadJobDeque(&POOL.global, 16) && LoadJobDeque(&POOL.urgent, 16);
+
+		for (int i = 0; ret && i < threadCount; ++i)
+		{
+			ret = LoadJobDeque(&POOL.deques[i], 16);
+		}
+
+		if (ret)
+		{
+			atomic_store(&POOL.quit, false);
+			atomic_store(&POOL.queuedJobs, 0);
+
+			// Threads are counted as they start, so a failure leaves a smaller but working pool
+			for (int i = 0; i < threadCount; ++i)
+			{
+				if (pthread_create(&POOL.threads[i], NULL, RunPoolThread, (void*)(intptr_t)i) != 0)
+				{
+					TraceLog(LOG_WARNING, "MEDIA: Failed to create worker pool thread #%i.", i);
+					break;
+				}
+
+				POOL.threadCount++;
+			}
+
+			ret = POOL.threadCount > 0;
+
+			if (ret)
+			{
+				TraceLog(LOG_INFO, "MEDIA: Worker pool started with %i threads.", POOL.threadCount);
+			}
+		}
+
+		if (!ret)
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Failed to start the worker pool.");
+
+			if (POOL.deques)
+			{
+				for (int i = 0; i < threadCount; ++i)
+				{
+					UnloadJobDeque(&POOL.deques[i]);
+				}
+			}
+
+			UnloadJobDeque(&POOL.global);
+			UnloadJobDeque(&POOL.urgent);
+
+			MediaFree(POOL.threads);
+			MediaFree(POOL.deques);
+
+			POOL.threads = NULL;
+			POOL.deques = NULL;
+		}
+	}
+
+	if (ret)
+	{
+		POOL.users++;
+	}
+
+	pthread_mutex_unlock(&POOL.lock);
+
+	return ret;
+}
+
+void ReleaseWorkerPool(void)
+{
+	pthread_mutex_lock(&POOL.lock);
+
+	assert(POOL.users > 0);
+
+	if (--POOL.users == 0)
+	{
+		atomic_store(&POOL.quit, true);
+
+		pthread_mutex_lock(&POOL.sleepLock);
+		pthread_cond_broadcast(&POOL.wakeUp);
+		pthread_mutex_unlock(&POOL.sleepLock);
+
+		for (int i = 0; i < POOL.threadCount; ++i)
+		{
+			pthread_join(POOL.threads[i], NULL);
+			UnloadJobDeque(&POOL.deques[i]);
+		}
+
+		UnloadJobDeque(&POOL.global);
+		UnloadJobDeque(&POOL.urgent);
+
+		MediaFree(POOL.threads);
+		MediaFree(POOL.deques);
+
+		POOL.threads = NULL;
+		POOL.deques = NULL;
+		POOL.threadCount = 0;
+	}
+
+	pthread_mutex_unlock(&POOL.lock);
+}
+
+bool SubmitPoolJob(PoolJob job)
+{
+	// Jobs submitted by a pool thread stay on its own deque, others go through the global one
+	JobDeque* deque = POOL_THREAD_INDEX >= 0 ? &POOL.deques[POOL_THREAD_INDEX] : &POOL.global;
+
+	if (!PushJobBack(deque, job))
+	{
+		return false;
+	}
+
+	SignalPoolJob();
+
+	return true;
+}
+
+bool SubmitUrgentPoolJob(PoolJob job)
+{
+	if (!PushJobBack(&POOL.urgent, job))
+	{
+		return false;
+	}
+
+	SignalPoolJob();
+
+	return true;
+}
+
+void SignalPoolJob(void)
+{
+	atomic_fetch_add(&POOL.queuedJobs, 1);
+
+	// Signaling under the lock guarantees a thread about to sleep sees either the new count or the signal
+	pthread_mutex_lock(&POOL.sleepLock);
+	pthread_cond_signal(&POOL.wakeUp);
+	pthread_mutex_unlock(&POOL.sleepLock);
+}
+
+bool TakePoolJob(PoolJob* job)
+{
+	const int self = POOL_THREAD_INDEX;
+
+	assert(self >= 0);
+
+	if (TakeUrgentPoolJob(job))
+	{
+		return true;
+	}
+
+	bool ret = PopJobFront(&POOL.deques[self], job) || PopJobFront(&POOL.global, job);
+
+	// Steal from the other threads, starting from the next one to spread the thefts
+	for (int i = 1; !ret && i < POOL.threadCount; ++i)
+	{
+		ret = PopJobBack(&POOL.deques[(self + i) % POOL.threadCount], job);
+	}
+
+	if (ret)
+	{
+		atomic_fetch_sub(&POOL.queuedJobs, 1);
+	}
+
+	return ret;
+}
+
+bool TakeUrgentPoolJob(PoolJob* job)
+{
+	const bool ret = PopJobFront(&POOL.urgent, job);
+
+	if (ret)
+	{
+		atomic_fetch_sub(&POOL.queuedJobs, 1);
+	}
+
+	return ret;
+}
+
+void* RunPoolThread(void* index)
+{
+	POOL_THREAD_INDEX = (int)(intptr_t)index;
+	WORKER_THREAD = true;
+
+	while (!atomic_load(&POOL.quit))
+	{
+		PoolJob job;
+
+		if (TakePoolJob(&job))
+		{
+			job.run(job.arg);
+			continue;
+		}
+
+		pthread_mutex_lock(&POOL.sleepLock);
+
+		while (atomic_load(&POOL.queuedJobs) <= 0 && !atomic_load(&POOL.quit))
+		{
+			pthread_cond_wait(&POOL.wakeUp, &POOL.sleepLock);
+		}
+
+		pthread_mutex_unlock(&POOL.sleepLock);
+	}
+
+	return NULL;
+}
+
+void SetJobStatus(atomic_int* status, int value)
+{
+	// Stored under jobsLock: a waiter can't miss the signal, nor free the status before it's sent
+	pthread_mutex_lock(&POOL.jobsLock);
+
+	atomic_store(status, value);
+	pthread_cond_broadcast(&POOL.jobsDone);
+
+	pthread_mutex_unlock(&POOL.jobsLock);
+}
+
+void WaitJobStatus(atomic_int* status, int pendingValue)
+{
+	pthread_mutex_lock(&POOL.jobsLock);
+
+	while (atomic_load(status) == pendingValue)
+	{
+		pthread_cond_wait(&POOL.jobsDone, &POOL.jobsLock);
+	}
+
+	pthread_mutex_unlock(&POOL.jobsLock);
+}
+
+
+#if defined(_MSC_VER)
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - Win32 threads (MSVC)
+//---------------------------------------------------------------------------------------------------
+
+// Start routine and argument of a thread, freed by the thread itself
+typedef struct Win32ThreadStart
+{
+	void* (*start)(void*);
+	void* arg;
+} Win32ThreadStart;
+
+int MediaThreadCreate(pthread_t* thread, const void* attr, void* (*start)(void*), void* arg)
+{
+	Win32ThreadStart* startInfo = RL_MALLOC(sizeof(Win32ThreadStart));
+
+	if (!startInfo)
+	{
+		return ENOMEM;
+	}
+
+	*startInfo = (Win32ThreadStart){ start, arg };
+
+	*thread = (HANDLE)_beginthreadex(NULL, 0, RunWin32Thread, startInfo, 0, NULL);
+
+	if (!*thread)
+	{
+		RL_FREE(startInfo);
+		return EAGAIN;
+	}
+
+	return 0;
+}
+
+unsigned __stdcall RunWin32Thread(void* arg)
+{
+	Win32ThreadStart startInfo = *(Win32ThreadStart*)arg;
+
+	RL_FREE(arg);
+
+	startInfo.start(startInfo.arg);
+
+	return 0;
+}
+
+int MediaThreadJoin(pthread_t thread, void** value)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+
+	return 0;
+}
+
+int MediaMutexInit(pthread_mutex_t* mutex, const void* attr)
+{
+	InitializeSRWLock(mutex);
+	return 0;
+}
+
+int MediaMutexDestroy(pthread_mutex_t* mutex)
+{
+	return 0; // Slim reader/writer locks hold no resources
+}
+
+int MediaMutexLock(pthread_mutex_t* mutex)
+{
+	AcquireSRWLockExclusive(mutex);
+	return 0;
+}
+
+int MediaMutexUnlock(pthread_mutex_t* mutex)
+{
+	ReleaseSRWLockExclusive(mutex);
+	return 0;
+}
+
+int MediaCondInit(pthread_cond_t* cond, const void* attr)
+{
+	InitializeConditionVariable(cond);
+	return 0;
+}
+
+int MediaCondDestroy(pthread_cond_t* cond)
+{
+	return 0; // Condition variables hold no resources
+}
+
+int MediaCondWait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+	return SleepConditionVariableSRW(cond, mutex, INFINITE, 0) ? 0 : EINVAL;
+}
+
+int MediaCondSignal(pthread_cond_t* cond)
+{
+	WakeConditionVariable(cond);
+	return 0;
+}
+
+int MediaCondBroadcast(pthread_cond_t* cond)
+{
+	WakeAllConditionVariable(cond);
+	return 0;
+}
+
+int MediaCallOnce(pthread_once_t* once, void (*init)(void))
+{
+	return InitOnceExecuteOnce(once, RunWin32Once, (PVOID)init, NULL) ? 0 : EINVAL;
+}
+
+BOOL CALLBACK RunWin32Once(PINIT_ONCE once, PVOID init, PVOID* context)
+{
+	((void (*)(void))init)();
+	return TRUE;
+}
+
+int MediaThreadYield(void)
+{
+	SwitchToThread();
+	return 0;
+}
+#endif
+
+
+//---------------------------------------------------------------------------------------------------
+// Functions Definition - YUV to RGB conversion kernels
+//---------------------------------------------------------------------------------------------------
+
+YUVRowKernel GetYUVRowKernel(enum AVPixelFormat format)
+{
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+
+	pthread_once(&once, InitYUVRowKernels);
+
+	switch (format)
+	{
+	case AV_PIX_FMT_YUV420P:
+	case AV_PIX_FMT_YUVJ420P:
+		return YUV_KERNELS.i420;
+	case AV_PIX_FMT_NV12:
+		return YUV_KERNELS.nv12;
+	default:
+		return NULL;
+	}
+}
+
+void InitYUVRowKernels(void)
+{
+	const int cpuFlags = av_get_cpu_flags();
+
+	YUV_KERNELS = (YUVRowKernels){ ConvertI420RowScalar, ConvertNV12RowScalar, "scalar" };
+
+#if defined(MEDIA_SIMD_X86)
+	if (cpuFlags & AV_CPU_FLAG_AVX2)
+	{
+		YUV_KERNELS = (YUVRowKernels){ ConvertI420RowAVX2, ConvertNV12RowAVX2, "AVX2" };
+	}
+	else if (cpuFlags & AV_CPU_FLAG_SSE2)
+	{
+		YUV_KERNELS = (YUVRowKernels){ ConvertI420RowSSE2, ConvertNV12RowSSE2, "SSE2" };
+	}
+#elif defined(MEDIA_SIMD_NEON)
+	if (cpuFlags & AV_CPU_FLAG_NEON)
+	{
+		YUV_KERNELS = (YUVRowKernels){ ConvertI420RowNEON, ConvertNV12RowNEON, "NEON" };
+	}
+#else
+	(void)cpuFlags;
+#endif
+
+	TraceLog(LOG_INFO, "MEDIA: YUV to RGB conversion kernels: %s", YUV_KERNELS.name);
+}
+
+const YUVCoefficients* GetYUVCoefficients(const AVCodecContext* codecCtx)
+{
+	int matrix = 0;
+
+	switch (codecCtx->colorspace)
+	{
+	case AVCOL_SPC_BT709:
+		matrix = 1;
+		break;
+	case AVCOL_SPC_BT470BG:
+	case AVCOL_SPC_SMPTE170M:
+	case AVCOL_SPC_UNSPECIFIED:
+		matrix = 0;
+		break;
+	default:
+		return NULL;
+	}
+
+	const bool fullRange = (codecCtx->pix_fmt == AV_PIX_FMT_YUVJ420P) || (codecCtx->color_range == AVCOL_RANGE_JPEG);
+
+	return &YUV_COEFFICIENTS[matrix][fullRange ? 1 : 0];
+}
+
+void AVSetSwsColorspace(struct SwsContext* swsContext, const AVCodecContext* codecCtx)
+{
+	const int colorspace = (codecCtx->colorspace == AVCOL_SPC_BT709) ? SWS_CS_ITU709 : SWS_CS_DEFAULT;
+	const int srcRange = (codecCtx->pix_fmt == AV_PIX_FMT_YUVJ420P) || (codecCtx->color_range == AVCOL_RANGE_JPEG);
+
+	// Brightness 0, contrast and saturation 1 (16.16 fixed point); RGB output is full range.
+	// Fails for RGB or gray sources, which have no matrix: the defaults stay.
+	sws_setColorspaceDetails(swsContext, sws_getCoefficients(colorspace), srcRange, sws_getCoefficients(SWS_CS_DEFAULT), 1, 0, 1 << 16, 1 << 16);
+}
+
+void ConvertYUVRows(YUVRowKernel kernel, const YUVCoefficients* coef, const AVFrame* frame, uint8_t* dst, int dstLineSize, int width, int pixelSize, int rowStart, int rowEnd)
+{
+	for (int row = rowStart; row < rowEnd; ++row)
+	{
+		// Both formats have one chroma row every two rows (4:2:0)
+		const int chromaRow = row >> 1;
+
+		kernel(frame->data[0] + (ptrdiff_t)row * frame->linesize[0],
+			   frame->data[1] + (ptrdiff_t)chromaRow * frame->linesize[1],
+			   frame->data[2] ? frame->data[2] + (ptrdiff_t)chromaRow * frame->linesize[2] : NULL,
+			   dst + (ptrdiff_t)row * dstLineSize,
+			   width, pixelSize, coef);
+	}
+}
+
+// Reference conversion of a single pixel, shared by the scalar kernels and the tails of the SIMD ones
+static inline void ConvertYUVPixel(int y, int u, int v, uint8_t* dst, int pixelSize, const YUVCoefficients* coef)
+{
+	const int luma = (y - coef->yOffset) * coef->y + YUV_ROUND;
+
+	u -= 128;
+	v -= 128;
+
+	dst[0] = (uint8_t)CLAMP((luma + coef->vr * v) >> YUV_SHIFT, 0, 255);
+	dst[1] = (uint8_t)CLAMP((luma - coef->ug * u - coef->vg * v) >> YUV_SHIFT, 0, 255);
+	dst[2] = (uint8_t)CLAMP((luma + coef->ub * u) >> YUV_SHIFT, 0, 255);
+
+	if (pixelSize == 4)
+	{
+		dst[3] = 255;
+	}
+}
+
+void ConvertI420RowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	for (int x = 0; x < width; ++x)
+	{
+		ConvertYUVPixel(y[x], u[x >> 1], v[x >> 1], dst + pixelSize * x, pixelSize, coef);
+	}
+}
+
+void ConvertNV12RowScalar(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	(void)unused;
+
+	for (int x = 0; x < width; ++x)
+	{
+		ConvertYUVPixel(y[x], uv[x & ~1], uv[x | 1], dst + pixelSize * x, pixelSize, coef);
+	}
+}
+
+#if defined(MEDIA_SIMD_X86)
+
+// Converts 8 pixels: y, u and v hold signed 16-bit values already offset by -yOffset / -128.
+// Results are left as 16-bit values, saturated to [0, 255] once packed.
+MEDIA_TARGET("sse2") static inline void ConvertYUV8SSE2(__m128i y, __m128i u, __m128i v, const YUVCoefficients* coef, __m128i* r, __m128i* g, __m128i* b)
+{
+	const __m128i luma = _mm_adds_epi16(_mm_mullo_epi16(y, _mm_set1_epi16(coef->y)), _mm_set1_epi16(YUV_ROUND));
 
-	do
+	*r = _mm_srai_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(v, _mm_set1_epi16(coef->vr))), YUV_SHIFT);
+	*g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(luma, _mm_mullo_epi16(u, _mm_set1_epi16(coef->ug))),
+									   _mm_mullo_epi16(v, _mm_set1_epi16(coef->vg))), YUV_SHIFT);
+	*b = _mm_srai_epi16(_mm_adds_epi16(luma, _mm_mullo_epi16(u, _mm_set1_epi16(coef->ub))), YUV_SHIFT);
+}
+
+// Interleaves 16 R, G and B bytes into 64 bytes of opaque RGBA32
+MEDIA_TARGET("sse2") static inline void StoreRGBA32SSE2(uint8_t* dst, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i a = _mm_set1_epi8(-1);
+
+	const __m128i rgLow = _mm_unpacklo_epi8(r, g);
+	const __m128i rgHigh = _mm_unpackhi_epi8(r, g);
+	const __m128i baLow = _mm_unpacklo_epi8(b, a);
+	const __m128i baHigh = _mm_unpackhi_epi8(b, a);
+
+	_mm_storeu_si128((__m128i*)(dst + 0), _mm_unpacklo_epi16(rgLow, baLow));
+	_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(rgLow, baLow));
+	_mm_storeu_si128((__m128i*)(dst + 32), _mm_unpacklo_epi16(rgHigh, baHigh));
+	_mm_storeu_si128((__m128i*)(dst + 48), _mm_unpackhi_epi16(rgHigh, baHigh));
+}
+
+// Converts 16 pixels whose chroma samples are given as 8 unsigned bytes (low half of u8 and v8)
+MEDIA_TARGET("sse2") static inline void ConvertYUV16SSE2(const uint8_t* y, __m128i u8, __m128i v8, uint8_t* dst, int pixelSize, const YUVCoefficients* coef)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i y8 = _mm_loadu_si128((const __m128i*)y);
+
+	// Each chroma sample is shared by two horizontal pixels
+	const __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(u8, zero), _mm_set1_epi16(128));
+	const __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(v8, zero), _mm_set1_epi16(128));
+
+	const __m128i ylo = _mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), _mm_set1_epi16(coef->yOffset));
+	const __m128i yhi = _mm_sub_epi16(_mm_unpackhi_epi8(y8, zero), _mm_set1_epi16(coef->yOffset));
+
+	__m128i rlo, glo, blo, rhi, ghi, bhi;
+
+	ConvertYUV8SSE2(ylo, _mm_unpacklo_epi16(u16, u16), _mm_unpacklo_epi16(v16, v16), coef, &rlo, &glo, &blo);
+	ConvertYUV8SSE2(yhi, _mm_unpackhi_epi16(u16, u16), _mm_unpackhi_epi16(v16, v16), coef, &rhi, &ghi, &bhi);
+
+	const __m128i r = _mm_packus_epi16(rlo, rhi);
+	const __m128i g = _mm_packus_epi16(glo, ghi);
+	const __m128i b = _mm_packus_epi16(blo, bhi);
+
+	if (pixelSize == 4)
 	{
-		if(IsBufferFull(&ctx->audioOutputBuffer.state))
-		{
-			TraceLog(LOG_WARNING, "MEDIA: Not enough space for decoding in the audio buffer.");
-			ret = MEDIA_ERR_OVERFLOW;
-			break;
-		}
-		
-		const int writableSegmentSizeBytes = GetBufferWritableSegmentSize(&ctx->audioOutputBuffer.state);
+		StoreRGBA32SSE2(dst, r, g, b);
+		return;
+	}
 
-		// Determine the number of bytes per audio frame, based on sample size and channel count.
-		const int bytesPerFrame = (int)((media->audioStream.sampleSize / 8) * media->audioStream.channels);
+	// SSE2 has no byte shuffle: the planar result is interleaved through the stack
+	uint8_t planes[3][16];
 
-		// Calculate the writable segment size in terms of audio samples.
-		const int writableSegmentSizeSamples = writableSegmentSizeBytes / bytesPerFrame;
+	_mm_storeu_si128((__m128i*)planes[0], r);
+	_mm_storeu_si128((__m128i*)planes[1], g);
+	_mm_storeu_si128((__m128i*)planes[2], b);
 
-		uint8_t* outputBuffer = &ctx->audioOutputBuffer.data[ctx->audioOutputBuffer.state.writePos];
+	for (int i = 0; i < 16; ++i)
+	{
+		dst[3 * i + 0] = planes[0][i];
+		dst[3 * i + 1] = planes[1][i];
+		dst[3 * i + 2] = planes[2][i];
+	}
+}
 
-		// Convert and store the incoming audio samples into the output buffer.
-		// This will fill up to the writable segment size in samples, using the provided input data.
-		const int convertedSamples = swr_convert(ctx->swrContext,
-		                                         &outputBuffer,
-		                                         writableSegmentSizeSamples,
-		                                         inData,
-			 									 inSamples);
+MEDIA_TARGET("sse2") void ConvertI420RowSSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	int x = 0;
 
-		if(convertedSamples < 0)
-		{
-			AVPrintError(convertedSamples);
-			ret = MEDIA_ERR_DECODE_AUDIO;
-			break; 
-		}
+	for (; x + 16 <= width; x += 16)
+	{
+		ConvertYUV16SSE2(y + x, _mm_loadl_epi64((const __m128i*)(u + x / 2)), _mm_loadl_epi64((const __m128i*)(v + x / 2)), dst + pixelSize * x, pixelSize, coef);
+	}
 
-		// Calculate the size in bytes of the converted samples just written to the buffer.
-		const int convertedSamplesBytes = av_samples_get_buffer_size(
-			NULL,
-			(int)media->audioStream.channels,
-			convertedSamples,
-			ctx->audioOutputFmt,
-			1
-		);
+	ConvertI420RowScalar(y + x, u + x / 2, v + x / 2, dst + pixelSize * x, width - x, pixelSize, coef);
+}
 
-		AdvanceWritePosN(&ctx->audioOutputBuffer.state, convertedSamplesBytes);
+MEDIA_TARGET("sse2") void ConvertNV12RowSSE2(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	int x = 0;
 
-		leftSamples -= convertedSamples;
+	for (; x + 16 <= width; x += 16)
+	{
+		// Split the 8 interleaved chroma pairs: u in the low byte of each 16-bit lane, v in the high one
+		const __m128i uv8 = _mm_loadu_si128((const __m128i*)(uv + x));
+		const __m128i u8 = _mm_packus_epi16(_mm_and_si128(uv8, _mm_set1_epi16(0xFF)), _mm_setzero_si128());
+		const __m128i v8 = _mm_packus_epi16(_mm_srli_epi16(uv8, 8), _mm_setzero_si128());
 
-		// Setting inData to NULL and inSamples to 0 instructs subsequent swr_convert calls
-		// to process any remaining buffered data
-		inData = NULL;
-		inSamples = 0;
+		ConvertYUV16SSE2(y + x, u8, v8, dst + pixelSize * x, pixelSize, coef);
+	}
 
-	} while (leftSamples > 0);
+	ConvertNV12RowScalar(y + x, uv + x, unused, dst + pixelSize * x, width - x, pixelSize, coef);
+}
 
-	return ret;
+// Interleaves 16 R, G and B bytes into 48 bytes of RGB24
+MEDIA_TARGET("avx2") static inline void StoreRGB24AVX2(uint8_t* dst, __m128i r, __m128i g, __m128i b)
+{
+	const __m128i out0 = _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r, _mm_setr_epi8(0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5)),
+		_mm_shuffle_epi8(g, _mm_setr_epi8(-128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128))),
+		_mm_shuffle_epi8(b, _mm_setr_epi8(-128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128)));
+
+	const __m128i out1 = _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r, _mm_setr_epi8(-128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128)),
+		_mm_shuffle_epi8(g, _mm_setr_epi8(5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10))),
+		_mm_shuffle_epi8(b, _mm_setr_epi8(-128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128)));
+
+	const __m128i out2 = _mm_or_si128(_mm_or_si128(
+		_mm_shuffle_epi8(r, _mm_setr_epi8(-128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128)),
+		_mm_shuffle_epi8(g, _mm_setr_epi8(-128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128))),
+		_mm_shuffle_epi8(b, _mm_setr_epi8(10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15)));
+
+	_mm_storeu_si128((__m128i*)(dst + 0), out0);
+	_mm_storeu_si128((__m128i*)(dst + 16), out1);
+	_mm_storeu_si128((__m128i*)(dst + 32), out2);
 }
 
+// Converts 16 pixels with 16 chroma values already duplicated per pixel pair (unsigned bytes)
+MEDIA_TARGET("avx2") static inline void ConvertYUV16AVX2(const uint8_t* y, __m128i u8, __m128i v8, uint8_t* dst, int pixelSize, const YUVCoefficients* coef)
+{
+	const __m256i y16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)y)), _mm256_set1_epi16(coef->yOffset));
+	const __m256i u16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(u8), _mm256_set1_epi16(128));
+	const __m256i v16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(v8), _mm256_set1_epi16(128));
+
+	const __m256i luma = _mm256_adds_epi16(_mm256_mullo_epi16(y16, _mm256_set1_epi16(coef->y)), _mm256_set1_epi16(YUV_ROUND));
+
+	const __m256i r = _mm256_srai_epi16(_mm256_adds_epi16(luma, _mm256_mullo_epi16(v16, _mm256_set1_epi16(coef->vr))), YUV_SHIFT);
+	const __m256i g = _mm256_srai_epi16(_mm256_subs_epi16(_mm256_subs_epi16(luma, _mm256_mullo_epi16(u16, _mm256_set1_epi16(coef->ug))),
+														  _mm256_mullo_epi16(v16, _mm256_set1_epi16(coef->vg))), YUV_SHIFT);
+	const __m256i b = _mm256_srai_epi16(_mm256_adds_epi16(luma, _mm256_mullo_epi16(u16, _mm256_set1_epi16(coef->ub))), YUV_SHIFT);
+
+	// Narrow each channel back to 16 bytes (packus works per 128-bit lane, so pack the two halves explicitly)
+	const __m128i r8 = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+	const __m128i g8 = _mm_packus_epi16(_mm256_castsi256_si128(g), _mm256_extracti128_si256(g, 1));
+	const __m128i b8 = _mm_packus_epi16(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+
+	if (pixelSize == 4)
+	{
+		StoreRGBA32SSE2(dst, r8, g8, b8);
+	}
+	else
+	{
+		StoreRGB24AVX2(dst, r8, g8, b8);
+	}
+}
 
-bool AVLoadCodecContext(StreamDataContext* streamCtx, const AVCodec* codec, const AVCodecParameters* params)
+MEDIA_TARGET("avx2") void ConvertI420RowAVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
 {
-	if (streamCtx->codecCtx)
+	int x = 0;
+
+	for (; x + 16 <= width; x += 16)
 	{
-		TraceLog(LOG_WARNING, "MEDIA: Multiple stream of the same type (%i), only the first will be used.", params->codec_type);
+		const __m128i u8 = _mm_loadl_epi64((const __m128i*)(u + x / 2));
+		const __m128i v8 = _mm_loadl_epi64((const __m128i*)(v + x / 2));
 
-		return MEDIA_ERR_DUPLICATE_STREAM;
+		ConvertYUV16AVX2(y + x, _mm_unpacklo_epi8(u8, u8), _mm_unpacklo_epi8(v8, v8), dst + pixelSize * x, pixelSize, coef);
 	}
 
-	streamCtx->startPts = AV_NOPTS_VALUE;
+	ConvertI420RowScalar(y + x, u + x / 2, v + x / 2, dst + pixelSize * x, width - x, pixelSize, coef);
+}
 
-	streamCtx->codecCtx = avcodec_alloc_context3(codec);
+MEDIA_TARGET("avx2") void ConvertNV12RowAVX2(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	int x = 0;
 
-	if (!streamCtx->codecCtx)
+	for (; x + 16 <= width; x += 16)
 	{
-		TraceLog(LOG_WARNING, "MEDIA: Failed to allocate memory for a codec (type %i)", params->codec_type);
+		// Pick and duplicate the u (even bytes) and v (odd bytes) samples
+		const __m128i uv8 = _mm_loadu_si128((const __m128i*)(uv + x));
+		const __m128i u8 = _mm_shuffle_epi8(uv8, _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14));
+		const __m128i v8 = _mm_shuffle_epi8(uv8, _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15));
 
-		return MEDIA_ERR_CODEC_ALLOC_FAILED;
+		ConvertYUV16AVX2(y + x, u8, v8, dst + pixelSize * x, pixelSize, coef);
 	}
 
-	int ret = avcodec_parameters_to_context(streamCtx->codecCtx, params);
+	ConvertNV12RowScalar(y + x, uv + x, unused, dst + pixelSize * x, width - x, pixelSize, coef);
+}
 
-	if (ret < 0)
+#endif // MEDIA_SIMD_X86
+
+#if defined(MEDIA_SIMD_NEON)
+
+// Converts 16 pixels with 8 chroma samples each for u and v, shared by pixel pairs
+static inline void ConvertYUV16NEON(const uint8_t* y, uint8x8_t u8, uint8x8_t v8, uint8_t* dst, int pixelSize, const YUVCoefficients* coef)
+{
+	const uint8x16_t y8 = vld1q_u8(y);
+
+	const uint8x8x2_t u2 = vzip_u8(u8, u8);
+	const uint8x8x2_t v2 = vzip_u8(v8, v8);
+
+	uint8x8_t half[3][2];
+
+	for (int h = 0; h < 2; ++h)
 	{
-		AVPrintError(ret);
+		// Wrapping unsigned subtractions reinterpreted as signed give the offset values
+		const int16x8_t ys = vreinterpretq_s16_u16(vsubl_u8(h ? vget_high_u8(y8) : vget_low_u8(y8), vdup_n_u8((uint8_t)coef->yOffset)));
+		const int16x8_t us = vreinterpretq_s16_u16(vsubl_u8(u2.val[h], vdup_n_u8(128)));
+		const int16x8_t vs = vreinterpretq_s16_u16(vsubl_u8(v2.val[h], vdup_n_u8(128)));
 
-		return MEDIA_ERR_CTX_PARAMS_FAILED;
+		const int16x8_t luma = vaddq_s16(vmulq_n_s16(ys, coef->y), vdupq_n_s16(YUV_ROUND));
+
+		half[0][h] = vqshrun_n_s16(vqaddq_s16(luma, vmulq_n_s16(vs, coef->vr)), YUV_SHIFT);
+		half[1][h] = vqshrun_n_s16(vqsubq_s16(vqsubq_s16(luma, vmulq_n_s16(us, coef->ug)), vmulq_n_s16(vs, coef->vg)), YUV_SHIFT);
+		half[2][h] = vqshrun_n_s16(vqaddq_s16(luma, vmulq_n_s16(us, coef->ub)), YUV_SHIFT);
 	}
 
-	// Initialize the AVCodecContext to use the given AVCodec.
-	ret = avcodec_open2(streamCtx->codecCtx, codec, NULL);
+	const uint8x16_t r = vcombine_u8(half[0][0], half[0][1]);
+	const uint8x16_t g = vcombine_u8(half[1][0], half[1][1]);
+	const uint8x16_t b = vcombine_u8(half[2][0], half[2][1]);
 
-	if (ret < 0)
+	if (pixelSize == 4)
 	{
-		AVPrintError(ret);
+		vst4q_u8(dst, (uint8x16x4_t){ { r, g, b, vdupq_n_u8(255) } });
+	}
+	else
+	{
+		vst3q_u8(dst, (uint8x16x3_t){ { r, g, b } });
+	}
+}
 
-		return MEDIA_ERR_CODEC_OPEN_FAILED;
+void ConvertI420RowNEON(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
+{
+	int x = 0;
+
+	for (; x + 16 <= width; x += 16)
+	{
+		ConvertYUV16NEON(y + x, vld1_u8(u + x / 2), vld1_u8(v + x / 2), dst + pixelSize * x, pixelSize, coef);
 	}
 
-	return MEDIA_RET_SUCCEED;
+	ConvertI420RowScalar(y + x, u + x / 2, v + x / 2, dst + pixelSize * x, width - x, pixelSize, coef);
 }
 
-void AVUnloadCodecContext(StreamDataContext* streamCtx)
+void ConvertNV12RowNEON(const uint8_t* y, const uint8_t* uv, const uint8_t* unused, uint8_t* dst, int width, int pixelSize, const YUVCoefficients* coef)
 {
-	assert(streamCtx->codecCtx);
+	int x = 0;
 
-	avcodec_free_context(&streamCtx->codecCtx);
+	for (; x + 16 <= width; x += 16)
+	{
+		const uint8x8x2_t uv8 = vld2_u8(uv + x);
+
+		ConvertYUV16NEON(y + x, uv8.val[0], uv8.val[1], dst + pixelSize * x, pixelSize, coef);
+	}
+
+	ConvertNV12RowScalar(y + x, uv + x, unused, dst + pixelSize * x, width - x, pixelSize, coef);
 }
 
+#endif // MEDIA_SIMD_NEON
+
 
 //---------------------------------------------------------------------------------------------------
 // Functions Definition - Helpers
@@ -2117,3 +9027,252 @@ bool HasStream(const MediaContext* ctx, int streamType)
 {
 	return ctx->streams[streamType].codecCtx != NULL;
 }
+
+bool LoadVideoTextures(MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+
+	if (!ctx->yuvOutput)
+	{
+		media->videoTexture = LoadTextureFromImage(ctx->videoOutputImage);
+
+		if (!IsTextureValid(media->videoTexture))
+		{
+			return false;
+		}
+
+		SetTextureFilter(media->videoTexture, TEXTURE_FILTER_BILINEAR);
+
+		return true;
+	}
+
+	if (!AcquireYUVShader())
+	{
+		return false;
+	}
+
+	ctx->yuvShaderUser = true;
+
+	uint8_t* planes[4] = { 0 };
+	int lineSizes[4] = { 0 };
+
+	AVGetVideoPlanes(ctx, ctx->videoOutputImage.data, planes, lineSizes);
+
+	// 4:2:0 chroma planes have half the size of the luma plane, rounded up
+	const bool semiPlanar = (ctx->videoOutputFormat == AV_PIX_FMT_NV12);
+	const int chromaWidth = (ctx->videoOutputImage.width + 1) / 2;
+	const int chromaHeight = (ctx->videoOutputImage.height + 1) / 2;
+
+	for (int i = 0; i < (semiPlanar ? 2 : 3); ++i)
+	{
+		Image plane = (Image){ 0 };
+
+		plane.data    = planes[i];
+		plane.width   = (i == 0) ? ctx->videoOutputImage.width : chromaWidth;
+		plane.height  = (i == 0) ? ctx->videoOutputImage.height : chromaHeight;
+		plane.mipmaps = 1;
+		plane.format  = (semiPlanar && i == 1) ? PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA : PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+
+		media->videoPlanes[i] = LoadTextureFromImage(plane);
+
+		if (!IsTextureValid(media->videoPlanes[i]))
+		{
+			TraceLog(LOG_ERROR, "MEDIA: Failed to create the texture of video plane #%i.", i);
+			UnloadVideoTextures(media);
+			return false;
+		}
+
+		SetTextureFilter(media->videoPlanes[i], TEXTURE_FILTER_BILINEAR);
+	}
+
+	return true;
+}
+
+void UnloadVideoTextures(MediaStream* media)
+{
+	if (IsTextureValid(media->videoTexture))
+	{
+		UnloadTexture(media->videoTexture);
+		media->videoTexture = (Texture){ 0 };
+	}
+
+	for (int i = 0; i < 3; ++i)
+	{
+		if (IsTextureValid(media->videoPlanes[i]))
+		{
+			UnloadTexture(media->videoPlanes[i]);
+			media->videoPlanes[i] = (Texture){ 0 };
+		}
+	}
+
+	if (media->ctx->yuvShaderUser)
+	{
+		ReleaseYUVShader();
+		media->ctx->yuvShaderUser = false;
+	}
+}
+
+bool BeginVideoFrameWrite(MediaContext* ctx)
+{
+	// Pairs with AcquireMediaFrame (sequentially consistent): either the borrower's count is seen here,
+	// or the borrower sees frameWriting and waits for EndVideoFrameWrite.
+	atomic_store(&ctx->frameWriting, true);
+
+	if (atomic_load(&ctx->frameBorrowers) > 0)
+	{
+		atomic_store(&ctx->frameWriting, false);
+		return false;
+	}
+
+	return true;
+}
+
+void EndVideoFrameWrite(MediaContext* ctx)
+{
+	ctx->videoFrameSequence++;
+
+	SetJobStatus(&ctx->frameWriting, false);
+}
+
+bool AcquireYUVShader(void)
+{
+	if (YUV_SHADER.users > 0)
+	{
+		YUV_SHADER.users++;
+		return true;
+	}
+
+	const char* header = GetYUVShaderHeader(rlGetVersion());
+
+	if (!header)
+	{
+		TraceLog(LOG_ERROR, "MEDIA: YUV video output requires shader support.");
+		return false;
+	}
+
+	YUV_SHADER.shader = LoadYUVShader(header, NULL);
+
+	if (!IsShaderValid(YUV_SHADER.shader))
+	{
+		TraceLog(LOG_ERROR, "MEDIA: Failed to compile the YUV video shader.");
+		YUV_SHADER = (YUVShader){ 0 };
+		return false;
+	}
+
+	YUV_SHADER.texture1Loc    = GetShaderLocation(YUV_SHADER.shader, "texture1");
+	YUV_SHADER.texture2Loc    = GetShaderLocation(YUV_SHADER.shader, "texture2");
+	YUV_SHADER.semiPlanarLoc  = GetShaderLocation(YUV_SHADER.shader, "semiPlanar");
+	YUV_SHADER.fullRangeLoc   = GetShaderLocation(YUV_SHADER.shader, "fullRange");
+	YUV_SHADER.colorMatrixLoc = GetShaderLocation(YUV_SHADER.shader, "colorMatrix");
+	YUV_SHADER.users = 1;
+
+	return true;
+}
+
+void ReleaseYUVShader(void)
+{
+	assert(YUV_SHADER.users > 0);
+
+	if (--YUV_SHADER.users == 0)
+	{
+		UnloadShader(YUV_SHADER.shader);
+		YUV_SHADER = (YUVShader){ 0 };
+	}
+}
+
+const char* GetYUVShaderHeader(int glVersion)
+{
+	switch (glVersion)
+	{
+	case RL_OPENGL_21:
+		return "#version 120\n#define IN varying\n#define TEXTURE texture2D\n#define FRAG_COLOR gl_FragColor\n";
+	case RL_OPENGL_33:
+	case RL_OPENGL_43:
+		return "#version 330\n#define IN in\n#define TEXTURE texture\n#define FRAG_COLOR finalColor\nout vec4 finalColor;\n";
+	case RL_OPENGL_ES_20:
+		return "#version 100\nprecision mediump float;\n#define IN varying\n#define TEXTURE texture2D\n#define FRAG_COLOR gl_FragColor\n";
+	case RL_OPENGL_ES_30:
+		return "#version 300 es\nprecision mediump float;\n#define IN in\n#define TEXTURE texture\n#define FRAG_COLOR finalColor\nout vec4 finalColor;\n";
+	default:
+		return NULL;
+	}
+}
+
+Shader LoadYUVShader(const char* header, const char* vsCode)
+{
+	// TextFormat() is limited to short strings
+	char code[2048];
+
+	snprintf(code, sizeof(code), "%s%s", header, YUV_SHADER_CODE);
+
+	Shader shader = LoadShaderFromMemory(vsCode, code);
+
+	// raylib falls back to its default shader when compilation fails
+	if (!IsShaderValid(shader) || shader.id == rlGetShaderIdDefault())
+	{
+		return (Shader){ 0 };
+	}
+
+	return shader;
+}
+
+int PresentDecodedFrame(const MediaStream* media)
+{
+	MediaContext* ctx = media->ctx;
+	FrameQueue* frames = &ctx->decodedFrames;
+
+	// Status is loaded before the queue is checked, as the decode worker sets it only after its last frame
+	const int status = atomic_load(&ctx->decodeStatus);
+
+	while (!IsBufferEmpty(&frames->state))
+	{
+		VideoFrame* frame = &frames->frames[frames->state.readPos];
+
+		// It's not yet time to show the frame
+		if (ctx->timePos < frame->time)
+		{
+			return MEDIA_RET_SUCCEED;
+		}
+
+		// The next frame is due as well: this one would never be visible, skip it
+		if (GetBufferReadableSpace(&frames->state) > 1)
+		{
+			const VideoFrame* nextFrame = &frames->frames[(frames->state.readPos + 1) % frames->state.capacity];
+
+			if (ctx->timePos >= nextFrame->time)
+			{
+				AdvanceReadPos(&frames->state);
+				atomic_fetch_add(&ctx->droppedVideoFrames, 1);
+				continue;
+			}
+		}
+
+		// The current frame is borrowed (AcquireMediaFrame), present this one in a later update
+		if (!BeginVideoFrameWrite(ctx))
+		{
+			return MEDIA_RET_SUCCEED;
+		}
+
+		// Swap the frame buffer with the output image instead of copying it;
+		// the previous image buffer is handed back to the decode worker.
+		uint8_t* pixels = frame->data;
+		frame->data = ctx->videoOutputImage.data;
+		ctx->videoOutputImage.data = pixels;
+		ctx->videoFrameTime = frame->time;
+
+		EndVideoFrameWrite(ctx);
+
+		AdvanceReadPos(&frames->state);
+
+		// There is room for a new frame now
+		WakeWorker(&ctx->decodeWorker);
+
+		AVUploadVideoImage(media);
+
+		atomic_fetch_add(&ctx->presentedVideoFrames, 1);
+
+		return MEDIA_RET_SUCCEED;
+	}
+
+	return status;
+}